@@ -0,0 +1,37 @@
+# Uses EGL_ROOT_DIR variable to look up headers
+# and libraries along with standard system paths.
+# Up on finding required files, the following variables
+# will be set
+# EGL_FOUND
+# EGL_INCLUDE_DIR
+# EGL_LIBRARY
+
+FIND_PATH(EGL_INCLUDE_DIR EGL/egl.h
+    HINTS
+    ${EGL_ROOT_DIR}
+    $ENV{EGL_ROOT_DIR}
+    PATH_SUFFIXES include
+    PATHS
+    /usr/include
+    /usr/local/include
+    )
+
+FIND_LIBRARY(EGL_LIBRARY
+    NAMES EGL
+    HINTS
+    ${EGL_ROOT_DIR}
+    $ENV{EGL_ROOT_DIR}
+    PATH_SUFFIXES lib lib64
+    PATHS
+    /usr/lib
+    /usr/lib64
+    /usr/lib/x86_64-linux-gnu
+    /usr/lib/arm-linux-gnueabihf
+    /usr/lib/aarch64-linux-gnu
+    /usr/local/lib
+    /usr/local/lib64
+    )
+
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(EGL REQUIRED_VARS EGL_LIBRARY EGL_INCLUDE_DIR)
+MARK_AS_ADVANCED(EGL_INCLUDE_DIR EGL_LIBRARY)
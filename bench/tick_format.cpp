@@ -0,0 +1,90 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <tickformat.hpp>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* axis ranges the ticks are computed for, an axis is
+ * refreshed whenever its limits change */
+const int NUM_AXES  = 100000;
+const int NUM_TICKS = 10;
+
+using namespace std;
+
+/* label formatting the charts used before formatTick */
+static string toString(float pVal, const int n)
+{
+    ostringstream out;
+    out << fixed << setprecision(n) << pVal;
+    return out.str();
+}
+
+static double elapsedNs(chrono::steady_clock::time_point pStart)
+{
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - pStart).count();
+}
+
+int main(void)
+{
+    vector<double> lows(NUM_AXES), highs(NUM_AXES);
+    for (int i=0; i<NUM_AXES; ++i) {
+        double scale = pow(10.0, (i % 13) - 6);
+        lows[i]  = -scale * (1.0 + (i % 7) * 0.13);
+        highs[i] =  scale * (2.0 + (i % 11) * 0.37);
+    }
+    const int numLabels = NUM_AXES * NUM_TICKS;
+
+    /* evenly spaced ticks with two decimals, labelled
+     * through a string stream as the charts used to */
+    size_t oldChars = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i=0; i<NUM_AXES; ++i) {
+        double step = (highs[i] - lows[i]) / (NUM_TICKS - 1);
+        for (int t=0; t<NUM_TICKS; ++t)
+            oldChars += toString(float(lows[i] + t*step), 2).size();
+    }
+    double oldNs = elapsedNs(start);
+
+    /* ticks at nice values labelled by formatTick */
+    size_t newChars = 0;
+    start = chrono::steady_clock::now();
+    for (int i=0; i<NUM_AXES; ++i) {
+        double step = niceTickStep(lows[i], highs[i], NUM_TICKS);
+        int first   = int(ceil(lows[i] / step - 1.0e-6));
+        TickFormat format = tickFormat(max(fabs(lows[i]), fabs(highs[i])), step);
+        char label[TICK_LABEL_SIZE];
+        for (int t=0; t<NUM_TICKS; ++t)
+            newChars += formatTick(label, (first + t) * step, format);
+    }
+    double newNs = elapsedNs(start);
+
+    /* tick spacing on its own */
+    double stepSum = 0.0;
+    start = chrono::steady_clock::now();
+    for (int i=0; i<NUM_AXES; ++i)
+        stepSum += niceTickStep(lows[i], highs[i], NUM_TICKS);
+    double stepNs = elapsedNs(start);
+
+    cout << fixed << setprecision(1);
+    cout << "ostringstream toString : " << oldNs / numLabels << " ns/label"
+         << " (" << oldChars << " chars)" << endl;
+    cout << "formatTick             : " << newNs / numLabels << " ns/label"
+         << " (" << newChars << " chars, including niceTickStep and tickFormat)" << endl;
+    cout << "niceTickStep           : " << stepNs / NUM_AXES << " ns/axis"
+         << " (checksum " << stepSum << ")" << endl;
+    cout << "speedup                : " << oldNs / newNs << "x" << endl;
+
+    return 0;
+}
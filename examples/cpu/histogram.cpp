@@ -34,7 +34,6 @@ struct Bitmap {
 Bitmap createBitmap(unsigned w, unsigned h);
 void destroyBitmap(Bitmap& bmp);
 void kernel(Bitmap& bmp);
-void hist_freq(Bitmap& bmp, int *hist_array, const unsigned nbins);
 
 float perlinNoise(float x, float y, float z, int tileSize);
 float octavesPerlin(float x, float y, float z, int octaves, float persistence, int tileSize);
@@ -70,7 +69,7 @@ int main(void) {
     /*
      * Create histogram object while specifying desired number of bins
      */
-    fg::Histogram hist(NBINS, fg::u8);
+    fg::Histogram hist(NBINS, fg::s32);
 
     /*
      * Set histogram colors
@@ -85,28 +84,21 @@ int main(void) {
     fg::copy(img, bmp.ptr);
 
     /* set x axis limits to maximum and minimum values of data
-     * and y axis limits to range [0, nBins]*/
+     * and let the y axis follow the largest frequency */
     hist.setAxesLimits(1, 0, 1000, 0);
+    hist.setAutoAxes();
 
-    /* copy your data into the vertex buffer object exposed by
-     * fg::Histogram class and then proceed to rendering.
-     * To help the users with copying the data from compute
-     * memory to display memory, Forge provides copy headers
-     * along with the library to help with this task
-     */
-    int histogram_array[NBINS] = {0};
-    hist_freq(bmp, &histogram_array[0], NBINS);
-    fg::copy(hist, histogram_array);
+    /* bin the red channel of the image into the histogram,
+     * the pixels are binned on the GPU where they already are */
+    hist.fill(img, 0, 255, 0);
 
     do {
         kernel(bmp);
         fg::copy(img, bmp.ptr);
 
-        int histogram_array[NBINS] = {0};
-        hist_freq(bmp, &histogram_array[0], NBINS);
         // limit histogram update frequency
         if(fmod(t,0.4f) < 0.02f)
-            fg::copy(hist, histogram_array);
+            hist.fill(img, 0, 255, 0);
 
         wnd.draw(0, 0, img,  "Dynamic Perlin Noise" );
         wnd.draw(1, 0, hist, "Histogram of Noisy Image");
@@ -148,17 +140,6 @@ void kernel(Bitmap& bmp) {
     tileSize++;
 }
 
-void hist_freq(Bitmap& bmp, int *hist_array, const unsigned nbins){
-    for (unsigned y=0; y<bmp.height; ++y) {
-        for (unsigned x=0; x<bmp.width; ++x) {
-            int offset  = x + y * bmp.width;
-            unsigned char noiseVal = bmp.ptr[offset*4];
-            hist_array[(int)((float)noiseVal/255.f * nbins)]++;
-        }
-    }
-
-}
-
 struct vec3{
     float x;
     float y;
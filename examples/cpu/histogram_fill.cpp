@@ -0,0 +1,124 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <forge.h>
+#include <CPUCopy.hpp>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <iostream>
+
+const unsigned DIMX = 1200;
+const unsigned DIMY = 400;
+const unsigned WIN_ROWS = 1;
+const unsigned WIN_COLS = 4;
+
+const unsigned NBINS = 4;
+
+using namespace std;
+
+/* compares the bins of a histogram with the expected frequencies */
+template<typename T>
+bool checkBins(fg::Histogram& hist, const T* expected, const char* name)
+{
+    vector<T> bins(NBINS);
+    memcpy(bins.data(), hist.map(fg::FG_MAP_READ_WRITE), NBINS*sizeof(T));
+    hist.unmap();
+
+    bool ok = (memcmp(bins.data(), expected, NBINS*sizeof(T)) == 0);
+    cout << (ok ? "PASS " : "FAIL ") << name << ":";
+    for (unsigned i=0; i<NBINS; ++i)
+        cout << " " << double(bins[i]) << "(" << double(expected[i]) << ")";
+    cout << endl;
+    return ok;
+}
+
+int main(void) {
+    /*
+     * First Forge call should be a window creation call
+     * so that necessary OpenGL context is created for any
+     * other fg::* object to be created successfully
+     */
+    fg::Window wnd(DIMX, DIMY, "Histogram Fill Demo");
+    wnd.makeCurrent();
+    fg::Font fnt;
+#ifdef OS_WIN
+    fnt.loadSystemFont("Calibri", 32);
+#else
+    fnt.loadSystemFont("Vera", 32);
+#endif
+    wnd.setFont(&fnt);
+    wnd.grid(WIN_ROWS, WIN_COLS);
+
+    bool ok = true;
+    const float nan = numeric_limits<float>::quiet_NaN();
+
+    /* [0, 4] in bins of width 1: the upper limit falls in the last bin,
+     * samples below the lower limit, above the upper one and NaNs are
+     * not counted */
+    const float floats[] = {0.0f, 0.5f, 1.0f, 2.0f, 3.999f, 4.0f,
+                            -0.001f, 4.001f, nan, -nan};
+    const unsigned floatBins[NBINS] = {2, 1, 1, 2};
+    fg::Histogram floatHist(NBINS, fg::u32);
+    floatHist.setBarColor(fg::FG_YELLOW);
+    floatHist.setAxesLimits(4, 0, 3, 0);
+    floatHist.fill(floats, sizeof(floats)/sizeof(floats[0]), 0, 4);
+    ok &= checkBins(floatHist, floatBins, "float samples");
+
+    /* the same samples as the y values of a plot, binned on the GPU */
+    vector<float> points;
+    for (unsigned i=0; i<sizeof(floats)/sizeof(floats[0]); ++i) {
+        points.push_back(float(i));
+        points.push_back(floats[i]);
+    }
+    fg::Plot plot(unsigned(points.size()/2), fg::f32);
+    fg::copy(plot, points.data());
+    fg::Histogram plotHist(NBINS, fg::u32);
+    plotHist.setBarColor(fg::FG_GREEN);
+    plotHist.setAxesLimits(4, 0, 3, 0);
+    plotHist.fill(plot, 0, 4);
+    ok &= checkBins(plotHist, floatBins, "plot samples");
+
+    /* integers are binned by value, the extremes of the type
+     * lie outside of the range */
+    const int ints[] = {-2, -1, 0, 1, 2, -3, 3, INT_MIN, INT_MAX};
+    const int intBins[NBINS] = {1, 1, 1, 2};
+    fg::Histogram intHist(NBINS, fg::s32);
+    intHist.setBarColor(fg::FG_BLUE);
+    intHist.setAxesLimits(2, -2, 3, 0);
+    intHist.fill(ints, sizeof(ints)/sizeof(ints[0]), -2, 2);
+    ok &= checkBins(intHist, intBins, "int samples");
+
+    /* bytes over their whole range, the first bin gets more
+     * samples than an u8 histogram can count and is clamped */
+    vector<unsigned char> bytes(300, 0);
+    const unsigned char edges[] = {63, 64, 127, 128, 191, 192, 255};
+    bytes.insert(bytes.end(), edges, edges + sizeof(edges));
+    const unsigned char byteBins[NBINS] = {255, 2, 2, 2};
+    fg::Histogram byteHist(NBINS, fg::u8);
+    byteHist.setBarColor(fg::FG_RED);
+    byteHist.setAxesLimits(255, 0, 255, 0);
+    byteHist.fill(bytes.data(), bytes.size(), 0, 255);
+    ok &= checkBins(byteHist, byteBins, "u8 samples");
+
+    cout << (ok ? "All bins match" : "Some bins differ") << endl;
+
+    do {
+        wnd.draw(0, 0, floatHist, "float samples");
+        wnd.draw(1, 0, plotHist,  "plot samples");
+        wnd.draw(2, 0, intHist,   "int samples");
+        wnd.draw(3, 0, byteHist,  "u8 samples");
+        // draw window and poll for events last
+        wnd.swapBuffers();
+    } while(!wnd.close());
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <forge.h>
+#include <cmath>
+#include <vector>
+
+const unsigned DIMX = 1000;
+const unsigned DIMY = 800;
+
+/* number of most recent samples on display and
+ * number of samples acquired per frame */
+const unsigned WINDOW_SAMPLES = 10000;
+const unsigned FRAME_SAMPLES  = 170;
+
+const float SAMPLE_INTERVAL = 1e-4f;
+
+using namespace std;
+
+int main(void){
+    /*
+     * First Forge call should be a window creation call
+     * so that necessary OpenGL context is created for any
+     * other fg::* object to be created successfully
+     */
+    fg::Window wnd(DIMX, DIMY, "Streaming Plot Demo");
+    wnd.makeCurrent();
+    /* create an font object and load necessary font
+     * and later pass it on to window object so that
+     * it can be used for rendering text */
+    fg::Font fnt;
+#ifdef OS_WIN
+    fnt.loadSystemFont("Calibri", 32);
+#else
+    fnt.loadSystemFont("Vera", 32);
+#endif
+    wnd.setFont(&fnt);
+
+    /* the plot keeps the last WINDOW_SAMPLES samples on the GPU,
+     * its X-Axis follows the time stamps of the samples */
+    fg::StreamPlot plt(WINDOW_SAMPLES, fg::f32);
+    plt.setColor(fg::FG_YELLOW);
+    plt.setAxesLimits(1.f, 0.f, 1.5f, -1.5f);
+    plt.setAxesTitles("Time", "Signal");
+
+    std::vector<float> samples(2*FRAME_SAMPLES);
+    unsigned long long t = 0;
+
+    do {
+        /* only the new samples are uploaded each frame */
+        for (unsigned i=0; i<FRAME_SAMPLES; ++i, ++t) {
+            float time = t * SAMPLE_INTERVAL;
+            samples[2*i+0] = time;
+            samples[2*i+1] = sinf(2.f*3.1415926f*time) + 0.25f*sinf(2.f*3.1415926f*50.f*time);
+        }
+        plt.append(&samples[0], FRAME_SAMPLES);
+
+        wnd.draw(plt);
+    } while(!wnd.close());
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <forge.h>
+#include <vector>
+
+const unsigned DIMX = 20000;
+const unsigned DIMY = 12000;
+const unsigned BAND = 500;
+
+int main(void)
+{
+    /*
+     * First Forge call should be a window creation call
+     * so that necessary OpenGL context is created for any
+     * other fg::* object to be created successfully
+     */
+    fg::Window wnd(1024, 768, "Tiled Image Demo");
+    wnd.makeCurrent();
+
+    /* a TiledImage may exceed the largest texture size, it is
+     * stored in tiles and drawn from a copy scaled to the window */
+    fg::TiledImage img(DIMX, DIMY, fg::FG_GRAYSCALE, fg::u8);
+
+    /* load the image in horizontal bands so that
+     * the whole image never has to be in host memory */
+    std::vector<unsigned char> band(DIMX * BAND);
+    for (unsigned y0=0; y0<DIMY; y0+=BAND) {
+        for (unsigned y=0; y<BAND; ++y) {
+            for (unsigned x=0; x<DIMX; ++x) {
+                unsigned gy = y0 + y;
+                band[y * DIMX + x] = (unsigned char)(((x / 250 + gy / 250) % 2) ? 224 : 32);
+            }
+        }
+        img.update(band.data(), 0, y0, DIMX, BAND);
+    }
+
+    do {
+        wnd.draw(img);
+    } while(!wnd.close());
+
+    return 0;
+}
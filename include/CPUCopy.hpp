@@ -16,26 +16,45 @@ namespace fg
 template<typename T>
 void copy(fg::Image& out, const T * dataPtr)
 {
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, out.pbo());
-    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, out.size(), dataPtr);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    out.upload(dataPtr);
+}
+
+/*
+ * Copies a width x height block of tightly packed pixels to the
+ * region of the image whose top left corner is at (x, y)
+ */
+template<typename T>
+void copy(fg::Image& out, const T * dataPtr,
+          unsigned x, unsigned y, unsigned width, unsigned height)
+{
+    out.update(dataPtr, x, y, width, height);
 }
 
 /*
  * Below functions takes any renderable forge object that has following member functions
  * defined
  *
- * `unsigned Renderable::vbo() const;`
- * `unsigned Renderable::size() const;`
+ * `void Renderable::upload(const void* pData);`
  *
- * Currently fg::Plot, fg::Histogram objects in Forge library fit the bill
+ * Currently fg::Plot, fg::Plot3, fg::Surface, fg::Histogram objects in Forge library fit the bill.
+ * The upload goes through the renderable so that streaming buffers and
+ * automatic axes limits (computed from the host copy) are taken care of
  */
 template<class Renderable, typename T>
 void copy(Renderable& out, const T * dataPtr)
 {
-    glBindBuffer(GL_ARRAY_BUFFER, out.vbo());
-    glBufferSubData(GL_ARRAY_BUFFER, 0, out.size(), dataPtr);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    out.upload(dataPtr);
+}
+
+/*
+ * Copies count elements from dataPtr to the renderable's data starting
+ * at element offset. Requires `void Renderable::update(const void*,
+ * unsigned, unsigned);` in addition to the functions listed above
+ */
+template<class Renderable, typename T>
+void copy(Renderable& out, const T * dataPtr, unsigned offset, unsigned count)
+{
+    out.update(dataPtr, unsigned(offset*sizeof(T)), unsigned(count*sizeof(T)));
 }
 
 }
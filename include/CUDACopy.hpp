@@ -40,6 +40,7 @@ void copy(fg::Image& out, const T * devicePtr)
     CUDA_ERROR_CHECK(cudaMemcpy(pboDevicePtr, devicePtr, num_bytes, cudaMemcpyDeviceToDevice));
     CUDA_ERROR_CHECK(cudaGraphicsUnmapResources(1, &cudaPBOResource, 0));
     CUDA_ERROR_CHECK(cudaGraphicsUnregisterResource(cudaPBOResource));
+    out.pboWritten();
 }
 
 /*
@@ -48,8 +49,9 @@ void copy(fg::Image& out, const T * devicePtr)
  *
  * `unsigned Renderable::vbo() const;`
  * `unsigned Renderable::size() const;`
+ * `void Renderable::vboWritten();`
  *
- * Currently fg::Plot, fg::Histogram objects in Forge library fit the bill
+ * Currently fg::Plot, fg::Plot3, fg::Surface, fg::Histogram objects in Forge library fit the bill
  */
 template<class Renderable, typename T>
 void copy(Renderable& out, const T * devicePtr)
@@ -65,6 +67,7 @@ void copy(Renderable& out, const T * devicePtr)
     CUDA_ERROR_CHECK(cudaMemcpy(vboDevicePtr, devicePtr, num_bytes, cudaMemcpyDeviceToDevice));
     CUDA_ERROR_CHECK(cudaGraphicsUnmapResources(1, &cudaVBOResource, 0));
     CUDA_ERROR_CHECK(cudaGraphicsUnregisterResource(cudaVBOResource));
+    out.vboWritten();
 }
 
 }
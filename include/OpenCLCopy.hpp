@@ -25,6 +25,7 @@ static void copy(fg::Image& out, const cl::Buffer& in, const cl::CommandQueue& q
     queue.enqueueCopyBuffer(in, pboMapBuffer, 0, 0, out.size(), NULL, NULL);
     queue.finish();
     queue.enqueueReleaseGLObjects(&shared_objects);
+    out.pboWritten();
 }
 
 /*
@@ -33,8 +34,9 @@ static void copy(fg::Image& out, const cl::Buffer& in, const cl::CommandQueue& q
  *
  * `unsigned Renderable::vbo() const;`
  * `unsigned Renderable::size() const;`
+ * `void Renderable::vboWritten();`
  *
- * Currently fg::Plot, fg::Histogram objects in Forge library fit the bill
+ * Currently fg::Plot, fg::Plot3, fg::Surface, fg::Histogram objects in Forge library fit the bill
  */
 template<class Renderable>
 void copy(Renderable& out, const cl::Buffer& in, const cl::CommandQueue& queue)
@@ -49,6 +51,7 @@ void copy(Renderable& out, const cl::Buffer& in, const cl::CommandQueue& queue)
     queue.enqueueCopyBuffer(in, vboMapBuffer, 0, 0, out.size(), NULL, NULL);
     queue.finish();
     queue.enqueueReleaseGLObjects(&shared_objects);
+    out.vboWritten();
 }
 
 }
@@ -144,6 +144,30 @@ enum PlotType {
     FG_SURFACE      = 2
 };
 
+enum VideoFormat {
+    FG_VIDEO_Y4M    = 0,                    ///< YUV4MPEG2 stream, 4:2:0 full range BT.601
+    FG_VIDEO_RGBA   = 1                     ///< Headerless RGBA frames, 8 bits per channel
+};
+
+/**
+   Access to the data buffer of an object mapped to host memory
+
+   The map functions of \ref Plot, \ref Plot3, \ref Surface,
+   \ref Histogram and \ref Image return a pointer to all of the data of
+   the object, which is written to the buffer by unmap, so a producer can
+   fill the data without a staging copy. With FG_MAP_WRITE the previous
+   contents are undefined and all of the data has to be written, in
+   return the mapping doesn't wait for pending draws of the previous
+   data. FG_MAP_READ_WRITE keeps the contents but waits for the GPU.
+
+   The pointer is invalid after unmap. While an object is mapped, drawing,
+   resizing or updating it throws an fg::Error.
+ */
+enum MapAccess {
+    FG_MAP_WRITE      = 0,              ///< Write only, previous contents are undefined
+    FG_MAP_READ_WRITE = 1               ///< Previous contents are kept and can be read
+};
+
 enum MarkerType {
     FG_NONE         = 0,
     FG_POINT        = 1,
@@ -10,6 +10,9 @@
 #pragma once
 
 #include <fg/defines.h>
+#include <fg/image.h>
+#include <fg/plot.h>
+#include <cstddef>
 
 namespace internal
 {
@@ -77,6 +80,16 @@ class Histogram {
          */
         FGAPI void setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin);
 
+        /**
+           Set the Y-Axis limits from the data whenever it changes
+
+           The Y-Axis spans from zero to the largest frequency of the bins
+           that are drawn, the X-Axis limits stay as set by \ref setAxesLimits.
+
+           \param[in] pAuto turns automatic limits on or off
+         */
+        FGAPI void setAutoAxes(bool pAuto=true);
+
         /**
            Set axes titles in histogram(bar chart)
 
@@ -85,6 +98,109 @@ class Histogram {
          */
         FGAPI void setAxesTitles(const char* pXTitle, const char* pYTitle);
 
+        /**
+           Change the number of bins of the histogram
+
+           The Vertex Buffer Object only grows, by at least doubling its
+           capacity, so repeated growth takes amortized constant time and
+           shrinking never reallocates. Data of the first bins is kept,
+           new bins are undefined until written. The draw count is reset
+           to the new number of bins. Growing may replace the buffer
+           returned by \ref vbo, which needs to be registered again with
+           CUDA or OpenCL interop afterwards.
+
+           \param[in] pNBins is the new number of bins
+         */
+        FGAPI void resize(unsigned pNBins);
+
+        /**
+           Draw only the first pCount bins
+
+           The drawn bins span the whole width of the histogram.
+
+           \param[in] pCount is the number of bins to draw, it is clamped
+                      to the number of bins of the histogram
+         */
+        FGAPI void setDrawCount(unsigned pCount);
+
+        /**
+           Bin samples and upload their frequencies
+
+           The range [pLow, pHigh] is split into bins of equal width, the
+           last bin includes pHigh. Samples outside the range and NaNs
+           are not counted. Counts larger than the histogram data type can
+           hold are clamped to its largest value. Large inputs are binned
+           on multiple threads.
+
+           \param[in] pSamples is the array of samples
+           \param[in] pCount is the number of samples
+           \param[in] pLow is the lower end of the first bin
+           \param[in] pHigh is the upper end of the last bin, it has to be
+                      greater than pLow
+         */
+        FGAPI void fill(const float* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           \copydoc fill(const float*, size_t, float, float)
+         */
+        FGAPI void fill(const int* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           \copydoc fill(const float*, size_t, float, float)
+         */
+        FGAPI void fill(const unsigned* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           \copydoc fill(const float*, size_t, float, float)
+         */
+        FGAPI void fill(const short* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           \copydoc fill(const float*, size_t, float, float)
+         */
+        FGAPI void fill(const unsigned short* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           \copydoc fill(const float*, size_t, float, float)
+         */
+        FGAPI void fill(const signed char* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           \copydoc fill(const float*, size_t, float, float)
+         */
+        FGAPI void fill(const unsigned char* pSamples, size_t pCount, float pLow, float pHigh);
+
+        /**
+           Bin a channel of the pixels of an image on the GPU
+
+           The pixel buffer of the image is binned as
+           \ref fill(const float*, size_t, float, float) bins samples, in
+           single precision, and the frequencies are written to the histogram
+           buffer without passing through host memory. Uses compute shaders
+           where OpenGL 4.3 is available, and draws the samples with additive
+           blending otherwise, which counts up to 2^24 samples per bin
+           exactly.
+
+           \param[in] pImage is the image whose pixels are binned
+           \param[in] pLow is the lower end of the first bin
+           \param[in] pHigh is the upper end of the last bin, it has to be
+                      greater than pLow
+           \param[in] pChannel is the channel of the pixels that is binned
+         */
+        FGAPI void fill(const Image& pImage, float pLow, float pHigh, unsigned pChannel=0);
+
+        /**
+           Bin the y values of the points of a plot on the GPU
+
+           \note see \ref fill(const Image&, float, float, unsigned)
+
+           \param[in] pPlot is the plot whose drawn points are binned
+           \param[in] pLow is the lower end of the first bin
+           \param[in] pHigh is the upper end of the last bin, it has to be
+                      greater than pLow
+         */
+        FGAPI void fill(const Plot& pPlot, float pLow, float pHigh);
+
         /**
            Get X-Axis maximum value
 
@@ -127,6 +243,87 @@ class Histogram {
          */
         FGAPI unsigned size() const;
 
+        /**
+           Mark the histogram as modified
+
+           Windows skip redrawing when none of the objects they display have
+           changed since the last frame. Data written to the Vertex Buffer
+           Object (\ref vbo) has to be announced by \ref vboWritten instead.
+         */
+        FGAPI void markDirty();
+
+        /**
+           Mark the data as written to the Vertex Buffer Object
+
+           To be called after all of \ref vbo was written by CUDA or OpenCL
+           interop or OpenGL calls, as the copy helpers in CUDACopy.hpp and
+           OpenCLCopy.hpp do. Pending \ref update calls are dropped, in
+           streaming mode the data is copied to the streamed buffer, and the
+           histogram is marked as modified.
+         */
+        FGAPI void vboWritten();
+
+        /**
+           Enable or disable streaming of data updates
+
+           Streaming is meant for objects whose data is uploaded from host
+           memory every frame. The data is kept in several buffer regions
+           so that \ref upload writes a region the GPU is not reading and
+           doesn't wait for the draws of earlier frames to finish. While
+           streaming is enabled, data written to the Vertex Buffer Object
+           (\ref vbo) is displayed once \ref vboWritten is called, disabling
+           streaming copies the latest uploaded data back to it.
+
+           \param[in] pStreaming enables streaming when true
+         */
+        FGAPI void setStreaming(bool pStreaming);
+
+        /**
+           Check whether data updates of the histogram are streamed
+
+           \return true if streaming was enabled by \ref setStreaming
+         */
+        FGAPI bool streaming() const;
+
+        /**
+           Upload new data from host memory
+
+           Copies \ref size bytes from pData and marks the histogram as modified.
+
+           \param[in] pData is the host memory to copy from
+         */
+        FGAPI void upload(const void* pData);
+
+        /**
+           Update part of the data from host memory
+
+           Updates are written before the histogram is drawn next, updates
+           made in between draws that overlap or touch each other are
+           merged into a single buffer write.
+
+           \param[in] pData is the host memory to copy from
+           \param[in] pOffset is the byte offset in the data to update
+           \param[in] pSize is the number of bytes to copy
+         */
+        FGAPI void update(const void* pData, unsigned pOffset, unsigned pSize);
+
+        /**
+           Map the Vertex Buffer Object for writing from host memory
+
+           Returns a pointer to \ref size bytes that are written to the
+           buffer by \ref unmap. See \ref MapAccess for the access modes
+           and what the histogram can't be used for while it is mapped.
+
+           \param[in] pAccess is the kind of access to the data
+           \return pointer to the mapped data
+         */
+        FGAPI void* map(MapAccess pAccess=FG_MAP_WRITE);
+
+        /**
+           Unmap the Vertex Buffer Object and mark the histogram as modified
+         */
+        FGAPI void unmap();
+
         /**
            Get the handle to internal implementation of Histogram
          */
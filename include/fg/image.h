@@ -78,6 +78,10 @@ class Image {
         /**
            Get the OpenGL Pixel Buffer Object identifier
 
+           The image alternates between two PBOs for data uploaded with
+           \ref upload or mapped with FG_MAP_WRITE, so the identifier
+           changes after those calls.
+
            \return OpenGL PBO resource id.
          */
         FGAPI unsigned pbo() const;
@@ -89,6 +93,95 @@ class Image {
          */
         FGAPI unsigned size() const;
 
+        /**
+           Mark the image as modified
+
+           Windows skip redrawing when none of the objects they display have
+           changed since the last frame. Data written to the Pixel Buffer
+           Object (\ref pbo) has to be announced by \ref pboWritten instead.
+         */
+        FGAPI void markDirty();
+
+        /**
+           Mark the pixels as written to the Pixel Buffer Object
+
+           To be called after all of \ref pbo was written by CUDA or OpenCL
+           interop or OpenGL calls, as the copy helpers in CUDACopy.hpp and
+           OpenCLCopy.hpp do. Pending \ref update calls are dropped and the
+           whole texture is loaded from the buffer before the next draw.
+         */
+        FGAPI void pboWritten();
+
+        /**
+           Upload new pixel data from host memory
+
+           Copies \ref size bytes from pData to the Pixel Buffer Object and
+           marks the image as modified.
+
+           \param[in] pData is the host memory to copy from
+         */
+        FGAPI void upload(const void* pData);
+
+        /**
+           Update a region of the image from host memory
+
+           Updates are written before the image is drawn next. Only the
+           bounding box of the regions updated since the last draw is
+           loaded into the texture.
+
+           \param[in] pData holds pWidth x pHeight tightly packed pixels
+           \param[in] pX is the column of the left edge of the region
+           \param[in] pY is the row of the top edge of the region
+           \param[in] pWidth is the width of the region in pixels
+           \param[in] pHeight is the height of the region in pixels
+         */
+        FGAPI void update(const void* pData, unsigned pX, unsigned pY,
+                          unsigned pWidth, unsigned pHeight);
+
+        /**
+           Map the Pixel Buffer Object for writing from host memory
+
+           Returns a pointer to \ref size bytes that are written to the
+           buffer by \ref unmap. See \ref MapAccess for the access modes
+           and what the image can't be used for while it is mapped.
+
+           \param[in] pAccess is the kind of access to the data
+           \return pointer to the mapped data
+         */
+        FGAPI void* map(MapAccess pAccess=FG_MAP_WRITE);
+
+        /**
+           Unmap the Pixel Buffer Object and mark the image as modified
+         */
+        FGAPI void unmap();
+
+        /**
+           Set the range of pixel values that spans the colormap
+
+           Values are given in units of the image data type, values outside
+           the range are clamped to it. Data of any type can be uploaded
+           as is, the range is applied when the image is drawn. The default
+           range covers the values of normalized data, [0, 1] for float
+           images and [0, maximum of the type] for integral ones. Turns
+           off the automatic range.
+
+           \param[in] pMin is the value mapped to the start of the colormap
+           \param[in] pMax is the value mapped to the end of the colormap
+         */
+        FGAPI void setDataRange(float pMin, float pMax);
+
+        /**
+           Fit the range of pixel values that spans the colormap to the data
+
+           When enabled, the minimum and maximum of the color channels are
+           computed on the GPU every time new data is drawn and used in
+           place of the range given to \ref setDataRange. The values are not
+           read back, so this doesn't wait for the GPU.
+
+           \param[in] pAuto enables the automatic range when true
+         */
+        FGAPI void setAutoDataRange(bool pAuto=true);
+
         /**
            Get the handle to internal implementation of Image
          */
@@ -0,0 +1,161 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <fg/defines.h>
+
+namespace internal
+{
+class _StreamPlot;
+}
+
+namespace fg
+{
+
+/**
+   \class StreamPlot
+
+   \brief Line graph of the most recent samples of a time series.
+
+   The plot keeps up to a fixed number of samples in a ring buffer on the
+   GPU. Appending samples overwrites the oldest ones and uploads only the
+   appended samples. The X-Axis follows the data, it spans from the oldest
+   to the newest sample displayed.
+ */
+class StreamPlot {
+    private:
+        internal::_StreamPlot* value;
+
+    public:
+        /**
+           Creates a StreamPlot object
+
+           \param[in] pCapacity is the number of most recent samples to display
+           \param[in] pDataType takes one of the values of \ref dtype that indicates
+                      the integral data type of plot data
+         */
+        FGAPI StreamPlot(unsigned pCapacity, dtype pDataType, fg::PlotType=fg::FG_LINE, fg::MarkerType=fg::FG_NONE);
+
+        /**
+           Copy constructor for StreamPlot
+
+           \param[in] other is the StreamPlot of which we make a copy of.
+         */
+        FGAPI StreamPlot(const StreamPlot& other);
+
+        /**
+           StreamPlot Destructor
+         */
+        FGAPI ~StreamPlot();
+
+        /**
+           Set the color of line graph(plot)
+
+           \param[in] col takes values of fg::Color to define plot color
+        */
+        FGAPI void setColor(fg::Color col);
+
+        /**
+           Set the color of line graph(plot)
+
+           \param[in] pRed is Red component in range [0, 1]
+           \param[in] pGreen is Green component in range [0, 1]
+           \param[in] pBlue is Blue component in range [0, 1]
+         */
+        FGAPI void setColor(float pRed, float pGreen, float pBlue);
+
+        /**
+           Set the chart axes limits
+
+           The X-Axis limits are replaced by the range of the
+           samples displayed once samples are appended.
+
+           \param[in] pXmax is X-Axis maximum value
+           \param[in] pXmin is X-Axis minimum value
+           \param[in] pYmax is Y-Axis maximum value
+           \param[in] pYmin is Y-Axis minimum value
+         */
+        FGAPI void setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin);
+
+        /**
+           Set axes titles of the plot
+
+           \param[in] pXTitle is X-Axis title
+           \param[in] pYTitle is Y-Axis title
+         */
+        FGAPI void setAxesTitles(const char* pXTitle, const char* pYTitle);
+
+        /**
+           Get X-Axis maximum value
+
+           \return Maximum value along X-Axis
+         */
+        FGAPI float xmax() const;
+
+        /**
+           Get X-Axis minimum value
+
+           \return Minimum value along X-Axis
+         */
+        FGAPI float xmin() const;
+
+        /**
+           Get Y-Axis maximum value
+
+           \return Maximum value along Y-Axis
+         */
+        FGAPI float ymax() const;
+
+        /**
+           Get Y-Axis minimum value
+
+           \return Minimum value along Y-Axis
+         */
+        FGAPI float ymin() const;
+
+        /**
+           Append samples to the time series
+
+           Samples are (x, y) pairs of the data type of the plot, x is
+           expected to increase from one sample to the next. When more
+           than \ref capacity samples are appended at once, only the
+           newest ones are kept.
+
+           \param[in] pData is the host memory holding the samples
+           \param[in] pCount is the number of samples in pData
+         */
+        FGAPI void append(const void* pData, unsigned pCount);
+
+        /**
+           Remove all samples
+         */
+        FGAPI void clear();
+
+        /**
+           Get the number of most recent samples the plot displays
+
+           \return capacity of the plot in samples
+         */
+        FGAPI unsigned capacity() const;
+
+        /**
+           Get the number of samples currently displayed
+
+           \return number of samples, at most \ref capacity
+         */
+        FGAPI unsigned count() const;
+
+        /**
+           Get the handle to internal implementation of StreamPlot
+         */
+        FGAPI internal::_StreamPlot* get() const;
+};
+
+}
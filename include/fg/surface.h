@@ -77,6 +77,19 @@ class Surface {
          */
         FGAPI void setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin, float pZmax, float pZmin);
 
+        /**
+           Set the chart axes limits from the data whenever it changes
+
+           The limits are the smallest and largest x, y and z of the points.
+           Data copied from host memory is reduced as it is copied, on
+           multiple threads for large data. Data written otherwise is
+           reduced on the GPU at the next draw, and the limits follow a
+           frame or so later, once the result has been read back.
+
+           \param[in] pAuto turns automatic limits on or off
+         */
+        FGAPI void setAutoAxes(bool pAuto=true);
+
         /**
            Set axes titles
 
@@ -86,6 +99,38 @@ class Surface {
          */
         FGAPI void setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle);
 
+        /**
+           Change the grid size of the surface
+
+           The Vertex Buffer Object only grows, by at least doubling its
+           capacity, so repeated growth takes amortized constant time and
+           shrinking never reallocates. The data is kept as a flat array of
+           points, it needs to be written again for the new grid. Growing may
+           replace the buffer returned by \ref vbo, which needs to be
+           registered again with CUDA or OpenCL interop afterwards.
+
+           \param[in] pNumXPoints is the new number of points along X-Axis
+           \param[in] pNumYPoints is the new number of points along Y-Axis
+         */
+        FGAPI void resize(unsigned pNumXPoints, unsigned pNumYPoints);
+
+        /**
+           Draw the points as a density map instead of markers
+
+           Every point adds one to the pixel it is projected on in a float
+           target of the size of the viewport. The counts are then mapped
+           through the colormap of the window, from one to the largest
+           count, and pixels without points are left empty.
+
+           Scatter surfaces (fg::FG_SCATTER) are drawn as density maps even
+           without a marker type, other surfaces keep their faces and draw
+           the density map in place of their markers.
+
+           \param[in] pEnable turns density map rendering on or off
+           \param[in] pLogScale maps the logarithm of the counts
+         */
+        FGAPI void setDensityMap(bool pEnable=true, bool pLogScale=false);
+
         /**
            Get X-Axis maximum value
 
@@ -142,6 +187,87 @@ class Surface {
          */
         FGAPI unsigned size() const;
 
+        /**
+           Mark the surface as modified
+
+           Windows skip redrawing when none of the objects they display have
+           changed since the last frame. Data written to the Vertex Buffer
+           Object (\ref vbo) has to be announced by \ref vboWritten instead.
+         */
+        FGAPI void markDirty();
+
+        /**
+           Mark the data as written to the Vertex Buffer Object
+
+           To be called after all of \ref vbo was written by CUDA or OpenCL
+           interop or OpenGL calls, as the copy helpers in CUDACopy.hpp and
+           OpenCLCopy.hpp do. Pending \ref update calls are dropped, in
+           streaming mode the data is copied to the streamed buffer, and the
+           surface is marked as modified.
+         */
+        FGAPI void vboWritten();
+
+        /**
+           Enable or disable streaming of data updates
+
+           Streaming is meant for objects whose data is uploaded from host
+           memory every frame. The data is kept in several buffer regions
+           so that \ref upload writes a region the GPU is not reading and
+           doesn't wait for the draws of earlier frames to finish. While
+           streaming is enabled, data written to the Vertex Buffer Object
+           (\ref vbo) is displayed once \ref vboWritten is called, disabling
+           streaming copies the latest uploaded data back to it.
+
+           \param[in] pStreaming enables streaming when true
+         */
+        FGAPI void setStreaming(bool pStreaming);
+
+        /**
+           Check whether data updates of the surface are streamed
+
+           \return true if streaming was enabled by \ref setStreaming
+         */
+        FGAPI bool streaming() const;
+
+        /**
+           Upload new data from host memory
+
+           Copies \ref size bytes from pData and marks the surface as modified.
+
+           \param[in] pData is the host memory to copy from
+         */
+        FGAPI void upload(const void* pData);
+
+        /**
+           Update part of the data from host memory
+
+           Updates are written before the surface is drawn next, updates
+           made in between draws that overlap or touch each other are
+           merged into a single buffer write.
+
+           \param[in] pData is the host memory to copy from
+           \param[in] pOffset is the byte offset in the data to update
+           \param[in] pSize is the number of bytes to copy
+         */
+        FGAPI void update(const void* pData, unsigned pOffset, unsigned pSize);
+
+        /**
+           Map the Vertex Buffer Object for writing from host memory
+
+           Returns a pointer to \ref size bytes that are written to the
+           buffer by \ref unmap. See \ref MapAccess for the access modes
+           and what the surface can't be used for while it is mapped.
+
+           \param[in] pAccess is the kind of access to the data
+           \return pointer to the mapped data
+         */
+        FGAPI void* map(MapAccess pAccess=FG_MAP_WRITE);
+
+        /**
+           Unmap the Vertex Buffer Object and mark the surface as modified
+         */
+        FGAPI void unmap();
+
         /**
            Get the handle to internal implementation of _Surface
          */
@@ -0,0 +1,122 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <fg/defines.h>
+
+namespace internal
+{
+class _TiledImage;
+}
+
+namespace fg
+{
+
+/**
+   \class TiledImage
+
+   \brief Image that may be larger than the largest texture OpenGL supports.
+
+   The image is split into square tiles, along with successively halved
+   copies of it that are computed on the GPU. Draws use the copy closest
+   to the displayed size, so drawing a very large image costs about as
+   much as drawing one of the size of the window. Tiles are allocated
+   when data is written to them.
+
+   Unlike \ref Image, data is always loaded from host memory, pixel
+   buffer interop isn't supported. There is no data range either, the
+   colormap spans channel values from zero to one. Integer data is
+   normalized by the range of its type, so unsigned types cover the
+   whole colormap while negative values of signed types are clamped to
+   zero. Floating point data has to be scaled to [0, 1] by the caller.
+ */
+class TiledImage {
+    private:
+        internal::_TiledImage* value;
+
+    public:
+        /**
+           Creates a TiledImage object
+
+           \param[in] pWidth Width of the image
+           \param[in] pHeight Height of the image
+           \param[in] pFormat Color channel format of image, uses one of the values
+                      of \ref ChannelFormat
+           \param[in] pDataType takes one of the values of \ref dtype that indicates
+                      the integral data type of image data
+         */
+        FGAPI TiledImage(unsigned pWidth, unsigned pHeight, ChannelFormat pFormat, dtype pDataType);
+
+        /**
+           Copy constructor of TiledImage
+
+           \param[in] other is the TiledImage of which we make a copy of.
+         */
+        FGAPI TiledImage(const TiledImage& other);
+
+        /**
+           TiledImage Destructor
+         */
+        FGAPI ~TiledImage();
+
+        /**
+           Get Image width
+           \return image width
+         */
+        FGAPI unsigned width() const;
+
+        /**
+           Get Image height
+           \return image height
+         */
+        FGAPI unsigned height() const;
+
+        /**
+           Get Image's channel format
+           \return \ref ChannelFormat value of Image
+         */
+        FGAPI ChannelFormat pixelFormat() const;
+
+        /**
+           Get Image's pixel data type
+           \return \ref dtype value of Image
+         */
+        FGAPI fg::dtype channelType() const;
+
+        /**
+           Replace the image data
+
+           \param[in] pData is the host memory holding width()*height() pixels,
+                      row by row
+         */
+        FGAPI void upload(const void* pData);
+
+        /**
+           Replace the data of a region of the image
+
+           Only the tiles the region overlaps are written.
+
+           \param[in] pData is the host memory holding pWidth*pHeight pixels,
+                      row by row
+           \param[in] pX is the column of the first pixel of the region
+           \param[in] pY is the row of the first pixel of the region
+           \param[in] pWidth is the number of columns of the region
+           \param[in] pHeight is the number of rows of the region
+         */
+        FGAPI void update(const void* pData, unsigned pX, unsigned pY,
+                          unsigned pWidth, unsigned pHeight);
+
+        /**
+           Get the handle to internal implementation of TiledImage
+         */
+        FGAPI internal::_TiledImage* get() const;
+};
+
+}
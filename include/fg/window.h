@@ -12,7 +12,9 @@
 #include <fg/defines.h>
 #include <fg/font.h>
 #include <fg/image.h>
+#include <fg/tiledimage.h>
 #include <fg/plot.h>
+#include <fg/streamplot.h>
 #include <fg/plot3.h>
 #include <fg/surface.h>
 #include <fg/histogram.h>
@@ -101,6 +103,30 @@ class Window {
          */
         FGAPI void setColorMap(ColorMap cmap);
 
+        /**
+           Set a colormap added by \ref addColorMap to be used for subsequent
+           rendering calls
+
+           \param[in] pMap is the identifier returned by \ref addColorMap
+         */
+        FGAPI void setColorMap(unsigned pMap);
+
+        /**
+           Add a colormap to the ones available to the window
+
+           Colors are interpolated linearly, values at the start of the data
+           range get the first color and values at the end the last one.
+           Windows that share their context with this window share the
+           colormap as well.
+
+           \param[in] pRGBA is the host memory holding the colors, four floats
+                      in range [0, 1] per color
+           \param[in] pLength is the number of colors, up to the texture size
+                      limit of the OpenGL implementation
+           \return identifier of the colormap, to be passed to \ref setColorMap
+         */
+        FGAPI unsigned addColorMap(const float* pRGBA, unsigned pLength);
+
         /**
            Get OpenGL context handle
            \return Context handle for the window's OpenGL context
@@ -163,6 +189,17 @@ class Window {
          */
         FGAPI void draw(const Image& pImage, const bool pKeepAspectRatio=true);
 
+        /**
+           Render a TiledImage to Window
+
+           \param[in] pImage is an object of class TiledImage
+
+           \note this draw call does a OpenGL swap buffer, so we do not need
+           to call Window::draw() after this function is called upon for rendering
+           an image
+         */
+        FGAPI void draw(const TiledImage& pImage, const bool pKeepAspectRatio=true);
+
         /**
            Render a Plot to Window
 
@@ -174,6 +211,16 @@ class Window {
          */
         FGAPI void draw(const Plot& pPlot);
 
+        /**
+           Render a StreamPlot to Window
+
+           \param[in] pPlot is an object of class StreamPlot
+
+           \note this draw call does a OpenGL swap buffer, so we do not need
+           to call Window::draw() after this function is called upon for rendering
+         */
+        FGAPI void draw(const StreamPlot& pPlot);
+
         /**
            Render a Plot3 to Window
 
@@ -231,11 +278,32 @@ class Window {
 
            \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
            knowledge of which sub-regions already got rendered. We should call
-           Window::draw() once all draw calls corresponding to all sub-regions are called
-           when in multiview mode.
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
          */
         FGAPI void draw(int pColId, int pRowId, const Image& pImage, const char* pTitle=0, const bool pKeepAspectRatio=true);
 
+        /**
+           Render TiledImage to given sub-region of the window in multiview mode
+
+           Window::grid should have been already called before any of the draw calls
+           that accept coloum index and row index is used to render an object.
+
+           \param[in] pColId is coloumn index
+           \param[in] pRowId is row index
+           \param[in] pImage is an object of class TiledImage
+           \param[in] pTitle is the title that will be displayed for the cell represented
+                      by \p pColId and \p pRowId
+
+           \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
+           knowledge of which sub-regions already got rendered. We should call
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
+         */
+        FGAPI void draw(int pColId, int pRowId, const TiledImage& pImage, const char* pTitle=0, const bool pKeepAspectRatio=true);
+
         /**
            Render Plot to given sub-region of the window in multiview mode
 
@@ -250,11 +318,32 @@ class Window {
 
            \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
            knowledge of which sub-regions already got rendered. We should call
-           Window::draw() once all draw calls corresponding to all sub-regions are called
-           when in multiview mode.
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
          */
         FGAPI void draw(int pColId, int pRowId, const Plot& pPlot, const char* pTitle = 0);
 
+        /**
+           Render StreamPlot to given sub-region of the window in multiview mode
+
+           Window::grid should have been already called before any of the draw calls
+           that accept coloum index and row index is used to render an object.
+
+           \param[in] pColId is coloumn index
+           \param[in] pRowId is row index
+           \param[in] pPlot is an object of class StreamPlot
+           \param[in] pTitle is the title that will be displayed for the cell represented
+                      by \p pColId and \p pRowId
+
+           \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
+           knowledge of which sub-regions already got rendered. We should call
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
+         */
+        FGAPI void draw(int pColId, int pRowId, const StreamPlot& pPlot, const char* pTitle = 0);
+
 
         /**
            Render Plot3 to given sub-region of the window in multiview mode
@@ -270,8 +359,9 @@ class Window {
 
            \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
            knowledge of which sub-regions already got rendered. We should call
-           Window::draw() once all draw calls corresponding to all sub-regions are called
-           when in multiview mode.
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
          */
         FGAPI void draw(int pColId, int pRowId, const Plot3& pPlot3, const char* pTitle = 0);
 
@@ -289,8 +379,9 @@ class Window {
 
            \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
            knowledge of which sub-regions already got rendered. We should call
-           Window::draw() once all draw calls corresponding to all sub-regions are called
-           when in multiview mode.
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
          */
         FGAPI void draw(int pColId, int pRowId, const Surface& pSurface, const char* pTitle = 0);
 
@@ -308,8 +399,9 @@ class Window {
 
            \note This draw call doesn't do OpenGL swap buffer since it doesn't have the
            knowledge of which sub-regions already got rendered. We should call
-           Window::draw() once all draw calls corresponding to all sub-regions are called
-           when in multiview mode.
+           Window::swapBuffers() once all draw calls corresponding to all sub-regions are
+           called when in multiview mode. This call only records the object and
+           its cell, the object is rendered when Window::swapBuffers() is called.
          */
         FGAPI void draw(int pColId, int pRowId, const Histogram& pHist, const char* pTitle = 0);
 
@@ -318,8 +410,142 @@ class Window {
 
            This draw call should only be used when the window is displaying
            something in multiview mode
+
+           Renders all cells requested since the last call in the order they were
+           requested, then swaps the buffers.
+
+           \note Rendering and the buffer swap are skipped if the cells requested
+           since the last call show the same objects, titles and colormaps as the
+           frame on screen and none of those objects changed. The call then waits
+           for window events for up to one frame interval instead. The same applies
+           to the single object draw calls.
          */
         FGAPI void swapBuffers();
+
+        /**
+           Enable asynchronous capture of rendered frames
+
+           Once enabled, every buffer swap (Window::draw or Window::swapBuffers)
+           queues a read of the framebuffer into a ring of \p pRingSize pixel
+           buffers. The transfers complete in the background and are fetched
+           later using Window::captureAsync.
+
+           \param[in] pRingSize is the number of frames that can be in flight
+                      at once, minimum is two.
+         */
+        FGAPI void enableCapture(unsigned pRingSize=3);
+
+        /**
+           Fetch the oldest captured frame without blocking
+
+           With a ring of N buffers, the frame returned is the one rendered N-1
+           swaps ago, by which time its transfer has usually completed. Frames
+           that are not fetched before the ring wraps around are dropped. Capture
+           is enabled with default ring size if it wasn't already.
+
+           \param[out] pData is the destination for RGBA, 8 bits per channel pixels
+                       in top to bottom row order. It should be at least
+                       width*height*4 bytes in size. If \p pData is null, only
+                       the dimensions of the pending frame are reported and the
+                       frame is not consumed.
+           \param[out] pWidth is the width of the captured frame
+           \param[out] pHeight is the height of the captured frame
+
+           \return true if a frame was ready, false otherwise
+         */
+        FGAPI bool captureAsync(unsigned char* pData, int* pWidth, int* pHeight);
+
+        /**
+           Stream every rendered frame to a file descriptor
+
+           Frames are taken from the capture ring (see Window::enableCapture),
+           converted and written on a background thread. Rendering blocks only
+           when the writer falls several frames behind, no frames are dropped.
+           While a sink is attached, Window::captureAsync returns no frames.
+
+           \param[in] pFd is an open file descriptor, typically a pipe to an
+                      encoder process. It is not closed by the window. Pass
+                      a negative value to detach the current sink.
+           \param[in] pFormat is the stream format, one of \ref VideoFormat
+           \param[in] pFrameRate is the frame rate written to the Y4M header
+
+           \note the stream dimensions are those of the first frame, frames
+           of a resized window are cropped or padded to fit.
+         */
+        FGAPI void setVideoSink(int pFd, VideoFormat pFormat=FG_VIDEO_Y4M, int pFrameRate=30);
+
+        /**
+           Start a thread that uploads data of renderables in the background
+
+           The thread owns a hidden context that shares objects with this
+           window. It takes jobs queued by Window::uploadAsync and copies
+           their data into buffers, which are handed to rendering with
+           fences, so neither the producer nor the upload thread waits for
+           buffer swaps or vsync. Must be called on the thread that created
+           the window, calling it again has no effect.
+
+           \param[in] pQueueLength is the number of uploads that can be queued
+         */
+        FGAPI void enableUploadThread(unsigned pQueueLength=64);
+
+        /**
+           Queue an upload of new data for a plot
+
+           Can be called from any thread and never blocks. The upload
+           replaces all of the plot data, \ref Plot::size bytes, and is
+           shown by the first draw after it completes.
+
+           \param[in] pPlot is the plot to update
+           \param[in] pData is the host memory to copy from. It is read by the
+                      upload thread and has to stay valid and unchanged until
+                      Window::pendingUploads no longer counts the upload.
+
+           \return false if the queue is full, the upload is then dropped
+         */
+        FGAPI bool uploadAsync(const Plot& pPlot, const void* pData);
+
+        /**
+           Queue an upload of new data for a 3d plot
+
+           \param[in] pPlot3 is the plot to update
+           \param[in] pData is the host memory to copy from
+
+           \return false if the queue is full
+
+           \note see Window::uploadAsync(const Plot&, const void*)
+         */
+        FGAPI bool uploadAsync(const Plot3& pPlot3, const void* pData);
+
+        /**
+           Queue an upload of new data for a surface
+
+           \param[in] pSurface is the surface to update
+           \param[in] pData is the host memory to copy from
+
+           \return false if the queue is full
+
+           \note see Window::uploadAsync(const Plot&, const void*)
+         */
+        FGAPI bool uploadAsync(const Surface& pSurface, const void* pData);
+
+        /**
+           Queue an upload of new data for a histogram
+
+           \param[in] pHist is the histogram to update
+           \param[in] pData is the host memory to copy from
+
+           \return false if the queue is full
+
+           \note see Window::uploadAsync(const Plot&, const void*)
+         */
+        FGAPI bool uploadAsync(const Histogram& pHist, const void* pData);
+
+        /**
+           Get the number of uploads that are queued or in progress
+
+           Can be called from any thread.
+         */
+        FGAPI unsigned pendingUploads() const;
 };
 
 }
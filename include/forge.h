@@ -14,8 +14,10 @@
 #include "fg/window.h"
 #include "fg/font.h"
 #include "fg/image.h"
+#include "fg/tiledimage.h"
 #include "fg/version.h"
 #include "fg/plot.h"
+#include "fg/streamplot.h"
 #include "fg/plot3.h"
 #include "fg/surface.h"
 #include "fg/histogram.h"
@@ -0,0 +1,653 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <binning.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FG_BINNING_AVX __attribute__((target("avx")))
+static bool haveAVX() { return __builtin_cpu_supports("avx"); }
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define FG_BINNING_AVX
+static bool haveAVX() { return true; }
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FG_BINNING_NEON
+#endif
+
+/* inputs are split between threads in ranges of at least this many samples */
+static const size_t MIN_SAMPLES_PER_THREAD = 1 << 18;
+
+namespace
+{
+
+/* Maps samples to bins, samples that are not counted go to the extra bin
+ * mNBins. Float samples are binned in float arithmetic, the same way the
+ * vector paths do it, all other types in double so that 32 bit integers
+ * are binned exactly */
+struct Binner {
+    float    mLow;
+    float    mHigh;
+    float    mScale;
+    double   mScaleD;
+    unsigned mNBins;
+
+    Binner(float pLow, float pHigh, unsigned pNBins)
+        : mLow(pLow), mHigh(pHigh), mScale(pNBins / (pHigh - pLow)),
+          mScaleD(pNBins / (double(pHigh) - double(pLow))), mNBins(pNBins) {}
+
+    unsigned bin(float pValue) const {
+        /* NaNs fail both comparisons */
+        if (!(pValue >= mLow && pValue <= mHigh))
+            return mNBins;
+        return std::min(unsigned((pValue - mLow) * mScale), mNBins - 1);
+    }
+
+    unsigned bin(double pValue) const {
+        if (!(pValue >= mLow && pValue <= mHigh))
+            return mNBins;
+        return std::min(unsigned((pValue - mLow) * mScaleD), mNBins - 1);
+    }
+};
+
+template<typename T> struct BinArithmetic        { typedef double type; };
+template<>           struct BinArithmetic<float> { typedef float  type; };
+
+template<typename T>
+void scalarBins(const T* pSamples, size_t pBegin, size_t pEnd,
+                const Binner& pBinner, size_t* pCounts)
+{
+    typedef typename BinArithmetic<T>::type Arithmetic;
+    for (size_t i=pBegin; i<pEnd; ++i)
+        ++pCounts[pBinner.bin(Arithmetic(pSamples[i]))];
+}
+
+/* 8 and 16 bit samples are counted per value, which needs no arithmetic
+ * per sample, and the counts of the values are added to their bins.
+ * The value counts are added to the bins before they can overflow */
+template<typename T>
+void tableBins(const T* pSamples, size_t pBegin, size_t pEnd,
+               const Binner& pBinner, size_t* pCounts)
+{
+    const int    LOWEST = std::numeric_limits<T>::min();
+    const size_t VALUES = size_t(1) << (8*sizeof(T));
+    const size_t BLOCK  = std::numeric_limits<unsigned>::max();
+
+    std::vector<unsigned> values(VALUES);
+    for (size_t first=pBegin; first<pEnd; first+=BLOCK) {
+        size_t last = first + std::min(BLOCK, pEnd - first);
+        std::fill(values.begin(), values.end(), 0u);
+        for (size_t i=first; i<last; ++i)
+            ++values[int(pSamples[i]) - LOWEST];
+        for (size_t v=0; v<VALUES; ++v) {
+            if (values[v])
+                pCounts[pBinner.bin(double(LOWEST + int(v)))] += values[v];
+        }
+    }
+}
+
+/* Bin indices of LANES samples are computed at a time and counted one
+ * by one, samples outside the range are counted in the extra bin.
+ * Returns the number of samples counted, the remainder is left to
+ * scalarBins */
+#if defined(FG_BINNING_AVX)
+FG_BINNING_AVX
+size_t simdBins(const float* pSamples, size_t pBegin, size_t pEnd,
+                const Binner& pBinner, size_t* pCounts)
+{
+    const size_t LANES = 8;
+    size_t blocks = (pEnd - pBegin) / LANES;
+    const __m256 low     = _mm256_set1_ps(pBinner.mLow);
+    const __m256 high    = _mm256_set1_ps(pBinner.mHigh);
+    const __m256 scale   = _mm256_set1_ps(pBinner.mScale);
+    const __m256 last    = _mm256_set1_ps(float(pBinner.mNBins - 1));
+    const __m256 outside = _mm256_set1_ps(float(pBinner.mNBins));
+
+    const float* ptr = pSamples + pBegin;
+    for (size_t b=0; b<blocks; ++b, ptr+=LANES) {
+        __m256 v  = _mm256_loadu_ps(ptr);
+        /* ordered comparisons are false for NaNs */
+        __m256 in = _mm256_and_ps(_mm256_cmp_ps(v, low, _CMP_GE_OQ),
+                                  _mm256_cmp_ps(v, high, _CMP_LE_OQ));
+        __m256 f  = _mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(v, low), scale), last);
+        __m256i bins = _mm256_cvttps_epi32(_mm256_blendv_ps(outside, f, in));
+        /* the indices are extracted from the register, storing it and
+         * loading them back stalls on store forwarding */
+        __m128i lo = _mm256_castsi256_si128(bins);
+        __m128i hi = _mm256_extractf128_si256(bins, 1);
+        ++pCounts[_mm_cvtsi128_si32(lo)];
+        ++pCounts[_mm_extract_epi32(lo, 1)];
+        ++pCounts[_mm_extract_epi32(lo, 2)];
+        ++pCounts[_mm_extract_epi32(lo, 3)];
+        ++pCounts[_mm_cvtsi128_si32(hi)];
+        ++pCounts[_mm_extract_epi32(hi, 1)];
+        ++pCounts[_mm_extract_epi32(hi, 2)];
+        ++pCounts[_mm_extract_epi32(hi, 3)];
+    }
+    return blocks*LANES;
+}
+#elif defined(FG_BINNING_NEON)
+size_t simdBins(const float* pSamples, size_t pBegin, size_t pEnd,
+                const Binner& pBinner, size_t* pCounts)
+{
+    const size_t LANES = 4;
+    size_t blocks = (pEnd - pBegin) / LANES;
+    const float32x4_t low     = vdupq_n_f32(pBinner.mLow);
+    const float32x4_t high    = vdupq_n_f32(pBinner.mHigh);
+    const float32x4_t scale   = vdupq_n_f32(pBinner.mScale);
+    const float32x4_t last    = vdupq_n_f32(float(pBinner.mNBins - 1));
+    const float32x4_t outside = vdupq_n_f32(float(pBinner.mNBins));
+
+    const float* ptr = pSamples + pBegin;
+    for (size_t b=0; b<blocks; ++b, ptr+=LANES) {
+        float32x4_t v  = vld1q_f32(ptr);
+        /* comparisons are false for NaNs */
+        uint32x4_t  in = vandq_u32(vcgeq_f32(v, low), vcleq_f32(v, high));
+        float32x4_t f  = vminq_f32(vmulq_f32(vsubq_f32(v, low), scale), last);
+        uint32x4_t bins = vcvtq_u32_f32(vbslq_f32(in, f, outside));
+        ++pCounts[vgetq_lane_u32(bins, 0)];
+        ++pCounts[vgetq_lane_u32(bins, 1)];
+        ++pCounts[vgetq_lane_u32(bins, 2)];
+        ++pCounts[vgetq_lane_u32(bins, 3)];
+    }
+    return blocks*LANES;
+}
+#endif
+
+void floatBins(const float* pSamples, size_t pBegin, size_t pEnd,
+               const Binner& pBinner, size_t* pCounts)
+{
+#if defined(FG_BINNING_AVX)
+    if (haveAVX())
+        pBegin += simdBins(pSamples, pBegin, pEnd, pBinner, pCounts);
+#elif defined(FG_BINNING_NEON)
+    pBegin += simdBins(pSamples, pBegin, pEnd, pBinner, pCounts);
+#endif
+    scalarBins(pSamples, pBegin, pEnd, pBinner, pCounts);
+}
+
+/* counting values only pays off for ranges that have
+ * at least as many samples as the type has values */
+template<typename T>
+void smallBins(const T* pSamples, size_t pBegin, size_t pEnd,
+               const Binner& pBinner, size_t* pCounts)
+{
+    if (pEnd - pBegin >= (size_t(1) << (8*sizeof(T))))
+        tableBins(pSamples, pBegin, pEnd, pBinner, pCounts);
+    else
+        scalarBins(pSamples, pBegin, pEnd, pBinner, pCounts);
+}
+
+void rangeBins(const void* pSamples, GLenum pType, size_t pBegin, size_t pEnd,
+               const Binner* pBinner, size_t* pCounts)
+{
+    switch(pType) {
+        case GL_FLOAT:          floatBins((const float*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+        case GL_INT:            scalarBins((const int*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+        case GL_UNSIGNED_INT:   scalarBins((const unsigned*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+        case GL_SHORT:          smallBins((const short*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+        case GL_UNSIGNED_SHORT: smallBins((const unsigned short*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+        case GL_UNSIGNED_BYTE:  smallBins((const unsigned char*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+        case GL_BYTE:           smallBins((const signed char*)pSamples, pBegin, pEnd, *pBinner, pCounts); break;
+    }
+}
+
+}
+
+namespace internal
+{
+
+void computeHistogram(const void* pSamples, GLenum pType, size_t pCount,
+                      float pLow, float pHigh, unsigned pNBins, size_t* pCounts)
+{
+    std::fill(pCounts, pCounts + pNBins, size_t(0));
+    if (pNBins == 0)
+        return;
+
+    Binner binner(pLow, pHigh, pNBins);
+    size_t threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                                       pCount / MIN_SAMPLES_PER_THREAD);
+    threads = std::max<size_t>(threads, 1);
+
+    /* every thread counts into its own bins, with the extra bin of
+     * samples that aren't counted, which are a cache line apart from
+     * those of the next thread. The calling thread takes the last range */
+    const size_t stride = pNBins + 1 + 64 / sizeof(size_t);
+    std::vector<size_t> counts(stride*threads);
+    std::vector<std::thread> workers;
+    size_t step = (pCount + threads - 1) / threads;
+    for (size_t t=0; t<threads; ++t) {
+        size_t* bins  = &counts[stride*t];
+        size_t  begin = std::min(t*step, pCount);
+        size_t  end   = std::min(begin + step, pCount);
+        if (t + 1 < threads)
+            workers.push_back(std::thread(rangeBins, pSamples, pType, begin, end, &binner, bins));
+        else
+            rangeBins(pSamples, pType, begin, end, &binner, bins);
+    }
+    for (size_t t=0; t<workers.size(); ++t)
+        workers[t].join();
+
+    for (size_t t=0; t<threads; ++t) {
+        for (unsigned b=0; b<pNBins; ++b)
+            pCounts[b] += counts[stride*t + b];
+    }
+}
+
+}
+
+namespace
+{
+
+struct TexelFormat {
+    GLenum      mFormat;
+    const char* mPrefix;
+    const char* mType;
+    /* largest value, if a count can exceed it */
+    unsigned    mTop;
+};
+
+/* single channel formats that keep the values of the data types */
+TexelFormat texelFormat(GLenum pType)
+{
+    const unsigned NONE = 0xFFFFFFFFu;
+    switch(pType) {
+        case GL_INT:            return {GL_R32I,  "i", "int",   2147483647};
+        case GL_UNSIGNED_INT:   return {GL_R32UI, "u", "uint",  NONE};
+        case GL_SHORT:          return {GL_R16I,  "i", "int",   32767};
+        case GL_UNSIGNED_SHORT: return {GL_R16UI, "u", "uint",  65535};
+        case GL_BYTE:           return {GL_R8I,   "i", "int",   127};
+        case GL_UNSIGNED_BYTE:  return {GL_R8UI,  "u", "uint",  255};
+        default:                return {GL_R32F,  "",  "float", NONE};
+    }
+}
+
+std::string toString(unsigned pValue)
+{
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u", pValue);
+    return buffer;
+}
+
+/* bins of samples read from a buffer texture, as computeHistogram
+ * does in float arithmetic. Samples not counted get bin nbins */
+std::string binOfSource(GLenum pType)
+{
+    return std::string(
+    "uniform ") + texelFormat(pType).mPrefix + "samplerBuffer samples;\n"
+    "uniform int first;\n"
+    "uniform int stride;\n"
+    "uniform float low;\n"
+    "uniform float high;\n"
+    "uniform float scale;\n"
+    "uniform uint nbins;\n"
+    "uint binOf(int i) {\n"
+    "   float v = float(texelFetch(samples, first + i * stride).r);\n"
+    "   if (isnan(v) || !(v >= low && v <= high))\n"
+    "       return nbins;\n"
+    "   return min(uint((v - low) * scale), nbins - 1u);\n"
+    "}\n";
+}
+
+std::string countComputeSource(GLenum pType)
+{
+    using internal::BinningPass;
+    return std::string(
+    "#version 430\n"
+    "#define GROUP_SIZE ") + toString(BinningPass::GROUP_SIZE) + "u\n"
+    "#define SHARED_BINS " + toString(BinningPass::SHARED_BINS) + "u\n"
+    "layout(local_size_x = " + toString(BinningPass::GROUP_SIZE) + ") in;\n"
+    "layout(std430, binding = 0) buffer Counts { uint counts[]; };\n"
+    "shared uint groupCounts[SHARED_BINS];\n"
+    "uniform uint count;\n"
+    + binOfSource(pType) +
+    "void main(void) {\n"
+    "   bool grouped = (nbins <= SHARED_BINS);\n"
+    "   if (grouped) {\n"
+    "       for (uint b = gl_LocalInvocationIndex; b < nbins; b += GROUP_SIZE)\n"
+    "           groupCounts[b] = 0u;\n"
+    "   }\n"
+    "   memoryBarrierShared();\n"
+    "   barrier();\n"
+    "   uint step = gl_NumWorkGroups.x * GROUP_SIZE;\n"
+    "   for (uint i = gl_GlobalInvocationID.x; i < count; i += step) {\n"
+    "       uint bin = binOf(int(i));\n"
+    "       if (bin < nbins) {\n"
+    "           if (grouped)\n"
+    "               atomicAdd(groupCounts[bin], 1u);\n"
+    "           else\n"
+    "               atomicAdd(counts[bin], 1u);\n"
+    "       }\n"
+    "   }\n"
+    "   memoryBarrierShared();\n"
+    "   barrier();\n"
+    "   if (grouped) {\n"
+    "       for (uint b = gl_LocalInvocationIndex; b < nbins; b += GROUP_SIZE) {\n"
+    "           if (groupCounts[b] != 0u)\n"
+    "               atomicAdd(counts[b], groupCounts[b]);\n"
+    "       }\n"
+    "   }\n"
+    "}\n";
+}
+
+std::string countVertexSource(GLenum pType)
+{
+    return std::string(
+    "#version 330\n"
+    "#define ROW ") + toString(internal::BinningPass::ROW) + "u\n"
+    "uniform vec2 size;\n"
+    + binOfSource(pType) +
+    "void main(void) {\n"
+    "   uint bin = binOf(gl_VertexID);\n"
+    "   vec2 texel = vec2(bin % ROW, bin / ROW) + 0.5;\n"
+    "   gl_Position = (bin < nbins ? vec4(2 * texel / size - 1, 0, 1) : vec4(2, 2, 2, 1));\n"
+    "   gl_PointSize = 1;\n"
+    "}\n";
+}
+
+const char *gCountFragmentShaderSrc =
+"#version 330\n"
+"out float count;\n"
+"void main(void) {\n"
+"   count = 1;\n"
+"}";
+
+/* a triangle that covers the viewport */
+const char *gConvertVertexShaderSrc =
+"#version 330\n"
+"void main(void) {\n"
+"   vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+"   gl_Position = vec4(2 * pos - 1, 0, 1);\n"
+"}";
+
+/* counts are read from the storage buffer as a buffer texture
+ * after compute passes, from the blending target otherwise */
+std::string convertFragmentSource(bool pCompute, GLenum pTargetType)
+{
+    TexelFormat target = texelFormat(pTargetType);
+    std::string src = std::string(
+    "#version 330\n"
+    "#define ROW ") + toString(internal::BinningPass::ROW) + "\n"
+    "out " + target.mType + " value;\n";
+    if (pCompute) {
+        src += std::string(
+        "uniform usamplerBuffer counts;\n"
+        "void main(void) {\n"
+        "   ivec2 texel = ivec2(gl_FragCoord.xy);\n"
+        "   uint c = texelFetch(counts, texel.y * ROW + texel.x).r;\n"
+        "   value = ") + target.mType + "(min(c, " + toString(target.mTop) + "u));\n"
+        "}\n";
+    } else {
+        src += std::string(
+        "uniform sampler2D counts;\n"
+        "void main(void) {\n"
+        "   float c = texelFetch(counts, ivec2(gl_FragCoord.xy), 0).r;\n");
+        if (pTargetType == GL_FLOAT) {
+            src += "   value = c;\n";
+        } else {
+            /* the limit rounds up as a float, so counts below it
+             * convert exactly and the others get the limit itself */
+            std::string top = toString(target.mTop) + (target.mPrefix[0]=='u' ? "u" : "");
+            src += std::string(
+            "   value = (c < ") + toString(target.mTop) + ".0 ? " + target.mType + "(c) : " + top + ");\n";
+        }
+        src += "}\n";
+    }
+    return src;
+}
+
+}
+
+namespace internal
+{
+
+const unsigned BinningPass::ROW;
+const unsigned BinningPass::GROUP_SIZE;
+const unsigned BinningPass::MAX_GROUPS;
+const unsigned BinningPass::SHARED_BINS;
+
+BinningPass::BinningPass(GLenum pTargetType)
+    : mTargetType(pTargetType), mCompute(GLEW_VERSION_4_3), mSampleType(0),
+      mCountProgram(), mConvertProgram(), mNBins(0), mSampleTexture(0),
+      mCountTexture(0), mCountBuffer(0), mTargetTexture(0), mFramebuffer(0)
+{
+    CheckGL("Begin BinningPass::BinningPass");
+    std::string fs = convertFragmentSource(mCompute, mTargetType);
+    mConvertProgram = acquireProgram(gConvertVertexShaderSrc, fs.c_str());
+    glGenTextures(1, &mSampleTexture);
+    glGenFramebuffers(1, &mFramebuffer);
+    CheckGL("End BinningPass::BinningPass");
+}
+
+BinningPass::~BinningPass()
+{
+    CheckGL("Begin BinningPass::~BinningPass");
+    for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
+        GLuint vao = it->second;
+        glDeleteVertexArrays(1, &vao);
+    }
+    glDeleteFramebuffers(1, &mFramebuffer);
+    glDeleteTextures(1, &mSampleTexture);
+    glDeleteTextures(1, &mCountTexture);
+    glDeleteTextures(1, &mTargetTexture);
+    glDeleteBuffers(1, &mCountBuffer);
+    releaseProgram(mCountProgram);
+    releaseProgram(mConvertProgram);
+    CheckGL("End BinningPass::~BinningPass");
+}
+
+void BinningPass::bindVAO(int pWindowId)
+{
+    /* draws without attributes still need a vertex array */
+    if (mVAOMap.find(pWindowId) == mVAOMap.end()) {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        mVAOMap[pWindowId] = vao;
+    }
+    glBindVertexArray(mVAOMap[pWindowId]);
+}
+
+void BinningPass::prepare(GLenum pSampleType, unsigned pNBins)
+{
+    if (pSampleType != mSampleType) {
+        releaseProgram(mCountProgram);
+        if (mCompute) {
+            std::string cs = countComputeSource(pSampleType);
+            mCountProgram = acquireComputeProgram(cs.c_str());
+        } else {
+            std::string vs = countVertexSource(pSampleType);
+            mCountProgram = acquireProgram(vs.c_str(), gCountFragmentShaderSrc);
+        }
+        mSampleType = pSampleType;
+    }
+
+    if (pNBins != mNBins) {
+        GLsizei width  = GLsizei(std::min(pNBins, ROW));
+        GLsizei height = GLsizei((pNBins + ROW - 1) / ROW);
+
+        glDeleteTextures(1, &mCountTexture);
+        glDeleteTextures(1, &mTargetTexture);
+        glGenTextures(1, &mCountTexture);
+        glGenTextures(1, &mTargetTexture);
+        if (mCompute) {
+            glDeleteBuffers(1, &mCountBuffer);
+            mCountBuffer = createBuffer<GLuint>(GL_SHADER_STORAGE_BUFFER, pNBins, NULL, GL_DYNAMIC_COPY);
+            glBindTexture(GL_TEXTURE_BUFFER, mCountTexture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, mCountBuffer);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, mCountTexture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, NULL);
+        }
+        TexelFormat target = texelFormat(mTargetType);
+        glBindTexture(GL_TEXTURE_2D, mTargetTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, target.mFormat, width, height, 0,
+                     (mTargetType==GL_FLOAT ? GL_RED : GL_RED_INTEGER), mTargetType, NULL);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mNBins = pNBins;
+    }
+}
+
+void BinningPass::countByCompute(size_t pCount)
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, mCountBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mCountBuffer);
+
+    glUniform1ui(glGetUniformLocation(mCountProgram, "count"), GLuint(pCount));
+    size_t groups = std::min<size_t>((pCount + GROUP_SIZE - 1) / GROUP_SIZE, MAX_GROUPS);
+    glDispatchCompute(GLuint(std::max<size_t>(groups, 1)), 1, 1);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+    /* the conversion pass reads the counts through a buffer texture */
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void BinningPass::countByBlending(size_t pCount)
+{
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mCountTexture, 0);
+    const GLfloat zero[] = {0, 0, 0, 0};
+    glClearBufferfv(GL_COLOR, 0, zero);
+
+    glUniform2f(glGetUniformLocation(mCountProgram, "size"),
+                float(std::min(mNBins, ROW)), float((mNBins + ROW - 1) / ROW));
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glDrawArrays(GL_POINTS, 0, GLsizei(pCount));
+    glDisable(GL_BLEND);
+}
+
+bool BinningPass::run(int pWindowId, GLuint pSource, size_t pOffset, GLenum pType,
+                      unsigned pComponents, unsigned pComponent, size_t pCount,
+                      float pLow, float pHigh, unsigned pNBins, GLuint pTarget)
+{
+    if (pNBins == 0)
+        return true;
+
+    CheckGL("Begin BinningPass::run");
+    /* the buffer texture spans the whole source buffer */
+    GLint64 sourceSize = 0;
+    GLint   maxTexels  = 0;
+    glBindBuffer(GL_TEXTURE_BUFFER, pSource);
+    glGetBufferParameteri64v(GL_TEXTURE_BUFFER, GL_BUFFER_SIZE, &sourceSize);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    size_t valueSize = gl_sizeof(pType);
+    if (size_t(sourceSize) / valueSize > size_t(maxTexels))
+        return false;
+
+    prepare(pType, pNBins);
+    GLsizei width  = GLsizei(std::min(pNBins, ROW));
+    GLsizei height = GLsizei((pNBins + ROW - 1) / ROW);
+
+    /* the window may render to a framebuffer object of its own */
+    GLint drawFbo = 0;
+    GLint readFbo = 0;
+    GLint viewport[4];
+    GLint blendEquation[2];
+    GLint blendFunc[4];
+    GLint packAlignment = 4;
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean blend   = glIsEnabled(GL_BLEND);
+    GLboolean depth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, &blendEquation[0]);
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &blendEquation[1]);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &blendFunc[0]);
+    glGetIntegerv(GL_BLEND_DST_RGB, &blendFunc[1]);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendFunc[2]);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendFunc[3]);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glViewport(0, 0, width, height);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    bindVAO(pWindowId);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, mSampleTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, texelFormat(pType).mFormat, pSource);
+
+    glUseProgram(mCountProgram);
+    glUniform1i(glGetUniformLocation(mCountProgram, "samples"), 0);
+    glUniform1i(glGetUniformLocation(mCountProgram, "first"), GLint(pOffset / valueSize + pComponent));
+    glUniform1i(glGetUniformLocation(mCountProgram, "stride"), GLint(pComponents));
+    glUniform1f(glGetUniformLocation(mCountProgram, "low"), pLow);
+    glUniform1f(glGetUniformLocation(mCountProgram, "high"), pHigh);
+    glUniform1f(glGetUniformLocation(mCountProgram, "scale"), pNBins / (pHigh - pLow));
+    glUniform1ui(glGetUniformLocation(mCountProgram, "nbins"), pNBins);
+    if (mCompute)
+        countByCompute(pCount);
+    else
+        countByBlending(pCount);
+
+    /* convert the counts and read them into the histogram */
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTargetTexture, 0);
+    glUseProgram(mConvertProgram);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(mCompute ? GL_TEXTURE_BUFFER : GL_TEXTURE_2D, mCountTexture);
+    glUniform1i(glGetUniformLocation(mConvertProgram, "counts"), 1);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    GLenum format  = (mTargetType==GL_FLOAT ? GL_RED : GL_RED_INTEGER);
+    GLsizei rows   = GLsizei(pNBins / ROW);
+    GLsizei rest   = GLsizei(pNBins % ROW);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pTarget);
+    if (rows > 0)
+        glReadPixels(0, 0, ROW, rows, format, mTargetType, 0);
+    if (rest > 0) {
+        size_t offset = size_t(rows) * ROW * gl_sizeof(mTargetType);
+        glReadPixels(0, rows, rest, 1, format, mTargetType, reinterpret_cast<void*>(offset));
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glBindTexture(mCompute ? GL_TEXTURE_BUFFER : GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glUseProgram(0);
+    glBindVertexArray(0);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+    glBlendEquationSeparate(blendEquation[0], blendEquation[1]);
+    glBlendFuncSeparate(blendFunc[0], blendFunc[1], blendFunc[2], blendFunc[3]);
+    if (blend)
+        glEnable(GL_BLEND);
+    if (depth)
+        glEnable(GL_DEPTH_TEST);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo);
+    CheckGL("End BinningPass::run");
+    return true;
+}
+
+}
@@ -0,0 +1,92 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <map>
+
+namespace internal
+{
+
+/* Counts pCount samples of type pType at pSamples into pNBins bins of
+ * equal width that span [pLow, pHigh] and writes the counts to pCounts.
+ * Bin i holds samples in [pLow + i*w, pLow + (i+1)*w) where w is the bin
+ * width, the last bin also holds pHigh. Samples outside the range and
+ * NaNs are not counted.
+ *
+ * Large inputs are split between threads that count into their own bins,
+ * which are added up at the end. Float bin indices are computed with AVX
+ * or NEON where the processor has it, 8 and 16 bit samples are counted
+ * per value first and the value counts are then added to their bins. */
+void computeHistogram(const void* pSamples, GLenum pType, size_t pCount,
+                      float pLow, float pHigh, unsigned pNBins, size_t* pCounts);
+
+/* Histogram of samples that are in a buffer object, binned on the GPU
+ * the same way as by computeHistogram, but in float arithmetic
+ *
+ * The samples are read through a buffer texture. With compute shaders
+ * (OpenGL 4.3) work groups count the samples with atomic additions to
+ * bins in shared memory, which are then added to the bins of a storage
+ * buffer. Otherwise every sample is drawn as a point on the texel of its
+ * bin in a float target with additive blending, which counts exactly up
+ * to 2^24 samples per bin. A last pass converts the counts to the data
+ * type of the histogram, clamped to its largest value, and the converted
+ * bins are read into the histogram buffer as pixels. */
+class BinningPass {
+    public:
+        /* bins are laid out in rows of ROW texels */
+        static const unsigned ROW         = 1024;
+        static const unsigned GROUP_SIZE  = 256;
+        static const unsigned MAX_GROUPS  = 1024;
+        /* histograms with more bins count in the storage buffer only */
+        static const unsigned SHARED_BINS = 4096;
+
+    private:
+        GLenum      mTargetType;
+        bool        mCompute;
+
+        GLenum      mSampleType;
+        ProgramRef  mCountProgram;
+        ProgramRef  mConvertProgram;
+
+        unsigned    mNBins;
+        GLuint      mSampleTexture;
+        GLuint      mCountTexture;
+        GLuint      mCountBuffer;
+        GLuint      mTargetTexture;
+        GLuint      mFramebuffer;
+        std::map<int, GLuint> mVAOMap;
+
+        BinningPass(const BinningPass& other);
+        BinningPass& operator=(const BinningPass& other);
+
+        void bindVAO(int pWindowId);
+        void prepare(GLenum pSampleType, unsigned pNBins);
+        void countByCompute(size_t pCount);
+        void countByBlending(size_t pCount);
+
+    public:
+        /* pTargetType is the data type of the histogram */
+        BinningPass(GLenum pTargetType);
+        ~BinningPass();
+
+        /* bins pCount samples of type pType that are component pComponent
+         * of tuples of pComponents values starting at byte pOffset of
+         * pSource into pNBins bins over [pLow, pHigh], and writes the bins
+         * to the start of pTarget. pWindowId is the window whose context
+         * is current. Returns false without binning when the samples
+         * exceed what a buffer texture can hold */
+        bool run(int pWindowId, GLuint pSource, size_t pOffset, GLenum pType,
+                 unsigned pComponents, unsigned pComponent, size_t pCount,
+                 float pLow, float pHigh, unsigned pNBins, GLuint pTarget);
+};
+
+}
@@ -0,0 +1,397 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <bounds.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FG_BOUNDS_AVX __attribute__((target("avx")))
+static bool haveAVX() { return __builtin_cpu_supports("avx"); }
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define FG_BOUNDS_AVX
+static bool haveAVX() { return true; }
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FG_BOUNDS_NEON
+#endif
+
+/* inputs are split between threads in ranges of at least this many values */
+static const size_t MIN_VALUES_PER_THREAD = 1 << 20;
+
+static const char *gBoundsVertexShaderSrc =
+"#version 330\n"
+"in vec3 point;\n"
+"uniform int grid;\n"
+"flat out vec3 value;\n"
+"void main(void) {\n"
+"   int cell = gl_VertexID % (grid * grid);\n"
+"   vec2 pos = (vec2(cell % grid, cell / grid) + 0.5) / grid;\n"
+"   gl_Position = vec4(pos * 2 - 1, 0, 1);\n"
+"   value = point;\n"
+"}";
+
+/* both targets blend with GL_MIN, the second gets negated values */
+static const char *gBoundsFragmentShaderSrc =
+"#version 330\n"
+"flat in vec3 value;\n"
+"layout(location = 0) out vec4 lo;\n"
+"layout(location = 1) out vec4 negHi;\n"
+"void main(void) {\n"
+"   vec3 inf = vec3(uintBitsToFloat(0x7F800000u));\n"
+"   bvec3 nan = isnan(value);\n"
+"   lo    = vec4(mix( value, inf, nan), 0);\n"
+"   negHi = vec4(mix(-value, inf, nan), 0);\n"
+"}";
+
+namespace
+{
+
+template<typename T>
+void scalarBounds(const T* pData, unsigned pComponents, size_t pBegin, size_t pEnd,
+                  float* pMin, float* pMax)
+{
+    /* comparisons skip NaNs, which fail both of them */
+    typedef std::numeric_limits<T> limits;
+    const T top    = (limits::has_infinity ? limits::infinity() : limits::max());
+    const T bottom = (limits::has_infinity ? -limits::infinity() : limits::lowest());
+    T lo[3] = {top, top, top};
+    T hi[3] = {bottom, bottom, bottom};
+
+    for (size_t i=pBegin; i<pEnd; ++i) {
+        for (unsigned c=0; c<pComponents; ++c) {
+            T v = pData[i*pComponents + c];
+            if (v < lo[c]) lo[c] = v;
+            if (v > hi[c]) hi[c] = v;
+        }
+    }
+    if (pBegin >= pEnd)
+        return;
+    for (unsigned c=0; c<pComponents; ++c) {
+        pMin[c] = std::min(pMin[c], float(lo[c]));
+        pMax[c] = std::max(pMax[c], float(hi[c]));
+    }
+}
+
+/* A block of LANES tuples spans pComponents registers, in each of which
+ * lane l always holds the same component. Returns the number of tuples
+ * reduced, the remainder is left to scalarBounds */
+#if defined(FG_BOUNDS_AVX)
+FG_BOUNDS_AVX
+size_t simdBounds(const float* pData, unsigned pComponents, size_t pBegin, size_t pEnd,
+                  float* pMin, float* pMax)
+{
+    const size_t LANES = 8;
+    size_t blocks = (pEnd - pBegin) / LANES;
+    __m256 lo[3], hi[3];
+    for (unsigned r=0; r<pComponents; ++r) {
+        lo[r] = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        hi[r] = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    }
+    const float* ptr = pData + pBegin*pComponents;
+    for (size_t b=0; b<blocks; ++b) {
+        for (unsigned r=0; r<pComponents; ++r) {
+            /* the second operand is returned for NaNs */
+            __m256 v = _mm256_loadu_ps(ptr + r*LANES);
+            lo[r] = _mm256_min_ps(v, lo[r]);
+            hi[r] = _mm256_max_ps(v, hi[r]);
+        }
+        ptr += LANES*pComponents;
+    }
+    float l[3*LANES], h[3*LANES];
+    for (unsigned r=0; r<pComponents; ++r) {
+        _mm256_storeu_ps(l + r*LANES, lo[r]);
+        _mm256_storeu_ps(h + r*LANES, hi[r]);
+    }
+    for (unsigned i=0; i<pComponents*LANES; ++i) {
+        pMin[i % pComponents] = std::min(pMin[i % pComponents], l[i]);
+        pMax[i % pComponents] = std::max(pMax[i % pComponents], h[i]);
+    }
+    return blocks*LANES;
+}
+#elif defined(FG_BOUNDS_NEON)
+size_t simdBounds(const float* pData, unsigned pComponents, size_t pBegin, size_t pEnd,
+                  float* pMin, float* pMax)
+{
+    const size_t LANES = 4;
+    size_t blocks = (pEnd - pBegin) / LANES;
+    float32x4_t lo[3], hi[3];
+    for (unsigned r=0; r<pComponents; ++r) {
+        lo[r] = vdupq_n_f32(std::numeric_limits<float>::infinity());
+        hi[r] = vdupq_n_f32(-std::numeric_limits<float>::infinity());
+    }
+    const float* ptr = pData + pBegin*pComponents;
+    for (size_t b=0; b<blocks; ++b) {
+        for (unsigned r=0; r<pComponents; ++r) {
+            /* the number is returned when the other operand is NaN */
+            float32x4_t v = vld1q_f32(ptr + r*LANES);
+            lo[r] = vminnmq_f32(v, lo[r]);
+            hi[r] = vmaxnmq_f32(v, hi[r]);
+        }
+        ptr += LANES*pComponents;
+    }
+    float l[3*LANES], h[3*LANES];
+    for (unsigned r=0; r<pComponents; ++r) {
+        vst1q_f32(l + r*LANES, lo[r]);
+        vst1q_f32(h + r*LANES, hi[r]);
+    }
+    for (unsigned i=0; i<pComponents*LANES; ++i) {
+        pMin[i % pComponents] = std::min(pMin[i % pComponents], l[i]);
+        pMax[i % pComponents] = std::max(pMax[i % pComponents], h[i]);
+    }
+    return blocks*LANES;
+}
+#endif
+
+void floatBounds(const float* pData, unsigned pComponents, size_t pBegin, size_t pEnd,
+                 float* pMin, float* pMax)
+{
+#if defined(FG_BOUNDS_AVX)
+    if (haveAVX())
+        pBegin += simdBounds(pData, pComponents, pBegin, pEnd, pMin, pMax);
+#elif defined(FG_BOUNDS_NEON)
+    pBegin += simdBounds(pData, pComponents, pBegin, pEnd, pMin, pMax);
+#endif
+    scalarBounds(pData, pComponents, pBegin, pEnd, pMin, pMax);
+}
+
+void rangeBounds(const void* pData, GLenum pType, unsigned pComponents,
+                 size_t pBegin, size_t pEnd, float* pMin, float* pMax)
+{
+    switch(pType) {
+        case GL_FLOAT:          floatBounds((const float*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+        case GL_INT:            scalarBounds((const int*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+        case GL_UNSIGNED_INT:   scalarBounds((const unsigned*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+        case GL_SHORT:          scalarBounds((const short*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+        case GL_UNSIGNED_SHORT: scalarBounds((const unsigned short*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+        case GL_UNSIGNED_BYTE:  scalarBounds((const unsigned char*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+        case GL_BYTE:           scalarBounds((const signed char*)pData, pComponents, pBegin, pEnd, pMin, pMax); break;
+    }
+}
+
+}
+
+namespace internal
+{
+
+void computeBounds(const void* pData, GLenum pType, unsigned pComponents,
+                   size_t pCount, float* pMin, float* pMax)
+{
+    for (unsigned c=0; c<pComponents; ++c) {
+        pMin[c] =  std::numeric_limits<float>::infinity();
+        pMax[c] = -std::numeric_limits<float>::infinity();
+    }
+
+    size_t threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                                       pCount*pComponents / MIN_VALUES_PER_THREAD);
+    if (threads <= 1) {
+        rangeBounds(pData, pType, pComponents, 0, pCount, pMin, pMax);
+        return;
+    }
+
+    /* the calling thread takes the last range */
+    std::vector<float> bounds(2*3*threads);
+    std::vector<std::thread> workers;
+    size_t step = (pCount + threads - 1) / threads;
+    for (size_t t=0; t<threads; ++t) {
+        float* lo = &bounds[6*t];
+        float* hi = lo + 3;
+        std::copy(pMin, pMin + pComponents, lo);
+        std::copy(pMax, pMax + pComponents, hi);
+        size_t begin = std::min(t*step, pCount);
+        size_t end   = std::min(begin + step, pCount);
+        if (t + 1 < threads)
+            workers.push_back(std::thread(rangeBounds, pData, pType, pComponents, begin, end, lo, hi));
+        else
+            rangeBounds(pData, pType, pComponents, begin, end, lo, hi);
+    }
+    for (size_t t=0; t<workers.size(); ++t)
+        workers[t].join();
+
+    for (size_t t=0; t<threads; ++t) {
+        for (unsigned c=0; c<pComponents; ++c) {
+            pMin[c] = std::min(pMin[c], bounds[6*t + c]);
+            pMax[c] = std::max(pMax[c], bounds[6*t + 3 + c]);
+        }
+    }
+}
+
+const int BoundsReduction::GRID;
+
+BoundsReduction::BoundsReduction()
+    : mFramebuffer(0), mPointIndex(0), mPBO(0), mFence(0), mDrawFbo(0), mReadFbo(0),
+      mScissor(GL_FALSE), mBlend(GL_FALSE), mDepth(GL_FALSE)
+{
+    CheckGL("Begin BoundsReduction::BoundsReduction");
+    mProgram    = acquireProgram(gBoundsVertexShaderSrc, gBoundsFragmentShaderSrc);
+    mPointIndex = glGetAttribLocation(mProgram, "point");
+
+    glGenTextures(2, mTextures);
+    for (int t=0; t<2; ++t) {
+        glBindTexture(GL_TEXTURE_2D, mTextures[t]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, GRID, GRID, 0, GL_RGBA, GL_FLOAT, NULL);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLenum buffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    GLint fbo = 0;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+    glGenFramebuffers(1, &mFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextures[0], 0);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mTextures[1], 0);
+    glDrawBuffers(2, buffers);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+
+    glGenBuffers(1, &mPBO);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, mPBO);
+    glBufferData(GL_PIXEL_PACK_BUFFER, 2*4*GRID*GRID*sizeof(float), NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    CheckGL("End BoundsReduction::BoundsReduction");
+}
+
+BoundsReduction::~BoundsReduction()
+{
+    CheckGL("Begin BoundsReduction::~BoundsReduction");
+    for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
+        GLuint vao = it->second;
+        glDeleteVertexArrays(1, &vao);
+    }
+    cancel();
+    glDeleteBuffers(1, &mPBO);
+    glDeleteFramebuffers(1, &mFramebuffer);
+    glDeleteTextures(2, mTextures);
+    releaseProgram(mProgram);
+    CheckGL("End BoundsReduction::~BoundsReduction");
+}
+
+GLuint BoundsReduction::pointIndex() const
+{
+    return mPointIndex;
+}
+
+void BoundsReduction::begin(int pWindowId)
+{
+    CheckGL("Begin BoundsReduction::begin");
+    /* the window may render to a framebuffer object of its own */
+    mScissor = glIsEnabled(GL_SCISSOR_TEST);
+    mBlend   = glIsEnabled(GL_BLEND);
+    mDepth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &mDrawFbo);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &mReadFbo);
+    glGetIntegerv(GL_VIEWPORT, mViewport);
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, &mBlendEquation[0]);
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &mBlendEquation[1]);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glViewport(0, 0, GRID, GRID);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_TEST);
+    const GLfloat inf[] = {std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::infinity()};
+    glClearBufferfv(GL_COLOR, 0, inf);
+    glClearBufferfv(GL_COLOR, 1, inf);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_MIN);
+
+    glUseProgram(mProgram);
+    glUniform1i(glGetUniformLocation(mProgram, "grid"), GRID);
+    if (mVAOMap.find(pWindowId) == mVAOMap.end()) {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glEnableVertexAttribArray(mPointIndex);
+        glBindVertexArray(0);
+        mVAOMap[pWindowId] = vao;
+    }
+    glBindVertexArray(mVAOMap[pWindowId]);
+    CheckGL("End BoundsReduction::begin");
+}
+
+void BoundsReduction::end()
+{
+    CheckGL("Begin BoundsReduction::end");
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    cancel();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, mPBO);
+    for (int t=0; t<2; ++t) {
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + t);
+        glReadPixels(0, 0, GRID, GRID, GL_RGBA, GL_FLOAT,
+                     (GLvoid*)(t*4*GRID*GRID*sizeof(float)));
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBlendEquationSeparate(mBlendEquation[0], mBlendEquation[1]);
+    if (!mBlend)
+        glDisable(GL_BLEND);
+    if (mDepth)
+        glEnable(GL_DEPTH_TEST);
+    if (mScissor)
+        glEnable(GL_SCISSOR_TEST);
+    glViewport(mViewport[0], mViewport[1], mViewport[2], mViewport[3]);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mReadFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDrawFbo);
+    CheckGL("End BoundsReduction::end");
+}
+
+void BoundsReduction::cancel()
+{
+    if (mFence) {
+        glDeleteSync(mFence);
+        mFence = 0;
+    }
+}
+
+bool BoundsReduction::pending() const
+{
+    return mFence != 0;
+}
+
+bool BoundsReduction::result(unsigned pComponents, float* pMin, float* pMax)
+{
+    if (!mFence)
+        return false;
+    GLenum status = glClientWaitSync(mFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        return false;
+
+    CheckGL("Begin BoundsReduction::result");
+    cancel();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, mPBO);
+    const float* cells = (const float*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                        2*4*GRID*GRID*sizeof(float),
+                                                        GL_MAP_READ_BIT);
+    float* bounds[] = {pMin, pMax};
+    for (int t=0; t<2; ++t) {
+        for (unsigned c=0; c<pComponents; ++c) {
+            float v = std::numeric_limits<float>::infinity();
+            for (int i=0; i<GRID*GRID; ++i)
+                v = std::min(v, cells[4*(t*GRID*GRID + i) + c]);
+            bounds[t][c] = (t==0 ? v : -v);
+        }
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    CheckGL("End BoundsReduction::result");
+    return true;
+}
+
+}
@@ -0,0 +1,82 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <map>
+
+namespace internal
+{
+
+/* Writes the per component minimum and maximum of pCount tuples of
+ * pComponents (at most 3) values of type pType at pData to pMin and
+ * pMax. NaNs are skipped, components without any other value get +inf
+ * and -inf. Large inputs are split between threads, float data is
+ * reduced with AVX or NEON where the processor has it */
+void computeBounds(const void* pData, GLenum pType, unsigned pComponents,
+                   size_t pCount, float* pMin, float* pMax);
+
+/* Bounds of data that is in a buffer object only
+ *
+ * The tuples are drawn as points spread over a GRID x GRID target that
+ * keeps the minimum of the values and of their negation by blending.
+ * Between begin and end the caller draws the points with the attribute
+ * at pointIndex pointing at the data. end copies the target to a pixel
+ * buffer behind a fence, so the draw doesn't wait for the reduction, and
+ * result folds it on the CPU once the fence has passed, usually on a
+ * later frame. */
+class BoundsReduction {
+    public:
+        static const int GRID = 64;
+
+    private:
+        ProgramRef mProgram;
+        GLuint mFramebuffer;
+        GLuint mTextures[2];
+        GLuint mPointIndex;
+        GLuint mPBO;
+        /* set from end until the result is taken */
+        GLsync mFence;
+        std::map<int, GLuint> mVAOMap;
+
+        /* state restored by end */
+        GLint     mDrawFbo;
+        GLint     mReadFbo;
+        GLint     mViewport[4];
+        GLint     mBlendEquation[2];
+        GLboolean mScissor;
+        GLboolean mBlend;
+        GLboolean mDepth;
+
+        BoundsReduction(const BoundsReduction& other);
+        BoundsReduction& operator=(const BoundsReduction& other);
+
+    public:
+        BoundsReduction();
+        ~BoundsReduction();
+
+        GLuint pointIndex() const;
+
+        /* binds the target, the program and a vertex array for the window */
+        void begin(int pWindowId);
+        /* starts reading back the target, dropping an earlier
+         * result that wasn't taken yet */
+        void end();
+        /* drops the result that is being read back */
+        void cancel();
+        /* true while a result is being read back */
+        bool pending() const;
+        /* writes the bounds of the first pComponents components and
+         * returns true if the read back finished, false otherwise */
+        bool result(unsigned pComponents, float* pMin, float* pMax);
+};
+
+}
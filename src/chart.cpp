@@ -10,7 +10,9 @@
 #include <chart.hpp>
 #include <font.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 #include <mutex>
 
@@ -89,7 +91,63 @@ namespace internal
 
 /********************* BEGIN-AbstractChart *********************/
 
-void AbstractChart::renderTickLabels(int pWindowId, unsigned w, unsigned h,
+bool AbstractChart::textMeshStale(int pVPW, int pVPH)
+{
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    unsigned long long fontRevision = getChartFont()->revision();
+
+    if (mTextMeshLabelRevision==mLabelRevision && mTextMeshFontRevision==fontRevision &&
+        mTextMeshWidth==pVPW && mTextMeshHeight==pVPH &&
+        std::equal(viewport, viewport+4, mTextMeshViewport))
+        return false;
+
+    mTextMeshLabelRevision = mLabelRevision;
+    mTextMeshFontRevision  = fontRevision;
+    mTextMeshWidth         = pVPW;
+    mTextMeshHeight        = pVPH;
+    std::copy(viewport, viewport+4, mTextMeshViewport);
+    mTextMesh.clear();
+    return true;
+}
+
+int AbstractChart::generateTicks(float pMin, float pMax,
+                                 std::vector<std::string>& pTexts, float* pCoords) const
+{
+    char label[TICK_LABEL_SIZE];
+
+    double lo = std::min(pMin, pMax);
+    double hi = std::max(pMin, pMax);
+    double step = niceTickStep(lo, hi, mTickCount);
+
+    if (!(step > 0.0)) {
+        /* empty range, only its value is labelled */
+        TickFormat format = tickFormat(std::fabs(lo), 1.0e-2 * std::max(std::fabs(lo), 1.0));
+        pTexts.resize(1);
+        pTexts[0].assign(label, formatTick(label, lo, format));
+        pCoords[0] = 0.0f;
+        return 1;
+    }
+
+    double first = std::ceil(lo/step - 1.0e-6);
+    double last  = std::floor(hi/step + 1.0e-6);
+    int count    = std::min(int(last - first) + 1, mTickCount);
+
+    TickFormat format = tickFormat(std::max(std::fabs(first*step), std::fabs(last*step)), step);
+
+    /* strings keep their capacity, so relabelling
+     * doesn't allocate once the labels exist */
+    pTexts.resize(count);
+    for (int i=0; i<count; ++i) {
+        double value = (first + i) * step;
+        pTexts[i].assign(label, formatTick(label, value, format));
+        pCoords[i] = float(-1.0 + 2.0*(value - pMin)/(double(pMax) - pMin));
+    }
+    return count;
+}
+
+void AbstractChart::renderTickLabels(unsigned w, unsigned h,
         std::vector<std::string> &texts,
         glm::mat4 &transformation, int coor_offset,
         bool useZoffset)
@@ -121,7 +179,7 @@ void AbstractChart::renderTickLabels(int pWindowId, unsigned w, unsigned h,
         }else {
             pos[1] -= ((CHART2D_FONT_SIZE));
         }
-        fonter->render(pWindowId, pos, WHITE, it->c_str(), CHART2D_FONT_SIZE);
+        fonter->layout(pos, WHITE, it->c_str(), CHART2D_FONT_SIZE, false, mTextMesh);
     }
 }
 
@@ -131,12 +189,19 @@ AbstractChart::AbstractChart(int pLeftMargin, int pRightMargin, int pTopMargin,
       mTopMargin(pTopMargin), mBottomMargin(pBottomMargin),
       mXMax(1), mXMin(0), mYMax(1), mYMin(0), mZMax(1), mZMin(0),
       mXTitle("X-Axis"), mYTitle("Y-Axis"), mZTitle("Z-Axis"),
-      mDecorVBO(-1), mBorderProgram(-1), mSpriteProgram(-1),
+      mDecorVBO(-1), mBorderProgram(), mSpriteProgram(),
       mBorderAttribPointIndex(-1), mBorderUniformColorIndex(-1),
       mBorderUniformMatIndex(-1), mSpriteUniformMatIndex(-1),
-      mSpriteUniformTickcolorIndex(-1), mSpriteUniformTickaxisIndex(-1)
+      mSpriteUniformTickcolorIndex(-1), mSpriteUniformTickaxisIndex(-1),
+      mLabelRevision(nextRevision()), mTextMeshLabelRevision(0), mTextMeshFontRevision(0),
+      mTextMeshWidth(0), mTextMeshHeight(0),
+      mDataVBO(0), mDataSize(0), mDataCapacity(0), mMapped(false), mMapAccess(fg::FG_MAP_WRITE),
+      mAsync(std::make_shared<AsyncUpload>(this)), mDataRevision(nextRevision()),
+      mAutoAxes(false), mBoundsType(GL_FLOAT), mBoundsComponents(0),
+      mBoundsPending(false), mBoundsRevision(0), mBoundsCount(0)
 {
     CheckGL("Begin AbstractChart::AbstractChart");
+    std::fill(mTextMeshViewport, mTextMeshViewport+4, 0);
     /* load font Vera font for chart text
      * renderings, below function actually returns a constant
      * reference to font object used by Chart objects, we are
@@ -144,8 +209,8 @@ AbstractChart::AbstractChart(int pLeftMargin, int pRightMargin, int pTopMargin,
      * are loaded into the shared Font object */
     getChartFont();
 
-    mBorderProgram = initShaders(gChartVertexShaderSrc, gChartFragmentShaderSrc);
-    mSpriteProgram = initShaders(gChartVertexShaderSrc, gChartSpriteFragmentShaderSrc);
+    mBorderProgram = acquireProgram(gChartVertexShaderSrc, gChartFragmentShaderSrc);
+    mSpriteProgram = acquireProgram(gChartVertexShaderSrc, gChartSpriteFragmentShaderSrc);
 
     mBorderAttribPointIndex      = glGetAttribLocation (mBorderProgram, "point");
     mBorderUniformColorIndex     = glGetUniformLocation(mBorderProgram, "color");
@@ -161,23 +226,35 @@ AbstractChart::AbstractChart(int pLeftMargin, int pRightMargin, int pTopMargin,
 AbstractChart::~AbstractChart()
 {
     CheckGL("Begin AbstractChart::~AbstractChart");
+    /* jobs still queued for this chart no longer mark it modified */
+    mAsync->detach();
     for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
         GLuint vao = it->second;
         glDeleteVertexArrays(1, &vao);
     }
     glDeleteBuffers(1, &mDecorVBO);
-    glDeleteProgram(mBorderProgram);
-    glDeleteProgram(mSpriteProgram);
+    glDeleteBuffers(1, &mDataVBO);
+    releaseProgram(mBorderProgram);
+    releaseProgram(mSpriteProgram);
     CheckGL("End AbstractChart::~AbstractChart");
 }
 
 void AbstractChart::setAxesLimits(float pXmax, float pXmin,
                                   float pYmax, float pYmin,
                                   float pZmax, float pZmin)
+{
+    applyAxesLimits(pXmax, pXmin, pYmax, pYmin, pZmax, pZmin);
+    markDirty();
+}
+
+void AbstractChart::applyAxesLimits(float pXmax, float pXmin,
+                                    float pYmax, float pYmin,
+                                    float pZmax, float pZmin)
 {
     mXMax = pXmax; mXMin = pXmin;
     mYMax = pYmax; mYMin = pYmin;
     mZMax = pZmax; mZMin = pZmin;
+    mLabelRevision = nextRevision();
 
     /*
      * Once the axes ranges are known, we can generate
@@ -188,11 +265,365 @@ void AbstractChart::setAxesLimits(float pXmax, float pXmin,
     generateTickLabels();
 }
 
+void AbstractChart::setAutoAxes(bool pAuto)
+{
+    mAutoAxes = pAuto;
+    mAsync->setBoundsLayout(mBoundsType, (mAutoAxes ? mBoundsComponents : 0));
+    /* data already uploaded is reduced from the data buffer */
+    mBoundsRevision = 0;
+    markDirty();
+}
+
+void AbstractChart::setDataLayout(GLenum pType, unsigned pComponents)
+{
+    mBoundsType       = pType;
+    mBoundsComponents = pComponents;
+    mAsync->setBoundsLayout(mBoundsType, (mAutoAxes ? mBoundsComponents : 0));
+}
+
+size_t AbstractChart::boundsCount() const
+{
+    return mDataSize / (mBoundsComponents * gl_sizeof(mBoundsType));
+}
+
+void AbstractChart::applyDataBounds(const float* pMin, const float* pMax)
+{
+    /* axes of components without finite bounds keep their limits */
+    float lo[3] = {mXMin, mYMin, mZMin};
+    float hi[3] = {mXMax, mYMax, mZMax};
+    for (unsigned c=0; c<mBoundsComponents; ++c) {
+        if (std::isfinite(pMin[c]) && std::isfinite(pMax[c])) {
+            lo[c] = pMin[c];
+            hi[c] = pMax[c];
+        }
+    }
+    applyAxesLimits(hi[0], lo[0], hi[1], lo[1], hi[2], lo[2]);
+}
+
+void AbstractChart::setDataBounds()
+{
+    /* a reduction of older data must not overwrite these */
+    if (mBoundsReduction)
+        mBoundsReduction->cancel();
+    mBoundsPending  = true;
+    mBoundsRevision = dataRevision();
+    mBoundsCount    = boundsCount();
+}
+
+void AbstractChart::updateAutoAxes(int pWindowId)
+{
+    checkUnmapped("AbstractChart::render");
+    if (!mAutoAxes)
+        return;
+
+    receiveAsyncUpload();
+    size_t count = boundsCount();
+    if (mBoundsRevision != dataRevision() || mBoundsCount != count) {
+        /* the data changed without passing through the CPU */
+        CheckGL("Begin AbstractChart::updateAutoAxes");
+        if (count > 0) {
+            if (!mBoundsReduction)
+                mBoundsReduction.reset(new BoundsReduction());
+            mBoundsReduction->begin(pWindowId);
+            attachDataBuffer(mBoundsReduction->pointIndex(), mBoundsComponents, mBoundsType);
+            glDrawArrays(GL_POINTS, 0, GLsizei(count));
+            mBoundsReduction->end();
+            fenceDataBuffer();
+        } else if (mBoundsReduction) {
+            mBoundsReduction->cancel();
+        }
+        mBoundsRevision = dataRevision();
+        mBoundsCount    = count;
+        CheckGL("End AbstractChart::updateAutoAxes");
+    }
+    if (mBoundsReduction && mBoundsReduction->pending()) {
+        if (mBoundsReduction->result(mBoundsComponents, mBoundsMin, mBoundsMax))
+            mBoundsPending = true;
+        else
+            /* keeps windows drawing until the result is read back,
+             * meanwhile the chart is drawn with the previous limits */
+            markDirty();
+    }
+    if (mBoundsPending) {
+        applyDataBounds(mBoundsMin, mBoundsMax);
+        mBoundsPending = false;
+    }
+}
+
 void AbstractChart::setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle)
 {
     mXTitle = std::string(pXTitle);
     mYTitle = std::string(pYTitle);
     mZTitle = std::string(pZTitle);
+    mLabelRevision = nextRevision();
+    markDirty();
+}
+
+void AbstractChart::setStreaming(bool pStreaming)
+{
+    checkUnmapped("AbstractChart::setStreaming");
+    CheckGL("Begin AbstractChart::setStreaming");
+    flushDataUpdates();
+    if (pStreaming && !mStream) {
+        mStream.reset(new StreamBuffer(mDataCapacity, vbo()));
+    } else if (!pStreaming && mStream) {
+        /* keep the latest data */
+        mStream->copyTo(vbo());
+        mStream.reset();
+    }
+    markDirty();
+    CheckGL("End AbstractChart::setStreaming");
+}
+
+bool AbstractChart::streaming() const
+{
+    return bool(mStream);
+}
+
+void AbstractChart::upload(const void* pData)
+{
+    checkUnmapped("AbstractChart::upload");
+    CheckGL("Begin AbstractChart::upload");
+    if (mAutoAxes)
+        computeBounds(pData, mBoundsType, mBoundsComponents, boundsCount(), mBoundsMin, mBoundsMax);
+    /* the new data replaces any pending partial update */
+    mUpdates.clear();
+    if (mStream) {
+        memcpy(mStream->beginWrite(), pData, size());
+        mStream->endWrite();
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size(), pData);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    markDataChanged();
+    if (mAutoAxes)
+        setDataBounds();
+    CheckGL("End AbstractChart::upload");
+}
+
+void AbstractChart::update(const void* pData, size_t pOffset, size_t pSize)
+{
+    checkUnmapped("AbstractChart::update");
+    if (pOffset > size() || pSize > size() - pOffset)
+        throw fg::Error("AbstractChart::update", __LINE__,
+                        "Update range exceeds the data buffer", fg::FG_ERR_SIZE);
+    mUpdates.add(pOffset, pData, pSize);
+    markDataChanged();
+}
+
+void* AbstractChart::map(fg::MapAccess pAccess)
+{
+    if (mMapped)
+        throw fg::Error("AbstractChart::map", __LINE__,
+                        "Data buffer is already mapped", fg::FG_ERR_RUNTIME);
+
+    CheckGL("Begin AbstractChart::map");
+    void* ptr = NULL;
+    if (pAccess==fg::FG_MAP_WRITE) {
+        /* everything is rewritten, including pending partial updates */
+        mUpdates.clear();
+        if (mStream) {
+            ptr = mStream->beginWrite();
+        } else {
+            /* invalidation lets the driver hand out fresh storage
+             * instead of waiting for draws of the previous data */
+            glBindBuffer(GL_ARRAY_BUFFER, mDataVBO);
+            ptr = glMapBufferRange(GL_ARRAY_BUFFER, 0, mDataSize,
+                                   GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    } else {
+        /* streamed regions are mapped write only, the data is
+         * read and written through the data buffer instead */
+        flushDataUpdates();
+        if (mStream)
+            mStream->copyTo(mDataVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, mDataVBO);
+        ptr = glMapBufferRange(GL_ARRAY_BUFFER, 0, mDataSize, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    mMapped    = true;
+    mMapAccess = pAccess;
+    CheckGL("End AbstractChart::map");
+    return ptr;
+}
+
+void AbstractChart::unmap()
+{
+    if (!mMapped)
+        return;
+
+    CheckGL("Begin AbstractChart::unmap");
+    if (mStream && mMapAccess==fg::FG_MAP_WRITE) {
+        mStream->endWrite();
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, mDataVBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (mStream)
+            mStream->copyFrom(mDataVBO, mDataSize);
+    }
+    mMapped = false;
+    markDataChanged();
+    CheckGL("End AbstractChart::unmap");
+}
+
+const std::shared_ptr<AsyncUpload>& AbstractChart::asyncUpload() const
+{
+    return mAsync;
+}
+
+void AbstractChart::receiveAsyncUpload()
+{
+    size_t size = 0;
+    GLuint buffer = mAsync->receive(&size);
+    if (!buffer)
+        return;
+
+    CheckGL("Begin AbstractChart::receiveAsyncUpload");
+    size = std::min(size, mDataSize);
+    if (mStream) {
+        mStream->copyFrom(buffer, size);
+    } else {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mDataVBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    markDataChanged();
+    /* bounds computed by the upload thread cover all of the data */
+    if (mAutoAxes && size == boundsCount() * mBoundsComponents * gl_sizeof(mBoundsType) &&
+        mAsync->receivedBounds(mBoundsMin, mBoundsMax)) {
+        setDataBounds();
+    }
+    mAsync->endReceive();
+    CheckGL("End AbstractChart::receiveAsyncUpload");
+}
+
+void AbstractChart::markDataChanged()
+{
+    mDataRevision = nextRevision();
+    markDirty();
+}
+
+void AbstractChart::checkUnmapped(const char* pFunction) const
+{
+    if (mMapped)
+        throw fg::Error(pFunction, __LINE__,
+                        "Data buffer is mapped", fg::FG_ERR_RUNTIME);
+}
+
+void AbstractChart::flushDataUpdates()
+{
+    checkUnmapped("AbstractChart::flushDataUpdates");
+    if (mUpdates.empty())
+        return;
+
+    CheckGL("Begin AbstractChart::flushDataUpdates");
+    if (mStream) {
+        mStream->update(mUpdates);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo());
+        mUpdates.flush(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    CheckGL("End AbstractChart::flushDataUpdates");
+}
+
+void AbstractChart::createDataBuffer(size_t pSize)
+{
+    mDataVBO      = createBuffer<unsigned char>(GL_ARRAY_BUFFER, pSize, NULL, GL_DYNAMIC_DRAW);
+    mDataSize     = pSize;
+    mDataCapacity = pSize;
+    mAsync->setDataSize(pSize);
+}
+
+void AbstractChart::resizeDataBuffer(size_t pSize)
+{
+    checkUnmapped("AbstractChart::resizeDataBuffer");
+    CheckGL("Begin AbstractChart::resizeDataBuffer");
+    if (pSize > mDataCapacity) {
+        flushDataUpdates();
+
+        size_t capacity = std::max(pSize, 2*mDataCapacity);
+        GLuint buffer   = createBuffer<unsigned char>(GL_ARRAY_BUFFER, capacity, NULL, GL_DYNAMIC_DRAW);
+
+        /* keep the data, which is in the newest
+         * streamed region in streaming mode */
+        if (mStream) {
+            mStream->copyTo(buffer);
+        } else {
+            glBindBuffer(GL_COPY_READ_BUFFER, mDataVBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mDataSize);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &mDataVBO);
+        mDataVBO      = buffer;
+        mDataCapacity = capacity;
+
+        if (mStream)
+            mStream.reset(new StreamBuffer(mDataCapacity, mDataVBO));
+    }
+    mDataSize = pSize;
+    mAsync->setDataSize(pSize);
+    markDataChanged();
+    CheckGL("End AbstractChart::resizeDataBuffer");
+}
+
+GLuint AbstractChart::dataBuffer(size_t* pOffset)
+{
+    checkUnmapped("AbstractChart::dataBuffer");
+    receiveAsyncUpload();
+    flushDataUpdates();
+    *pOffset = (mStream ? mStream->drawOffset() : 0);
+    return (mStream ? mStream->buffer() : vbo());
+}
+
+void AbstractChart::attachDataBuffer(GLuint pIndex, GLint pComponents, GLenum pType)
+{
+    size_t offset = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, dataBuffer(&offset));
+    glVertexAttribPointer(pIndex, pComponents, pType, GL_FALSE, 0, reinterpret_cast<void*>(offset));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void AbstractChart::fenceDataBuffer()
+{
+    if (mStream)
+        mStream->fence();
+}
+
+void AbstractChart::dataBufferWritten()
+{
+    checkUnmapped("AbstractChart::dataBufferWritten");
+    mUpdates.clear();
+    if (mStream)
+        mStream->copyFrom(mDataVBO, mDataSize);
+    markDataChanged();
+}
+
+unsigned long long AbstractChart::dataRevision() const
+{
+    return mDataRevision;
+}
+
+GLenum AbstractChart::dataType() const
+{
+    return mBoundsType;
+}
+
+unsigned AbstractChart::dataComponents() const
+{
+    return mBoundsComponents;
+}
+
+size_t AbstractChart::dataCount() const
+{
+    return boundsCount();
 }
 
 float AbstractChart::xmax() const { return mXMax; }
@@ -249,55 +680,15 @@ void Chart2D::generateChartData()
     std::vector<float> decorData;
     std::copy(border, border+nValues, std::back_inserter(decorData));
 
-    float step = 2.0f/(mTickCount);
-    /* push tick points for y axis:
-     * push (0) first followed by
-     * [-1, 0) ticks and then
-     * (0, 1] ticks  */
-    int ticksLeft = mTickCount/2;
-    pushPoint(decorData, -1.0f, 0.0f);
-    pushTicktextCoords(-1.0f, 0.0f);
-    mYText.push_back(toString(0));
-
-    for(int i=1; i<=ticksLeft; ++i) {
-        /* [-1, 0) to [-1, -1] */
-        float neg = i*-step;
-        pushPoint(decorData, -1.0f, neg);
-        /* puch tick marks */
-        pushTicktextCoords(-1.0f, neg);
-        /* push tick text label */
-        mYText.push_back(toString(neg));
-
-        /* [-1, 0) to [-1, 1] */
-        float pos = i*step;
-        pushPoint(decorData, -1.0f, pos);
-        /* puch tick marks */
-        pushTicktextCoords(-1.0f, pos);
-        /* push tick text label */
-        mYText.push_back(toString(pos));
-    }
-
-    /* push tick points for x axis:
-     * push (0,0) first followed by
-     * [-1, 0) ticks and then
-     * (0, 1] ticks  */
-    pushPoint(decorData, 0.0f, -1.0f);
-    pushTicktextCoords(0.0f, -1.0f);
-    mXText.push_back(toString(0));
-
-    for(int i=1; i<=ticksLeft; ++i) {
-        /* (0, -1] to [-1, -1] */
-        float neg = i*-step;
-        pushPoint(decorData, neg, -1.0f);
-        pushTicktextCoords(neg, -1.0f);
-        mXText.push_back(toString(neg));
-
-        /* (0, -1] to [1, -1] */
-        float pos = i*step;
-        pushPoint(decorData, pos, -1.0f);
-        pushTicktextCoords(pos, -1.0f);
-        mXText.push_back(toString(pos));
+    /* reserve room for mTickCount tick marks on y axis followed
+     * by as many on x axis, generateTickLabels places them */
+    mTickTextX.clear();
+    mTickTextY.clear();
+    for (int i=0; i<2*mTickCount; ++i) {
+        pushPoint(decorData, -1.0f, -1.0f);
+        pushTicktextCoords(-1.0f, -1.0f);
     }
+    mDecorTicks.resize(2*2*mTickCount);
 
     /* check if decoration VBO has been already used(case where
      * tick marks are being changed from default(21) */
@@ -306,37 +697,35 @@ void Chart2D::generateChartData()
 
     /* create vbo that has the border and axis data */
     mDecorVBO = createBuffer<float>(GL_ARRAY_BUFFER, decorData.size(),
-                                    &(decorData.front()), GL_STATIC_DRAW);
+                                    &(decorData.front()), GL_DYNAMIC_DRAW);
+
+    generateTickLabels();
     CheckGL("End Chart2D::generateChartData");
 }
 
 void Chart2D::generateTickLabels()
 {
-    /* remove all the tick text markers that were generated
-     * by default during the base class(chart) creation and
-     * update the text markers based on the new axes limits
-     * */
-    mXText.clear();
-    mYText.clear();
-    mZText.clear();
-
-    float xstep = (mXMax-mXMin)/(mTickCount);
-    float ystep = (mYMax-mYMin)/(mTickCount);
-    float xmid = mXMin + (mXMax-mXMin)/2.0f;
-    float ymid = mYMin + (mYMax-mYMin)/2.0f;
-    int ticksLeft = mTickCount/2;
-    /* push tick points for y axis */
-    mYText.push_back(toString(ymid));
-    for (int i = 1; i <= ticksLeft; i++) {
-        mYText.push_back(toString(ymid + i*-ystep));
-        mYText.push_back(toString(ymid + i*ystep));
+    /* tick positions along y axis go to mTickTextY[0, mTickCount)
+     * and those along x axis to mTickTextX[mTickCount, 2*mTickCount) */
+    int yCount = generateTicks(mYMin, mYMax, mYText, &mTickTextY[0]);
+    int xCount = generateTicks(mXMin, mXMax, mXText, &mTickTextX[mTickCount]);
+
+    for (int i=0; i<yCount; ++i) {
+        mTickTextX[i] = -1.0f;
+        mDecorTicks[2*i+0] = -1.0f;
+        mDecorTicks[2*i+1] = mTickTextY[i];
     }
-    /* push tick points for x axis */
-    mXText.push_back(toString(xmid));
-    for (int i = 1; i <= ticksLeft; i++) {
-        mXText.push_back(toString(xmid + i*-xstep));
-        mXText.push_back(toString(xmid + i*xstep));
+    for (int i=mTickCount; i<mTickCount+xCount; ++i) {
+        mTickTextY[i] = -1.0f;
+        mDecorTicks[2*i+0] = mTickTextX[i];
+        mDecorTicks[2*i+1] = -1.0f;
     }
+
+    /* tick marks follow the four border vertices */
+    glBindBuffer(GL_ARRAY_BUFFER, mDecorVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 4*2*sizeof(float),
+                    mDecorTicks.size()*sizeof(float), &mDecorTicks.front());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Chart2D::renderChart(int pWindowId, int pX, int pY, int pVPW, int pVPH)
@@ -378,37 +767,42 @@ void Chart2D::renderChart(int pWindowId, int pX, int pY, int pVPW, int pVPH)
     glUniformMatrix4fv(mSpriteUniformMatIndex, 1, GL_FALSE, glm::value_ptr(trans));
     /* Draw tick marks on y axis */
     glUniform1i(mSpriteUniformTickaxisIndex, 1);
-    glDrawArrays(GL_POINTS, 4, mTickCount);
+    glDrawArrays(GL_POINTS, 4, GLsizei(mYText.size()));
     /* Draw tick marks on x axis */
     glUniform1i(mSpriteUniformTickaxisIndex, 0);
-    glDrawArrays(GL_POINTS, 4+mTickCount, mTickCount);
+    glDrawArrays(GL_POINTS, 4+mTickCount, GLsizei(mXText.size()));
 
     glUseProgram(0);
     glPointSize(1);
     Chart2D::unbindResources();
 
-    renderTickLabels(pWindowId, int(w), int(h), mYText, trans, 0, false);
-    renderTickLabels(pWindowId, int(w), int(h), mXText, trans, mTickCount, false);
-
     auto &fonter = getChartFont();
-    fonter->setOthro2D(int(w), int(h));
-    float pos[2];
-    /* render chart axes titles */
-    if (!mYTitle.empty()) {
-        glm::vec4 res = trans * glm::vec4(-1.0f, 0.0f, 0.0f, 1.0f);
-        pos[0] = w*(res.x+1.0f)/2.0f;
-        pos[1] = h*(res.y+1.0f)/2.0f;
-        pos[0] += (mTickSize * (w/pVPW));
-        fonter->render(pWindowId, pos, WHITE, mYTitle.c_str(), CHART2D_FONT_SIZE, true);
-    }
-    if (!mXTitle.empty()) {
-        glm::vec4 res = trans * glm::vec4(0.0f, -1.0f, 0.0f, 1.0f);
-        pos[0] = w*(res.x+1.0f)/2.0f;
-        pos[1] = h*(res.y+1.0f)/2.0f;
-        pos[1] += (mTickSize * (h/pVPH));
-        fonter->render(pWindowId, pos, WHITE, mXTitle.c_str(), CHART2D_FONT_SIZE);
+
+    if (textMeshStale(pVPW, pVPH)) {
+        renderTickLabels(int(w), int(h), mYText, trans, 0, false);
+        renderTickLabels(int(w), int(h), mXText, trans, mTickCount, false);
+
+        fonter->setOthro2D(int(w), int(h));
+        float pos[2];
+        /* render chart axes titles */
+        if (!mYTitle.empty()) {
+            glm::vec4 res = trans * glm::vec4(-1.0f, 0.0f, 0.0f, 1.0f);
+            pos[0] = w*(res.x+1.0f)/2.0f;
+            pos[1] = h*(res.y+1.0f)/2.0f;
+            pos[0] += (mTickSize * (w/pVPW));
+            fonter->layout(pos, WHITE, mYTitle.c_str(), CHART2D_FONT_SIZE, true, mTextMesh);
+        }
+        if (!mXTitle.empty()) {
+            glm::vec4 res = trans * glm::vec4(0.0f, -1.0f, 0.0f, 1.0f);
+            pos[0] = w*(res.x+1.0f)/2.0f;
+            pos[1] = h*(res.y+1.0f)/2.0f;
+            pos[1] += (mTickSize * (h/pVPH));
+            fonter->layout(pos, WHITE, mXTitle.c_str(), CHART2D_FONT_SIZE, false, mTextMesh);
+        }
     }
 
+    fonter->queue(pWindowId, mTextMesh);
+
     CheckGL("End Chart2D::renderChart");
 }
 
@@ -460,77 +854,16 @@ void Chart3D::generateChartData()
     std::vector<float> decorData;
     std::copy(border, border+nValues, std::back_inserter(decorData));
 
-    float step = 2.0f/(mTickCount);
-
-    /* push tick points for z axis:
-     * push (0,0) first followed by
-     * [-1, 0) ticks and then
-     * (0, 1] ticks  */
-    pushPoint(decorData, -1.0f, 1.0f, 0.0f);
-    pushTicktextCoords(-1.0f, 1.0f, 0.0f);
-    mZText.push_back(toString(0));
-
-    int ticksLeft = mTickCount/2;
-    for(int i=1; i<=ticksLeft; ++i) {
-        /* (0, -1] to [-1, -1] */
-        float neg = i*-step;
-        pushPoint(decorData, -1.0f, 1.0f, neg);
-        /* push tick marks */
-        pushTicktextCoords(-1.0f, 1.0f, neg);
-        /* push tick text label */
-        mZText.push_back(toString(neg));
-
-        /* (0, -1] to [1, -1] */
-        float pos = i*step;
-        pushPoint(decorData, -1.0f, 1.0f, pos);
-        /* push tick marks */
-        pushTicktextCoords(-1.0f, 1.0f, pos);
-        /* push tick text label */
-        mZText.push_back(toString(pos));
-    }
-    /* push tick points for y axis:
-     * push (0,0) first followed by
-     * [-1, 0) ticks and then
-     * (0, 1] ticks  */
-    pushPoint(decorData, -1.0f, 0.0f, -1.0f);
-    pushTicktextCoords(-1.0f, 0.0f, -1.0f);
-    mYText.push_back(toString(0));
-
-    for(int i=1; i<=ticksLeft; ++i) {
-        /* [-1, 0) to [-1, -1] */
-        float neg = i*-step;
-        float pos = i*step;
-        pushPoint(decorData, -1.0f, neg, -1.0f);
-        pushTicktextCoords(-1.0f, pos, -1.0f);
-        mYText.push_back(toString(neg));
-
-        /* [-1, 0) to [-1, 1] */
-        pushPoint(decorData, -1.0f, pos, -1.0f);
-        pushTicktextCoords(-1.0f, neg, -1.0f);
-        mYText.push_back(toString(pos));
-    }
-
-    /* push tick points for x axis:
-     * push (0,0) first followed by
-     * [-1, 0) ticks and then
-     * (0, 1] ticks  */
-    pushPoint(decorData, 0.0f, -1.0f, -1.0f);
-    pushTicktextCoords( 0.0f, -1.0f, -1.0f);
-    mXText.push_back(toString(0));
-
-    for(int i=1; i<=ticksLeft; ++i) {
-        /* (0, -1] to [-1, -1] */
-        float neg = i*-step;
-        pushPoint(decorData, neg, -1.0f, -1.0f);
-        pushTicktextCoords( neg, -1.0f, -1.0f);
-        mXText.push_back(toString(neg));
-
-        /* [-1, 0) to [-1, 1] */
-        float pos = i*step;
-        pushPoint(decorData, pos, -1.0f, -1.0f);
-        pushTicktextCoords( pos, -1.0f, -1.0f);
-        mXText.push_back(toString(pos));
+    /* reserve room for mTickCount tick marks on each of z, y
+     * and x axes in that order, generateTickLabels places them */
+    mTickTextX.clear();
+    mTickTextY.clear();
+    mTickTextZ.clear();
+    for (int i=0; i<3*mTickCount; ++i) {
+        pushPoint(decorData, -1.0f, -1.0f, -1.0f);
+        pushTicktextCoords(-1.0f, -1.0f, -1.0f);
     }
+    mDecorTicks.resize(3*3*mTickCount);
 
     /* check if decoration VBO has been already used(case where
      * tick marks are being changed from default(21) */
@@ -539,44 +872,44 @@ void Chart3D::generateChartData()
 
     /* create vbo that has the border and axis data */
     mDecorVBO = createBuffer<float>(GL_ARRAY_BUFFER, decorData.size(),
-                                    &(decorData.front()), GL_STATIC_DRAW);
+                                    &(decorData.front()), GL_DYNAMIC_DRAW);
+
+    generateTickLabels();
     CheckGL("End Chart3D::generateChartData");
 }
 
 void Chart3D::generateTickLabels()
 {
-    /* remove all the tick text markers that were generated
-     * by default during the base class(chart) creation and
-     * update the text markers based on the new axes limits*/
-    mXText.clear();
-    mYText.clear();
-    mZText.clear();
-
-    float xstep = (mXMax-mXMin)/(mTickCount);
-    float ystep = (mYMax-mYMin)/(mTickCount);
-    float zstep = (mZMax-mZMin)/(mTickCount);
-    float xmid = mXMin + (mXMax-mXMin)/2.0f;
-    float ymid = mYMin + (mYMax-mYMin)/2.0f;
-    float zmid = mZMin + (mZMax-mZMin)/2.0f;
-    int ticksLeft = mTickCount/2;
-    /* push tick points for z axis */
-    mZText.push_back(toString(zmid));
-    for (int i = 1; i <= ticksLeft; i++) {
-        mZText.push_back(toString(zmid + i*-zstep));
-        mZText.push_back(toString(zmid + i*zstep));
+    int zCount = generateTicks(mZMin, mZMax, mZText, &mTickTextZ[0]);
+    int yCount = generateTicks(mYMin, mYMax, mYText, &mTickTextY[mTickCount]);
+    int xCount = generateTicks(mXMin, mXMax, mXText, &mTickTextX[2*mTickCount]);
+
+    for (int i=0; i<zCount; ++i) {
+        mTickTextX[i] = -1.0f;
+        mTickTextY[i] =  1.0f;
     }
-    /* push tick points for y axis */
-    mYText.push_back(toString(ymid));
-    for (int i = 1; i <= ticksLeft; i++) {
-        mYText.push_back(toString(ymid + i*-ystep));
-        mYText.push_back(toString(ymid + i*ystep));
+    for (int i=mTickCount; i<mTickCount+yCount; ++i) {
+        /* y axis runs opposite to the chart's y coordinate
+         * after the model rotation used by renderChart */
+        mTickTextX[i] = -1.0f;
+        mTickTextY[i] = -mTickTextY[i];
+        mTickTextZ[i] = -1.0f;
     }
-    /* push tick points for x axis */
-    mXText.push_back(toString(xmid));
-    for (int i = 1; i <= ticksLeft; i++) {
-        mXText.push_back(toString(xmid + i*-xstep));
-        mXText.push_back(toString(xmid + i*xstep));
+    for (int i=2*mTickCount; i<2*mTickCount+xCount; ++i) {
+        mTickTextY[i] = -1.0f;
+        mTickTextZ[i] = -1.0f;
     }
+    for (int i=0; i<3*mTickCount; ++i) {
+        mDecorTicks[3*i+0] = mTickTextX[i];
+        mDecorTicks[3*i+1] = mTickTextY[i];
+        mDecorTicks[3*i+2] = mTickTextZ[i];
+    }
+
+    /* tick marks follow the six border vertices */
+    glBindBuffer(GL_ARRAY_BUFFER, mDecorVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 6*3*sizeof(float),
+                    mDecorTicks.size()*sizeof(float), &mDecorTicks.front());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Chart3D::renderChart(int pWindowId, int pX, int pY, int pVPW, int pVPH)
@@ -617,52 +950,57 @@ void Chart3D::renderChart(int pWindowId, int pX, int pY, int pVPW, int pVPH)
     glUniformMatrix4fv(mSpriteUniformMatIndex, 1, GL_FALSE, glm::value_ptr(trans));
     /* Draw tick marks on z axis */
     glUniform1i(mSpriteUniformTickaxisIndex, 1);
-    glDrawArrays(GL_POINTS, 6, mTickCount);
+    glDrawArrays(GL_POINTS, 6, GLsizei(mZText.size()));
     /* Draw tick marks on y axis */
     glUniform1i(mSpriteUniformTickaxisIndex, 0);
-    glDrawArrays(GL_POINTS, 6 + mTickCount, mTickCount);
+    glDrawArrays(GL_POINTS, 6 + mTickCount, GLsizei(mYText.size()));
     /* Draw tick marks on x axis */
     glUniform1i(mSpriteUniformTickaxisIndex, 0);
-    glDrawArrays(GL_POINTS, 6 + (2*mTickCount), mTickCount);
+    glDrawArrays(GL_POINTS, 6 + (2*mTickCount), GLsizei(mXText.size()));
 
     glUseProgram(0);
     glPointSize(1);
     glDisable(GL_PROGRAM_POINT_SIZE);
     Chart3D::unbindResources();
 
-    renderTickLabels(pWindowId, w, h, mZText, trans, 0);
-    renderTickLabels(pWindowId, w, h, mYText, trans, mTickCount);
-    renderTickLabels(pWindowId, w, h, mXText, trans, 2*mTickCount);
-
     auto &fonter = getChartFont();
-    fonter->setOthro2D(int(w), int(h));
-    float pos[2];
-    /* render chart axes titles */
-    if (!mZTitle.empty()) {
-        glm::vec4 res = trans * glm::vec4(-1.0f, 1.0f, 0.0f, 1.0f);
-        pos[0] = w*(res.x/res.w+1.0f)/2.0f;
-        pos[1] = h*(res.y/res.w+1.0f)/2.0f;
-        pos[0] -= 6*(mTickSize * (w/pVPW));
-        pos[1] += mZTitle.length()/2 * CHART2D_FONT_SIZE;
-        fonter->render(pWindowId, pos, WHITE, mZTitle.c_str(), CHART2D_FONT_SIZE, true);
-    }
-    if (!mYTitle.empty()) {
-        glm::vec4 res = trans * glm::vec4(-1.0f, 0.0f, -1.0f, 1.0f);
-        pos[0] = w*(res.x/res.w+1.0f)/2.0f;
-        pos[1] = h*(res.y/res.w+1.0f)/2.0f;
-        pos[0] -= 2*(mTickSize * (w/pVPW)) + mYTitle.length()/2 * CHART2D_FONT_SIZE;
-        pos[1] -= 3*(mTickSize * (h/pVPH));
-        fonter->render(pWindowId, pos, WHITE, mYTitle.c_str(), CHART2D_FONT_SIZE);
-    }
-    if (!mXTitle.empty()) {
-        glm::vec4 res = trans * glm::vec4(0.0f, -1.0f, -1.0f, 1.0f);
-        pos[0] = w*(res.x/res.w+1.0f)/2.0f;
-        pos[1] = h*(res.y/res.w+1.0f)/2.0f;
-        pos[0] += 3*(mTickSize * (w/pVPW));
-        pos[1] -= 3*(mTickSize * (h/pVPH));
-        fonter->render(pWindowId, pos, WHITE, mXTitle.c_str(), CHART2D_FONT_SIZE);
+
+    if (textMeshStale(pVPW, pVPH)) {
+        renderTickLabels(w, h, mZText, trans, 0);
+        renderTickLabels(w, h, mYText, trans, mTickCount);
+        renderTickLabels(w, h, mXText, trans, 2*mTickCount);
+
+        fonter->setOthro2D(int(w), int(h));
+        float pos[2];
+        /* render chart axes titles */
+        if (!mZTitle.empty()) {
+            glm::vec4 res = trans * glm::vec4(-1.0f, 1.0f, 0.0f, 1.0f);
+            pos[0] = w*(res.x/res.w+1.0f)/2.0f;
+            pos[1] = h*(res.y/res.w+1.0f)/2.0f;
+            pos[0] -= 6*(mTickSize * (w/pVPW));
+            pos[1] += mZTitle.length()/2 * CHART2D_FONT_SIZE;
+            fonter->layout(pos, WHITE, mZTitle.c_str(), CHART2D_FONT_SIZE, true, mTextMesh);
+        }
+        if (!mYTitle.empty()) {
+            glm::vec4 res = trans * glm::vec4(-1.0f, 0.0f, -1.0f, 1.0f);
+            pos[0] = w*(res.x/res.w+1.0f)/2.0f;
+            pos[1] = h*(res.y/res.w+1.0f)/2.0f;
+            pos[0] -= 2*(mTickSize * (w/pVPW)) + mYTitle.length()/2 * CHART2D_FONT_SIZE;
+            pos[1] -= 3*(mTickSize * (h/pVPH));
+            fonter->layout(pos, WHITE, mYTitle.c_str(), CHART2D_FONT_SIZE, false, mTextMesh);
+        }
+        if (!mXTitle.empty()) {
+            glm::vec4 res = trans * glm::vec4(0.0f, -1.0f, -1.0f, 1.0f);
+            pos[0] = w*(res.x/res.w+1.0f)/2.0f;
+            pos[1] = h*(res.y/res.w+1.0f)/2.0f;
+            pos[0] += 3*(mTickSize * (w/pVPW));
+            pos[1] -= 3*(mTickSize * (h/pVPH));
+            fonter->layout(pos, WHITE, mXTitle.c_str(), CHART2D_FONT_SIZE, false, mTextMesh);
+        }
     }
 
+    fonter->queue(pWindowId, mTextMesh);
+
     CheckGL("End Chart3D::renderChart");
 }
 
@@ -10,9 +10,12 @@
 #pragma once
 
 #include <common.hpp>
+#include <bounds.hpp>
+#include <streambuffer.hpp>
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <glm/glm.hpp>
 
@@ -47,8 +50,8 @@ class AbstractChart : public AbstractRenderable {
         std::string mZTitle;
         /* OpenGL Objects */
         GLuint     mDecorVBO;
-        GLuint     mBorderProgram;
-        GLuint     mSpriteProgram;
+        ProgramRef mBorderProgram;
+        ProgramRef mSpriteProgram;
         /* shader uniform variable locations */
         GLint     mBorderAttribPointIndex;
         GLint     mBorderUniformColorIndex;
@@ -60,8 +63,105 @@ class AbstractChart : public AbstractRenderable {
          * for each valid window context */
         std::map<int, GLuint> mVAOMap;
 
+        /* tick labels and axes titles laid out as glyph quads of the
+         * chart font. The layout is reused across frames until the
+         * labels, the viewport or the font change */
+        std::vector<float> mTextMesh;
+        unsigned long long mLabelRevision;
+        unsigned long long mTextMeshLabelRevision;
+        unsigned long long mTextMeshFontRevision;
+        GLint              mTextMeshViewport[4];
+        int                mTextMeshWidth;
+        int                mTextMeshHeight;
+
+        /* buffer holding the data of the chart, mDataSize bytes of
+         * which are in use. Capacity grows geometrically on resize */
+        GLuint        mDataVBO;
+        size_t        mDataSize;
+        size_t        mDataCapacity;
+        /* storage of data in streaming mode */
+        std::unique_ptr<StreamBuffer> mStream;
+        /* partial data updates not yet written to the data buffer */
+        BufferUpdates mUpdates;
+        /* set between map and unmap */
+        bool          mMapped;
+        fg::MapAccess mMapAccess;
+        /* data written by upload threads */
+        std::shared_ptr<AsyncUpload> mAsync;
+        /* changes with the data only, unlike the revision, which
+         * changes with every setting that affects the output */
+        unsigned long long mDataRevision;
+
+        /* axes limits following the data, whose tuples are
+         * mBoundsComponents values of type mBoundsType. Bounds
+         * computed while the data passed through the CPU are
+         * valid for the data revision mBoundsRevision and
+         * mBoundsCount tuples, otherwise the data buffer is
+         * reduced on the GPU and the limits follow once the
+         * result has been read back */
+        bool          mAutoAxes;
+        GLenum        mBoundsType;
+        unsigned      mBoundsComponents;
+        float         mBoundsMin[3];
+        float         mBoundsMax[3];
+        bool          mBoundsPending;
+        unsigned long long mBoundsRevision;
+        size_t        mBoundsCount;
+        std::unique_ptr<BoundsReduction> mBoundsReduction;
+
+        /* marks the chart as modified by a change of its data */
+        void markDataChanged();
+        /* throws if the data buffer is mapped, pFunction names the caller */
+        void checkUnmapped(const char* pFunction) const;
+        /* writes the pending partial updates to the data buffer */
+        void flushDataUpdates();
+        /* copies data published by upload threads to the data buffer */
+        void receiveAsyncUpload();
+
+        /* allocates the data buffer, called by constructors of charts */
+        void createDataBuffer(size_t pSize);
+        /* sets the number of bytes of data in use, the data buffer is
+         * reallocated only if its capacity is exceeded. Data up to the
+         * smaller of the old and the new size is kept */
+        void resizeDataBuffer(size_t pSize);
+
+        /* declares the tuples of the data, called by constructors of charts */
+        void setDataLayout(GLenum pType, unsigned pComponents);
+        /* number of tuples whose bounds set the axes limits */
+        virtual size_t boundsCount() const;
+        /* sets the axes limits from per component bounds of the data,
+         * components map to x, y and z by default */
+        virtual void applyDataBounds(const float* pMin, const float* pMax);
+        /* marks mBoundsMin and mBoundsMax, computed on the CPU,
+         * as the bounds of the current data */
+        void setDataBounds();
+        /* applies the bounds of new data if automatic axes are
+         * enabled, to be called first thing by render. Throws
+         * if the data buffer is mapped */
+        void updateAutoAxes(int pWindowId);
+
+        /* points attribute pIndex of the bound vertex array at dataBuffer */
+        void attachDataBuffer(GLuint pIndex, GLint pComponents, GLenum pType);
+        /* scratch space for the tick mark vertices */
+        std::vector<float> mDecorTicks;
+
+        /* labels the ticks of an axis spanning [pMin, pMax] and
+         * returns their count, at most mTickCount. The positions of
+         * ticks mapped to [-1, 1] are written to pCoords */
+        int generateTicks(float pMin, float pMax,
+                          std::vector<std::string>& pTexts, float* pCoords) const;
+
+        /* setAxesLimits without marking the chart as modified, for
+         * limits that follow data whose update already did so */
+        void applyAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin,
+                             float pZmax, float pZmin);
+
+        /* returns true if mTextMesh has to be laid out again
+         * for the current viewport and records the new key */
+        bool textMeshStale(int pViewPortWidth, int pViewPortHeight);
+
         /* rendering helper functions */
-        void renderTickLabels(int pWindowId, unsigned w, unsigned h,
+        void renderTickLabels(unsigned w, unsigned h,
                 std::vector<std::string> &texts,
                 glm::mat4 &transformation, int coor_offset,
                 bool useZoffset=true);
@@ -81,6 +181,43 @@ class AbstractChart : public AbstractRenderable {
         void setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin,
                            float pZmax=1, float pZmin=-1);
         void setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle="Z-Axis");
+        /* sets the axes limits from the data whenever it changes */
+        void setAutoAxes(bool pAuto);
+
+        /* in streaming mode data uploads don't
+         * wait for draws of earlier data */
+        void setStreaming(bool pStreaming);
+        bool streaming() const;
+        /* copies size() bytes from pData to the data buffer */
+        void upload(const void* pData);
+        /* copies pSize bytes from pData to the data buffer at byte
+         * offset pOffset. Updates are written before the next draw,
+         * those of a frame that overlap or touch are merged */
+        void update(const void* pData, size_t pOffset, size_t pSize);
+        /* returns a pointer to size() bytes of the data, which
+         * are written to the data buffer by unmap. FG_MAP_WRITE
+         * discards the previous data and doesn't synchronize */
+        void* map(fg::MapAccess pAccess);
+        void unmap();
+        /* target of upload thread jobs */
+        const std::shared_ptr<AsyncUpload>& asyncUpload() const;
+
+        /* returns the buffer draws read the data from, the newest streamed
+         * region in streaming mode, and the byte offset of the data in it.
+         * Uploaded data and pending partial updates are written first */
+        GLuint dataBuffer(size_t* pOffset);
+        /* to be called after the draws that read the data buffer */
+        void fenceDataBuffer();
+        /* to be called after the data buffer was written in full on the
+         * GPU, drops pending partial updates and streams the new data */
+        void dataBufferWritten();
+        /* revision of the data, for what is derived from it */
+        unsigned long long dataRevision() const;
+        /* type and components of the tuples of the data,
+         * and the number of tuples that are drawn */
+        GLenum   dataType() const;
+        unsigned dataComponents() const;
+        size_t   dataCount() const;
 
         float xmax() const;
         float xmin() const;
@@ -11,114 +11,70 @@
 #include <colormap.hpp>
 #include <cmap.hpp>
 
-#define CREATE_UNIFORM_BUFFER(color_array, size)  \
-    createBuffer(GL_UNIFORM_BUFFER, 4*size, color_array, GL_STATIC_DRAW)
+#define ADD_COLORMAP(color_array) \
+    add(color_array, (unsigned)(sizeof(color_array)/(4*sizeof(float))))
 
 namespace internal
 {
 
 colormap_impl::colormap_impl()
-    :mDefaultMapBuffer(0), mSpecMapBuffer(0), mColorsMapBuffer(0),
-    mRedMapBuffer(0), mMoodMapBuffer(0), mHeatMapBuffer(0),
-    mBlueMapBuffer(0)
 {
-    size_t channel_bytes = sizeof(float)*4; /* 4 is for 4 channels */
-    mDefMapLen  = (GLuint)(sizeof(cmap_default) /channel_bytes);
-    mSpecMapLen = (GLuint)(sizeof(cmap_spectrum)/channel_bytes);
-    mColsMapLen = (GLuint)(sizeof(cmap_colors)  /channel_bytes);
-    mRedMapLen  = (GLuint)(sizeof(cmap_red)     /channel_bytes);
-    mMoodMapLen = (GLuint)(sizeof(cmap_mood)    /channel_bytes);
-    mHeatMapLen = (GLuint)(sizeof(cmap_heat)    /channel_bytes);
-    mBlueMapLen = (GLuint)(sizeof(cmap_blue)    /channel_bytes);
-
-    mDefaultMapBuffer = CREATE_UNIFORM_BUFFER(cmap_default, mDefMapLen);
-    mSpecMapBuffer    = CREATE_UNIFORM_BUFFER(cmap_spectrum, mSpecMapLen);
-    mColorsMapBuffer  = CREATE_UNIFORM_BUFFER(cmap_colors, mColsMapLen);
-    mRedMapBuffer     = CREATE_UNIFORM_BUFFER(cmap_red, mRedMapLen);
-    mMoodMapBuffer    = CREATE_UNIFORM_BUFFER(cmap_mood, mMoodMapLen);
-    mHeatMapBuffer    = CREATE_UNIFORM_BUFFER(cmap_heat, mHeatMapLen);
-    mBlueMapBuffer    = CREATE_UNIFORM_BUFFER(cmap_blue, mBlueMapLen);
+    /* same order as fg::ColorMap */
+    ADD_COLORMAP(cmap_default);
+    ADD_COLORMAP(cmap_spectrum);
+    ADD_COLORMAP(cmap_colors);
+    ADD_COLORMAP(cmap_red);
+    ADD_COLORMAP(cmap_mood);
+    ADD_COLORMAP(cmap_heat);
+    ADD_COLORMAP(cmap_blue);
 }
 
 colormap_impl::~colormap_impl()
 {
-    glDeleteBuffers(1, &mDefaultMapBuffer);
-    glDeleteBuffers(1, &mSpecMapBuffer);
-    glDeleteBuffers(1, &mColorsMapBuffer);
-    glDeleteBuffers(1, &mRedMapBuffer);
-    glDeleteBuffers(1, &mMoodMapBuffer);
-    glDeleteBuffers(1, &mHeatMapBuffer);
-    glDeleteBuffers(1, &mBlueMapBuffer);
-}
-
-GLuint colormap_impl::defaultMap() const
-{
-    return mDefaultMapBuffer;
-}
-
-GLuint colormap_impl::spectrum() const
-{
-    return mSpecMapBuffer;
-}
-
-GLuint colormap_impl::colors() const
-{
-    return mColorsMapBuffer;
-}
-
-GLuint colormap_impl::red() const
-{
-    return mRedMapBuffer;
-}
-
-GLuint colormap_impl::mood() const
-{
-    return mMoodMapBuffer;
-}
-
-GLuint colormap_impl::heat() const
-{
-    return mHeatMapBuffer;
-}
-
-GLuint colormap_impl::blue() const
-{
-    return mBlueMapBuffer;
+    for (size_t i=0; i<mMaps.size(); ++i)
+        glDeleteTextures(1, &mMaps[i].mTexture);
 }
 
-GLuint colormap_impl::defaultLen() const
+unsigned colormap_impl::add(const float* pRGBA, unsigned pLength)
 {
-    return mDefMapLen;
-}
+    if (pRGBA==NULL)
+        throw fg::ArgumentError("Window::addColorMap", __LINE__, 1,
+                                "Colors have to be given");
 
-GLuint colormap_impl::spectrumLen() const
-{
-    return mSpecMapLen;
-}
+    GLint maxLength = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxLength);
+    if (pLength==0 || pLength > (unsigned)maxLength)
+        throw fg::ArgumentError("Window::addColorMap", __LINE__, 2,
+                                "Length has to be positive and within the texture size limit");
 
-GLuint colormap_impl::colorsLen() const
-{
-    return mColsMapLen;
-}
+    CheckGL("Begin colormap_impl::add");
+    Map map = {0, pLength};
+    glGenTextures(1, &map.mTexture);
+    glBindTexture(GL_TEXTURE_1D, map.mTexture);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, pLength, 0, GL_RGBA, GL_FLOAT, pRGBA);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    CheckGL("End colormap_impl::add");
 
-GLuint colormap_impl::redLen() const
-{
-    return mRedMapLen;
+    mMaps.push_back(map);
+    return (unsigned)mMaps.size() - 1;
 }
 
-GLuint colormap_impl::moodLen() const
+unsigned colormap_impl::count() const
 {
-    return mMoodMapLen;
+    return (unsigned)mMaps.size();
 }
 
-GLuint colormap_impl::heatLen() const
+GLuint colormap_impl::texture(unsigned pMap) const
 {
-    return mHeatMapLen;
+    return mMaps[pMap].mTexture;
 }
 
-GLuint colormap_impl::blueLen() const
+GLuint colormap_impl::length(unsigned pMap) const
 {
-    return mBlueMapLen;
+    return mMaps[pMap].mLength;
 }
 
 }
@@ -11,61 +11,38 @@
 
 #include <common.hpp>
 #include <memory>
+#include <vector>
 
 namespace internal
 {
 
+/* Colormaps stored as one dimensional RGBA textures
+ *
+ * Shaders sample them with linear filtering, so maps of any length
+ * interpolate smoothly between their colors. The maps of fg::ColorMap
+ * are created first, in the order of the enumeration, hence their
+ * identifiers are the enumeration values. Maps added later follow. */
 class colormap_impl {
     private:
-        /*
-         * READ THIS BEFORE ADDING NEW COLORMAP
-         *
-         * each of the following buffers will point
-         * to the data from floating point arrays
-         * defined in cmap.hpp header. Currently,
-         * the largest colormap is 506 colors(1520 floats).
-         * Hence the shader of internal::image_impl uses
-         * uniform array of floats with size 1536 (512 color triplets).
-         * when a new colormap is added, make sure
-         * the size of array declared in the shaders
-         * used by *_impl objects to reflect appropriate
-         * size */
-        GLuint mDefaultMapBuffer;
-        GLuint mSpecMapBuffer;
-        GLuint mColorsMapBuffer;
-        GLuint mRedMapBuffer;
-        GLuint mMoodMapBuffer;
-        GLuint mHeatMapBuffer;
-        GLuint mBlueMapBuffer;
-        /* Current color map lengths */
-        GLuint mDefMapLen;
-        GLuint mSpecMapLen;
-        GLuint mColsMapLen;
-        GLuint mRedMapLen;
-        GLuint mMoodMapLen;
-        GLuint mHeatMapLen;
-        GLuint mBlueMapLen;
+        struct Map {
+            GLuint mTexture;
+            GLuint mLength;
+        };
+
+        std::vector<Map> mMaps;
 
     public:
         /* constructors and destructors */
         colormap_impl();
         ~colormap_impl();
 
-        GLuint defaultMap() const;
-        GLuint spectrum() const;
-        GLuint colors() const;
-        GLuint red() const;
-        GLuint mood() const;
-        GLuint heat() const;
-        GLuint blue() const;
+        /* creates a map of pLength colors, four floats each,
+         * from pRGBA and returns its identifier */
+        unsigned add(const float* pRGBA, unsigned pLength);
 
-        GLuint defaultLen() const;
-        GLuint spectrumLen() const;
-        GLuint colorsLen() const;
-        GLuint redLen() const;
-        GLuint moodLen() const;
-        GLuint heatLen() const;
-        GLuint blueLen() const;
+        unsigned count() const;
+        GLuint texture(unsigned pMap) const;
+        GLuint length(unsigned pMap) const;
 };
 
 }
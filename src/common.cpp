@@ -8,13 +8,19 @@
  ********************************************************/
 
 #include <common.hpp>
+#include <shadercache.hpp>
 #include <window.hpp>
 
+#include <algorithm>
 #include <iostream>
-#include <iomanip>
 #include <fstream>
-#include <sstream>
 #include <cmath>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
 
 using namespace fg;
 using namespace std;
@@ -37,6 +43,19 @@ GLenum gl_dtype(fg::dtype val)
     }
 }
 
+size_t gl_sizeof(GLenum val)
+{
+    switch(val) {
+        case GL_BYTE:           return sizeof(char);
+        case GL_UNSIGNED_BYTE:  return sizeof(unsigned char);
+        case GL_INT:            return sizeof(int);
+        case GL_UNSIGNED_INT:   return sizeof(unsigned);
+        case GL_SHORT:          return sizeof(short);
+        case GL_UNSIGNED_SHORT: return sizeof(unsigned short);
+        default:                return sizeof(float);
+    }
+}
+
 GLenum gl_ctype(ChannelFormat mode)
 {
     switch(mode) {
@@ -61,6 +80,33 @@ GLenum gl_ictype(ChannelFormat mode)
         return GL_RGBA;
 }
 
+GLenum gl_ictype(ChannelFormat mode, fg::dtype val)
+{
+    static const GLenum formats[][4] = {
+        {GL_R8,       GL_RG8,       GL_RGB8,       GL_RGBA8      },
+        {GL_R8_SNORM, GL_RG8_SNORM, GL_RGB8_SNORM, GL_RGBA8_SNORM},
+        {GL_R16,      GL_RG16,      GL_RGB16,      GL_RGBA16     },
+        {GL_R16_SNORM,GL_RG16_SNORM,GL_RGB16_SNORM,GL_RGBA16_SNORM},
+        {GL_R32F,     GL_RG32F,     GL_RGB32F,     GL_RGBA32F    }
+    };
+
+    int channels = 3;
+    switch(mode) {
+        case FG_GRAYSCALE: channels = 0; break;
+        case FG_RG       : channels = 1; break;
+        case FG_RGB      :
+        case FG_BGR      : channels = 2; break;
+        default          : channels = 3; break;
+    }
+    switch(val) {
+        case u8:  return formats[0][channels];
+        case s8:  return formats[1][channels];
+        case u16: return formats[2][channels];
+        case s16: return formats[3][channels];
+        default:  return formats[4][channels];
+    }
+}
+
 char* loadFile(const char * fname, GLint &fSize)
 {
     std::ifstream file(fname,std::ios::in|std::ios::binary|std::ios::ate);
@@ -171,12 +217,262 @@ shaders_t loadShaders(const char * vert_code, const char * frag_code)
 
 GLuint initShaders(const char* vshader_code, const char* fshader_code)
 {
+    GLuint shader_program = loadCachedProgram(vshader_code, fshader_code);
+    if (shader_program)
+        return shader_program;
+
+    bool cacheable = programCacheEnabled();
+
     shaders_t shaders = loadShaders(vshader_code, fshader_code);
-    GLuint shader_program = glCreateProgram();
+    shader_program = glCreateProgram();
+    if (cacheable)
+        glProgramParameteri(shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     attachAndLinkProgram(shader_program, shaders);
+    /* shader objects are not needed once the program is linked */
+    glDetachShader(shader_program, shaders.vertex);
+    glDetachShader(shader_program, shaders.fragment);
+    glDeleteShader(shaders.vertex);
+    glDeleteShader(shaders.fragment);
+
+    if (cacheable)
+        storeCachedProgram(shader_program, vshader_code, fshader_code);
+
+    return shader_program;
+}
+
+GLuint initComputeShader(const char* cshader_code)
+{
+    /* cached by the compute source alone */
+    GLuint shader_program = loadCachedProgram(cshader_code, "");
+    if (shader_program)
+        return shader_program;
+
+    bool cacheable = programCacheEnabled();
+
+    GLuint c = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(c, 1, &cshader_code, NULL);
+    glCompileShader(c);
+    GLint compiled;
+    glGetShaderiv(c, GL_COMPILE_STATUS, &compiled);
+    if (!compiled)
+    {
+        std::cerr << "Compute shader not compiled." << std::endl;
+        printShaderInfoLog(c);
+    }
+
+    shader_program = glCreateProgram();
+    if (cacheable)
+        glProgramParameteri(shader_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(shader_program, c);
+    glLinkProgram(shader_program);
+    GLint linked;
+    glGetProgramiv(shader_program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        std::cerr << "Program did not link." << std::endl;
+        throw fg::Error("initComputeShader", __LINE__, "OpenGL program linking failed", FG_ERR_GL_ERROR);
+    }
+    printLinkInfoLog(shader_program);
+    glDetachShader(shader_program, c);
+    glDeleteShader(c);
+
+    if (cacheable)
+        storeCachedProgram(shader_program, cshader_code, "");
+
     return shader_program;
 }
 
+struct ProgramEntry {
+    std::string mVertexSource;
+    std::string mFragmentSource;
+    GLuint      mProgram;
+    int         mRefCount;
+};
+
+typedef std::map<ProgramKey, ProgramEntry> ProgramMap;
+
+static ProgramMap& programRegistry()
+{
+    static ProgramMap registry;
+    return registry;
+}
+
+/* programs released while a context of another group was current */
+typedef std::map<GLEWContext*, std::vector<GLuint> > PendingDeleteMap;
+
+static PendingDeleteMap& pendingProgramDeletes()
+{
+    static PendingDeleteMap pending;
+    return pending;
+}
+
+/* deletes pProgram of pGroup now if pGroup is current, otherwise once it
+ * is, by deletePendingPrograms. Needs the registry mutex */
+static void deleteProgram(GLEWContext* pGroup, GLuint pProgram)
+{
+    if (pGroup == glewGetContext())
+        glDeleteProgram(pProgram);
+    else
+        pendingProgramDeletes()[pGroup].push_back(pProgram);
+}
+
+static void deletePendingPrograms()
+{
+    PendingDeleteMap& pending = pendingProgramDeletes();
+    PendingDeleteMap::iterator it = pending.find(glewGetContext());
+    if (it == pending.end())
+        return;
+    for (size_t i=0; i<it->second.size(); ++i)
+        glDeleteProgram(it->second[i]);
+    pending.erase(it);
+}
+
+static std::mutex& programRegistryMutex()
+{
+    static std::mutex registryMutex;
+    return registryMutex;
+}
+
+static size_t hashSources(const char* vshader_code, const char* fshader_code)
+{
+    std::hash<std::string> hasher;
+    size_t vh = hasher(vshader_code);
+    size_t fh = hasher(fshader_code);
+    return vh ^ (fh + 0x9e3779b9 + (vh << 6) + (vh >> 2));
+}
+
+/* compute programs are registered with their source in place of
+ * the vertex shader and an empty fragment shader, which can't be
+ * mistaken for a vertex and fragment shader pair */
+static ProgramRef acquireSharedProgram(const char* vshader_code, const char* fshader_code)
+{
+    std::lock_guard<std::mutex> lock(programRegistryMutex());
+    deletePendingPrograms();
+
+    bool compute = (fshader_code[0] == '\0');
+    ProgramMap& registry = programRegistry();
+
+    ProgramRef ref;
+    ref.mKey    = ProgramKey(glewGetContext(), hashSources(vshader_code, fshader_code));
+    ref.mShared = true;
+
+    ProgramMap::iterator it = registry.find(ref.mKey);
+    if (it != registry.end()) {
+        ProgramEntry& entry = it->second;
+        if (entry.mVertexSource==vshader_code && entry.mFragmentSource==fshader_code) {
+            entry.mRefCount++;
+            ref.mProgram = entry.mProgram;
+            return ref;
+        }
+        /* hash collision, such a program is not shared */
+        ref.mProgram = (compute ? initComputeShader(vshader_code)
+                                : initShaders(vshader_code, fshader_code));
+        ref.mShared  = false;
+        return ref;
+    }
+
+    ProgramEntry entry;
+    entry.mVertexSource   = vshader_code;
+    entry.mFragmentSource = fshader_code;
+    entry.mProgram        = (compute ? initComputeShader(vshader_code)
+                                     : initShaders(vshader_code, fshader_code));
+    entry.mRefCount       = 1;
+    registry[ref.mKey] = entry;
+
+    ref.mProgram = entry.mProgram;
+    return ref;
+}
+
+ProgramRef acquireProgram(const char* vshader_code, const char* fshader_code)
+{
+    return acquireSharedProgram(vshader_code, fshader_code);
+}
+
+ProgramRef acquireComputeProgram(const char* cshader_code)
+{
+    return acquireSharedProgram(cshader_code, "");
+}
+
+void releaseProgram(ProgramRef& pProgram)
+{
+    if (pProgram.mProgram == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(programRegistryMutex());
+    deletePendingPrograms();
+
+    GLEWContext* group = pProgram.mKey.first;
+    if (!pProgram.mShared) {
+        deleteProgram(group, pProgram.mProgram);
+    } else {
+        ProgramMap& registry = programRegistry();
+        ProgramMap::iterator it = registry.find(pProgram.mKey);
+        if (it != registry.end() && --it->second.mRefCount == 0) {
+            deleteProgram(group, it->second.mProgram);
+            registry.erase(it);
+        }
+    }
+    pProgram = ProgramRef();
+}
+
+namespace internal
+{
+
+unsigned long long nextRevision()
+{
+    static std::atomic<unsigned long long> revision(0);
+    return ++revision;
+}
+
+void BufferUpdates::add(size_t pOffset, const void* pData, size_t pSize)
+{
+    if (pSize==0)
+        return;
+
+    size_t begin = pOffset;
+    size_t end   = pOffset + pSize;
+
+    /* find the ranges that overlap or touch [begin, end) */
+    auto first = mRanges.upper_bound(begin);
+    if (first!=mRanges.begin()) {
+        auto prev = std::prev(first);
+        if (prev->first + prev->second.size() >= begin)
+            first = prev;
+    }
+    auto last = first;
+    size_t mergedBegin = begin;
+    size_t mergedEnd   = end;
+    for (; last!=mRanges.end() && last->first<=end; ++last) {
+        mergedBegin = std::min(mergedBegin, last->first);
+        mergedEnd   = std::max(mergedEnd, last->first + last->second.size());
+    }
+
+    const unsigned char* bytes = (const unsigned char*)pData;
+    if (first==last) {
+        mRanges[begin].assign(bytes, bytes+pSize);
+        return;
+    }
+
+    std::vector<unsigned char> merged(mergedEnd - mergedBegin);
+    for (auto it=first; it!=last; ++it)
+        std::copy(it->second.begin(), it->second.end(), merged.begin() + (it->first - mergedBegin));
+    std::copy(bytes, bytes+pSize, merged.begin() + (begin - mergedBegin));
+
+    mRanges.erase(first, last);
+    mRanges[mergedBegin].swap(merged);
+}
+
+void BufferUpdates::flush(GLenum pTarget, size_t pBase)
+{
+    for (auto it=mRanges.begin(); it!=mRanges.end(); ++it) {
+        glBufferSubData(pTarget, GLintptr(pBase + it->first),
+                        GLsizeiptr(it->second.size()), it->second.data());
+    }
+    mRanges.clear();
+}
+
+}
+
 int next_p2(int value)
 {
     return int(std::pow(2, (std::ceil(std::log2(value)))));
@@ -248,10 +544,3 @@ void getFontFilePaths(std::vector<std::string>& pFiles, std::string pDir, std::s
    FindClose(hFind);
 }
 #endif
-
-std::string toString(float pVal, const int n)
-{
-    std::ostringstream out;
-    out << std::fixed << std::setprecision(n) << pVal;
-    return out.str();
-}
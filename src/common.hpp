@@ -12,6 +12,9 @@
 #include <fg/defines.h>
 #include <fg/exception.h>
 #include <err_common.hpp>
+#include <tickformat.hpp>
+#include <atomic>
+#include <map>
 #include <vector>
 
 static const float GRAY[]  = {0.0f   , 0.0f   , 0.0f   , 1.0f};
@@ -22,13 +25,33 @@ static const float RED[]   = {1.0f   , 0.0f   , 0.0f   , 1.0f};
 namespace internal
 {
 
+/* returns a new value every call, used to version renderable state */
+unsigned long long nextRevision();
+
+/* id of the window whose context is current on the calling thread, -1
+ * for other contexts. Keys per window objects created outside render */
+int currentWindowId();
+
 /* Basic renderable class
  *
  * Any object that is renderable to a window should inherit from this
  * class.
  */
 class AbstractRenderable {
+    private:
+        /* changes whenever anything that affects the rendered
+         * output changes, windows compare it against the value
+         * seen at their last presented frame. Atomic since
+         * the upload thread marks renderables modified */
+        std::atomic<unsigned long long> mRevision;
+
     public:
+        AbstractRenderable() : mRevision(nextRevision()) {}
+
+        void markDirty() { mRevision = nextRevision(); }
+
+        unsigned long long revision() const { return mRevision; }
+
         /* render is a pure virtual function.
          * @pX X coordinate at which the currently bound viewport begins.
          * @pX Y coordinate at which the currently bound viewport begins.
@@ -44,24 +67,90 @@ class AbstractRenderable {
         virtual void render(int pWindowId,
                 int pX, int pY, int pViewPortWidth, int pViewPortHeight) = 0;
 
-        /* virtual function to set colormap, a derviced class might
-         * use it or ignore it if it doesnt have a need for color maps */
-        virtual void setColorMapUBOParams(GLuint ubo, GLuint size) {
+        /* virtual function to set colormap texture and its length, a derviced
+         * class might use it or ignore it if it doesnt have a need for color maps */
+        virtual void setColorMapParams(GLuint tex, GLuint size) {
         }
 };
 
+/* host data waiting to be written to a buffer object. Writes
+ * that overlap or touch each other are merged, so that flushing
+ * them takes as few glBufferSubData calls as possible */
+class BufferUpdates {
+    private:
+        /* disjoint ranges keyed by their byte offset */
+        std::map<size_t, std::vector<unsigned char> > mRanges;
+
+    public:
+        /* later writes replace the bytes of earlier ones */
+        void add(size_t pOffset, const void* pData, size_t pSize);
+
+        bool empty() const { return mRanges.empty(); }
+
+        void clear() { mRanges.clear(); }
+
+        /* writes all ranges to the buffer bound to pTarget, each
+         * at its offset plus pBase, and clears the updates */
+        void flush(GLenum pTarget, size_t pBase=0);
+};
+
 }
 
 GLenum gl_dtype(fg::dtype val);
 
+/* size in bytes of a value of the OpenGL data type val */
+size_t gl_sizeof(GLenum val);
+
 GLenum gl_ctype(fg::ChannelFormat mode);
 
 GLenum gl_ictype(fg::ChannelFormat mode);
 
+/* sized internal format that keeps the precision of data of type val,
+ * integer data is normalized, signed data to [-1, 1] */
+GLenum gl_ictype(fg::ChannelFormat mode, fg::dtype val);
+
 char* loadFile(const char *fname, GLint &fSize);
 
 GLuint initShaders(const char* vshader_code, const char* fshader_code);
 
+GLuint initComputeShader(const char* cshader_code);
+
+/* programs are keyed by context group and source hash,
+ * GLEW contexts are shared by windows sharing a GL context,
+ * hence they identify the context group */
+typedef std::pair<GLEWContext*, size_t> ProgramKey;
+
+/* a program acquired from the registry, with the key it was acquired
+ * under, converts to the program name for OpenGL calls */
+struct ProgramRef {
+    GLuint     mProgram;
+    ProgramKey mKey;
+    /* false for programs that couldn't be shared because
+     * their key belongs to a program of other sources */
+    bool       mShared;
+
+    ProgramRef() : mProgram(0), mKey(nullptr, 0), mShared(false) {}
+
+    operator GLuint() const { return mProgram; }
+};
+
+/* Shader programs are shared by all objects of a context group (windows
+ * that share OpenGL context). acquireProgram returns the program built
+ * from the given sources for the group of the current context, and
+ * compiles it only if the group doesn't have it yet. Each call has to be
+ * balanced by a releaseProgram call, the program is deleted once the last
+ * reference to it is released. The reference is found by the key it was
+ * acquired under, so it may be released while any context is current;
+ * if that context is of another group, the program is deleted the next
+ * time a program of its own group is acquired or released. */
+ProgramRef acquireProgram(const char* vshader_code, const char* fshader_code);
+
+/* acquireProgram for a compute shader program, needs OpenGL 4.3 */
+ProgramRef acquireComputeProgram(const char* cshader_code);
+
+/* releases pProgram and resets it */
+void releaseProgram(ProgramRef& pProgram);
+
 template<typename T>
 GLuint createBuffer(GLenum target, size_t size, const T* data, GLenum usage)
 {
@@ -81,4 +170,3 @@ float clampTo01(float a);
 void getFontFilePaths(std::vector<std::string>& pFiles, std::string pDir, std::string pExt);
 #endif
 
-std::string toString(float pVal, const int n = 2);
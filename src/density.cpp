@@ -0,0 +1,260 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <density.hpp>
+
+#include <algorithm>
+
+#include <glm/gtc/type_ptr.hpp>
+
+/* one pixel per point, the attribute is a vec3 so that
+ * 2d plots get z = 0 from their two component positions */
+static const char *gDensitySplatVertexShaderSrc =
+"#version 330\n"
+"layout(location = 0) in vec3 point;\n"
+"uniform mat4 transform;\n"
+"void main(void) {\n"
+"   gl_Position = transform * vec4(point, 1);\n"
+"   gl_PointSize = 1;\n"
+"}";
+
+static const char *gDensitySplatFragmentShaderSrc =
+"#version 330\n"
+"out float count;\n"
+"void main(void) {\n"
+"   count = 1;\n"
+"}";
+
+/* full viewport quad from gl_VertexID, drawn as a 4 vertex strip */
+static const char *gDensityPassVertexShaderSrc =
+"#version 330\n"
+"void main(void) {\n"
+"   vec2 pos = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+"   gl_Position = vec4(pos * 2 - 1, 0, 1);\n"
+"}";
+
+/* largest count of a block of the level below */
+static const char *gDensityReduceFragmentShaderSrc =
+"#version 330\n"
+"uniform sampler2D counts;\n"
+"uniform ivec2 size;\n"
+"uniform int block;\n"
+"out float peak;\n"
+"void main(void) {\n"
+"   ivec2 base = ivec2(gl_FragCoord.xy) * block;\n"
+"   float m = 0;\n"
+"   for (int y = 0; y < block; ++y)\n"
+"       for (int x = 0; x < block; ++x)\n"
+"           m = max(m, texelFetch(counts, min(base + ivec2(x, y), size - 1), 0).r);\n"
+"   peak = m;\n"
+"}";
+
+/* maps counts from one to the peak onto the colormap, when
+ * no pixel has more than one point they all get its end */
+static const char *gDensityResolveFragmentShaderSrc =
+"#version 330\n"
+"uniform sampler2D counts;\n"
+"uniform sampler2D peak;\n"
+"uniform sampler1D colormap;\n"
+"uniform float cmaplen;\n"
+"uniform ivec2 origin;\n"
+"uniform bool logScale;\n"
+"out vec4 outputColor;\n"
+"void main(void) {\n"
+"   float c = texelFetch(counts, ivec2(gl_FragCoord.xy) - origin, 0).r;\n"
+"   if (c <= 0)\n"
+"       discard;\n"
+"   float m = texelFetch(peak, ivec2(0), 0).r;\n"
+"   float t = 1.0;\n"
+"   if (m > 1)\n"
+"       t = (logScale ? log(c) / log(m) : (c - 1) / (m - 1));\n"
+"   outputColor = texture(colormap, (0.5 + (cmaplen - 1) * t) / cmaplen);\n"
+"}";
+
+
+namespace internal
+{
+
+const int DensityMap::REDUCTION;
+
+DensityMap::DensityMap()
+    : mFramebuffer(0)
+{
+    CheckGL("Begin DensityMap::DensityMap");
+    mSplatProgram   = acquireProgram(gDensitySplatVertexShaderSrc, gDensitySplatFragmentShaderSrc);
+    mReduceProgram  = acquireProgram(gDensityPassVertexShaderSrc, gDensityReduceFragmentShaderSrc);
+    mResolveProgram = acquireProgram(gDensityPassVertexShaderSrc, gDensityResolveFragmentShaderSrc);
+    glGenFramebuffers(1, &mFramebuffer);
+    CheckGL("End DensityMap::DensityMap");
+}
+
+DensityMap::~DensityMap()
+{
+    CheckGL("Begin DensityMap::~DensityMap");
+    releaseLevels();
+    for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
+        GLuint vao = it->second;
+        glDeleteVertexArrays(1, &vao);
+    }
+    glDeleteFramebuffers(1, &mFramebuffer);
+    releaseProgram(mResolveProgram);
+    releaseProgram(mReduceProgram);
+    releaseProgram(mSplatProgram);
+    CheckGL("End DensityMap::~DensityMap");
+}
+
+void DensityMap::bindVAO(int pWindowId)
+{
+    /* the passes generate their vertices, but a vertex
+     * array object has to be bound for draws */
+    if (mVAOMap.find(pWindowId) == mVAOMap.end()) {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        mVAOMap[pWindowId] = vao;
+    }
+    glBindVertexArray(mVAOMap[pWindowId]);
+}
+
+void DensityMap::releaseLevels()
+{
+    if (!mLevels.empty())
+        glDeleteTextures(GLsizei(mLevels.size()), mLevels.data());
+    mLevels.clear();
+    mWidths.clear();
+    mHeights.clear();
+}
+
+void DensityMap::begin(const glm::mat4& pTransform)
+{
+    CheckGL("Begin DensityMap::begin");
+    /* the window may render to a framebuffer object of its own */
+    mScissor = glIsEnabled(GL_SCISSOR_TEST);
+    mBlend   = glIsEnabled(GL_BLEND);
+    mDepth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &mDrawFbo);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &mReadFbo);
+    glGetIntegerv(GL_VIEWPORT, mViewport);
+    glGetIntegerv(GL_SCISSOR_BOX, mScissorBox);
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, &mBlendEquation[0]);
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &mBlendEquation[1]);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &mBlendFunc[0]);
+    glGetIntegerv(GL_BLEND_DST_RGB, &mBlendFunc[1]);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &mBlendFunc[2]);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &mBlendFunc[3]);
+
+    GLint width  = std::max(mViewport[2], 1);
+    GLint height = std::max(mViewport[3], 1);
+    if (mLevels.empty() || mWidths[0] != width || mHeights[0] != height) {
+        releaseLevels();
+        mWidths.push_back(width);
+        mHeights.push_back(height);
+        while (mWidths.back() > 1 || mHeights.back() > 1) {
+            mWidths.push_back((mWidths.back() + REDUCTION - 1) / REDUCTION);
+            mHeights.push_back((mHeights.back() + REDUCTION - 1) / REDUCTION);
+        }
+        mLevels.resize(mWidths.size());
+        glGenTextures(GLsizei(mLevels.size()), mLevels.data());
+        for (size_t i=0; i<mLevels.size(); ++i) {
+            glBindTexture(GL_TEXTURE_2D, mLevels[i]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, mWidths[i], mHeights[i],
+                         0, GL_RED, GL_FLOAT, NULL);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mLevels[0], 0);
+    glViewport(0, 0, width, height);
+    glDisable(GL_SCISSOR_TEST);
+    const GLfloat zero[] = {0, 0, 0, 0};
+    glClearBufferfv(GL_COLOR, 0, zero);
+    if (mScissor) {
+        /* the scissor rectangle relative to the viewport */
+        glScissor(mScissorBox[0] - mViewport[0], mScissorBox[1] - mViewport[1],
+                  mScissorBox[2], mScissorBox[3]);
+        glEnable(GL_SCISSOR_TEST);
+    }
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendEquation(GL_FUNC_ADD);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    glUseProgram(mSplatProgram);
+    glUniformMatrix4fv(glGetUniformLocation(mSplatProgram, "transform"),
+                       1, GL_FALSE, glm::value_ptr(pTransform));
+    CheckGL("End DensityMap::begin");
+}
+
+void DensityMap::end(int pWindowId, GLuint pColorMap, GLuint pColorMapLength, bool pLogScale)
+{
+    CheckGL("Begin DensityMap::end");
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    bindVAO(pWindowId);
+
+    /* the largest count, the 1x1 top level */
+    glUseProgram(mReduceProgram);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "counts"), 0);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "block"), REDUCTION);
+    glActiveTexture(GL_TEXTURE0);
+    for (size_t i=1; i<mLevels.size(); ++i) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mLevels[i], 0);
+        glViewport(0, 0, mWidths[i], mHeights[i]);
+        glBindTexture(GL_TEXTURE_2D, mLevels[i-1]);
+        glUniform2i(glGetUniformLocation(mReduceProgram, "size"), mWidths[i-1], mHeights[i-1]);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    glViewport(mViewport[0], mViewport[1], mViewport[2], mViewport[3]);
+    glScissor(mScissorBox[0], mScissorBox[1], mScissorBox[2], mScissorBox[3]);
+    if (mScissor)
+        glEnable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, mReadFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mDrawFbo);
+
+    /* counts through the colormap, without points the
+     * top level is zero and nothing is drawn */
+    glUseProgram(mResolveProgram);
+    glUniform1i(glGetUniformLocation(mResolveProgram, "counts"), 0);
+    glUniform1i(glGetUniformLocation(mResolveProgram, "peak"), 1);
+    glUniform1i(glGetUniformLocation(mResolveProgram, "colormap"), 2);
+    glUniform1f(glGetUniformLocation(mResolveProgram, "cmaplen"), GLfloat(pColorMapLength));
+    glUniform2i(glGetUniformLocation(mResolveProgram, "origin"), mViewport[0], mViewport[1]);
+    glUniform1i(glGetUniformLocation(mResolveProgram, "logScale"), pLogScale);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_1D, pColorMap);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mLevels.back());
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mLevels[0]);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    glBlendEquationSeparate(mBlendEquation[0], mBlendEquation[1]);
+    glBlendFuncSeparate(mBlendFunc[0], mBlendFunc[1], mBlendFunc[2], mBlendFunc[3]);
+    if (mBlend)
+        glEnable(GL_BLEND);
+    if (mDepth)
+        glEnable(GL_DEPTH_TEST);
+    CheckGL("End DensityMap::end");
+}
+
+}
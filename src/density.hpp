@@ -0,0 +1,78 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace internal
+{
+
+/* Density map of the points of a scatter plot
+ *
+ * The points are drawn as single pixels with additive blending into a
+ * float target of the size of the viewport, so each texel ends up with
+ * the number of points that fall on its pixel. The largest count is
+ * found on the GPU by reducing blocks of REDUCTION x REDUCTION texels
+ * until one is left, and a last pass maps the counts relative to it,
+ * linearly or on a log scale, through the colormap onto the viewport.
+ * Pixels without points are left as they are. Between begin and end the
+ * caller draws the points as GL_POINTS from a vertex array with the
+ * positions at attribute location 0. */
+class DensityMap {
+    public:
+        static const int REDUCTION = 4;
+
+    private:
+        ProgramRef mSplatProgram;
+        ProgramRef mReduceProgram;
+        ProgramRef mResolveProgram;
+        GLuint mFramebuffer;
+        /* level 0 holds the counts, every further level the
+         * maxima of blocks of the level below, down to 1x1 */
+        std::vector<GLuint> mLevels;
+        std::vector<GLint>  mWidths;
+        std::vector<GLint>  mHeights;
+        std::map<int, GLuint> mVAOMap;
+
+        /* state restored by end */
+        GLint     mDrawFbo;
+        GLint     mReadFbo;
+        GLint     mViewport[4];
+        GLint     mScissorBox[4];
+        GLint     mBlendEquation[2];
+        GLint     mBlendFunc[4];
+        GLboolean mScissor;
+        GLboolean mBlend;
+        GLboolean mDepth;
+
+        DensityMap(const DensityMap& other);
+        DensityMap& operator=(const DensityMap& other);
+
+        void bindVAO(int pWindowId);
+        void releaseLevels();
+
+    public:
+        DensityMap();
+        ~DensityMap();
+
+        /* binds the count target for the current viewport, cleared, and
+         * the program that draws the points with pTransform. Points are
+         * clipped to the scissor rectangle if scissor testing is on */
+        void begin(const glm::mat4& pTransform);
+        /* finds the largest count and draws the counts with colormap
+         * pColorMap of pColorMapLength colors onto the viewport */
+        void end(int pWindowId, GLuint pColorMap, GLuint pColorMapLength, bool pLogScale);
+};
+
+}
@@ -0,0 +1,308 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <common.hpp>
+#include <egl/window.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#define EGL_THROW_ERROR(msg, err) \
+    throw fg::Error("Window constructor", __LINE__, msg, err);
+
+static bool hasExtension(const char* pExtensions, const char* pName)
+{
+    if (pExtensions==NULL)
+        return false;
+
+    size_t len = strlen(pName);
+    const char* start = pExtensions;
+    while ((start = strstr(start, pName)) != NULL) {
+        const char* end = start + len;
+        if ((start==pExtensions || *(start-1)==' ') && (*end==' ' || *end=='\0'))
+            return true;
+        start = end;
+    }
+    return false;
+}
+
+/* All widgets share one EGL display connection. The surfaceless
+ * platform is preferred since it needs neither an X server nor a
+ * DRM master, default display is used as fallback */
+static EGLDisplay getEGLDisplay()
+{
+    static EGLDisplay display = EGL_NO_DISPLAY;
+    static std::once_flag flag;
+
+    std::call_once(flag, []() {
+        const char* clientExts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+        if (hasExtension(clientExts, "EGL_MESA_platform_surfaceless") &&
+            hasExtension(clientExts, "EGL_EXT_platform_base")) {
+            PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay)
+                display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        }
+
+        if (display == EGL_NO_DISPLAY)
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major, minor;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            display = EGL_NO_DISPLAY;
+        }
+    });
+
+    return display;
+}
+
+namespace wtk
+{
+
+Widget::Widget()
+    : mDisplay(EGL_NO_DISPLAY), mContext(EGL_NO_CONTEXT), mSurface(EGL_NO_SURFACE),
+      mClose(false), mWidth(0), mHeight(0), mFramebuffer(0), mColorBuffer(0),
+      mDepthBuffer(0), mFBOWidth(0), mFBOHeight(0)
+{
+}
+
+Widget::Widget(int pWidth, int pHeight, const char* pTitle, const Widget* pWindow, const bool invisible)
+    : mDisplay(EGL_NO_DISPLAY), mContext(EGL_NO_CONTEXT), mSurface(EGL_NO_SURFACE),
+      mClose(false), mWidth(pWidth), mHeight(pHeight), mFramebuffer(0), mColorBuffer(0),
+      mDepthBuffer(0), mFBOWidth(0), mFBOHeight(0)
+{
+    mDisplay = getEGLDisplay();
+    if (mDisplay == EGL_NO_DISPLAY) {
+        std::cerr << "ERROR: EGL wasn't able to initalize\n";
+        EGL_THROW_ERROR("egl initilization failed", fg::FG_ERR_GL_ERROR)
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        EGL_THROW_ERROR("egl does not support desktop OpenGL", fg::FG_ERR_GL_ERROR)
+    }
+
+    static const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE,        8,
+        EGL_GREEN_SIZE,      8,
+        EGL_BLUE_SIZE,       8,
+        EGL_ALPHA_SIZE,      8,
+        EGL_DEPTH_SIZE,      24,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(mDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs < 1) {
+        std::cerr<<"Error: Could not find a suitable EGL config!\n";
+        EGL_THROW_ERROR("egl config selection failed", fg::FG_ERR_GL_ERROR)
+    }
+
+    static const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR,       3,
+        EGL_CONTEXT_MINOR_VERSION_KHR,       3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_CONTEXT_FLAGS_KHR,               EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR,
+        EGL_NONE
+    };
+
+    mContext = eglCreateContext(mDisplay, config,
+                                (pWindow!=nullptr ? pWindow->getNativeHandle() : EGL_NO_CONTEXT),
+                                contextAttribs);
+    if (mContext == EGL_NO_CONTEXT) {
+        std::cerr<<"Error: Could not Create EGL Context!\n";
+        EGL_THROW_ERROR("egl context creation failed", fg::FG_ERR_GL_ERROR)
+    }
+
+    /* a dummy pbuffer is needed only if the
+     * implementation can't bind a context without a surface */
+    const char* dispExts = eglQueryString(mDisplay, EGL_EXTENSIONS);
+    if (!hasExtension(dispExts, "EGL_KHR_surfaceless_context")) {
+        static const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        mSurface = eglCreatePbufferSurface(mDisplay, config, pbufferAttribs);
+        if (mSurface == EGL_NO_SURFACE) {
+            eglDestroyContext(mDisplay, mContext);
+            EGL_THROW_ERROR("egl pbuffer creation failed", fg::FG_ERR_GL_ERROR)
+        }
+    }
+
+    mGenFramebuffers         = (PFNGLGENFRAMEBUFFERSPROC)eglGetProcAddress("glGenFramebuffers");
+    mDeleteFramebuffers      = (PFNGLDELETEFRAMEBUFFERSPROC)eglGetProcAddress("glDeleteFramebuffers");
+    mBindFramebuffer         = (PFNGLBINDFRAMEBUFFERPROC)eglGetProcAddress("glBindFramebuffer");
+    mFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)eglGetProcAddress("glFramebufferRenderbuffer");
+    mCheckFramebufferStatus  = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)eglGetProcAddress("glCheckFramebufferStatus");
+    mGenRenderbuffers        = (PFNGLGENRENDERBUFFERSPROC)eglGetProcAddress("glGenRenderbuffers");
+    mDeleteRenderbuffers     = (PFNGLDELETERENDERBUFFERSPROC)eglGetProcAddress("glDeleteRenderbuffers");
+    mBindRenderbuffer        = (PFNGLBINDRENDERBUFFERPROC)eglGetProcAddress("glBindRenderbuffer");
+    mRenderbufferStorage     = (PFNGLRENDERBUFFERSTORAGEPROC)eglGetProcAddress("glRenderbufferStorage");
+
+    if (!mGenFramebuffers || !mDeleteFramebuffers || !mBindFramebuffer ||
+        !mFramebufferRenderbuffer || !mCheckFramebufferStatus || !mGenRenderbuffers ||
+        !mDeleteRenderbuffers || !mBindRenderbuffer || !mRenderbufferStorage) {
+        eglDestroyContext(mDisplay, mContext);
+        EGL_THROW_ERROR("framebuffer object entry points not found", fg::FG_ERR_GL_ERROR)
+    }
+}
+
+Widget::~Widget()
+{
+    if (mFramebuffer) {
+        EGLContext prevCxt  = eglGetCurrentContext();
+        EGLSurface prevDraw = eglGetCurrentSurface(EGL_DRAW);
+        EGLSurface prevRead = eglGetCurrentSurface(EGL_READ);
+
+        eglMakeCurrent(mDisplay, mSurface, mSurface, mContext);
+        mDeleteFramebuffers(1, &mFramebuffer);
+        mDeleteRenderbuffers(1, &mColorBuffer);
+        mDeleteRenderbuffers(1, &mDepthBuffer);
+
+        if (prevCxt != mContext)
+            eglMakeCurrent(mDisplay, prevDraw, prevRead, prevCxt);
+        else
+            eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+    if (mSurface != EGL_NO_SURFACE)
+        eglDestroySurface(mDisplay, mSurface);
+    if (mContext != EGL_NO_CONTEXT)
+        eglDestroyContext(mDisplay, mContext);
+}
+
+void Widget::updateFrameBuffer() const
+{
+    if (mFramebuffer && mFBOWidth==mWidth && mFBOHeight==mHeight)
+        return;
+
+    if (!mFramebuffer) {
+        mGenFramebuffers(1, &mFramebuffer);
+        mGenRenderbuffers(1, &mColorBuffer);
+        mGenRenderbuffers(1, &mDepthBuffer);
+    }
+
+    mBindRenderbuffer(GL_RENDERBUFFER, mColorBuffer);
+    mRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, mWidth, mHeight);
+    mBindRenderbuffer(GL_RENDERBUFFER, mDepthBuffer);
+    mRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mWidth, mHeight);
+    mBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    mBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    mFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mColorBuffer);
+    mFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mDepthBuffer);
+
+    if (mCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw fg::Error("Widget::updateFrameBuffer", __LINE__,
+                "offscreen framebuffer is incomplete", fg::FG_ERR_GL_ERROR);
+    }
+
+    mFBOWidth  = mWidth;
+    mFBOHeight = mHeight;
+}
+
+EGLContext Widget::getNativeHandle() const
+{
+    return mContext;
+}
+
+void Widget::makeContextCurrent() const
+{
+    eglMakeCurrent(mDisplay, mSurface, mSurface, mContext);
+    /* (re)allocate offscreen buffers on first use and after
+     * size changes, and bind them in place of the default framebuffer */
+    updateFrameBuffer();
+    mBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+}
+
+void Widget::releaseContext() const
+{
+    eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+long long Widget::getGLContextHandle()
+{
+    return reinterpret_cast<long long>(mContext);
+}
+
+long long Widget::getDisplayHandle()
+{
+    return reinterpret_cast<long long>(mDisplay);
+}
+
+void Widget::getFrameBufferSize(int* pW, int* pH)
+{
+    *pW = mWidth;
+    *pH = mHeight;
+}
+
+void Widget::setTitle(const char* pTitle)
+{
+}
+
+void Widget::setPos(int pX, int pY)
+{
+}
+
+void Widget::setSize(unsigned pW, unsigned pH)
+{
+    /* storage is reallocated on the next makeContextCurrent
+     * since this widget's context need not be current now */
+    mWidth  = int(pW);
+    mHeight = int(pH);
+}
+
+void Widget::swapBuffers()
+{
+    /* nothing to present, rendering results stay in the
+     * framebuffer object until the next frame clears it */
+    glFlush();
+}
+
+void Widget::hide()
+{
+    mClose = true;
+}
+
+void Widget::show()
+{
+    mClose = false;
+}
+
+bool Widget::close()
+{
+    return mClose;
+}
+
+void Widget::resetCloseFlag()
+{
+    if(mClose==true) {
+        show();
+    }
+}
+
+bool Widget::takeDamage()
+{
+    /* the offscreen framebuffer keeps its contents, a
+     * resize is seen by the window through its size */
+    return false;
+}
+
+void Widget::pollEvents()
+{
+}
+
+void Widget::waitEvents(double pTimeout)
+{
+    /* there are no events for an offscreen surface */
+    std::this_thread::sleep_for(std::chrono::duration<double>(pTimeout));
+}
+
+}
@@ -0,0 +1,101 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+/* the short form wtk stands for
+ * Windowing Tool Kit */
+namespace wtk
+{
+
+/* Headless widget: there is no native window, the GL context is either
+ * surfaceless or bound to a dummy pbuffer and all rendering goes to a
+ * framebuffer object of the requested size that stays bound as the
+ * default draw/read framebuffer of the context */
+class Widget {
+    private:
+        EGLDisplay  mDisplay;
+        EGLContext  mContext;
+        EGLSurface  mSurface;
+        bool        mClose;
+        int         mWidth;
+        int         mHeight;
+        /* offscreen render target */
+        mutable GLuint mFramebuffer;
+        mutable GLuint mColorBuffer;
+        mutable GLuint mDepthBuffer;
+        mutable int    mFBOWidth;
+        mutable int    mFBOHeight;
+        /* framebuffer entry points are fetched directly from EGL since
+         * GLEW is initialized only after the first makeContextCurrent */
+        PFNGLGENFRAMEBUFFERSPROC         mGenFramebuffers;
+        PFNGLDELETEFRAMEBUFFERSPROC      mDeleteFramebuffers;
+        PFNGLBINDFRAMEBUFFERPROC         mBindFramebuffer;
+        PFNGLFRAMEBUFFERRENDERBUFFERPROC mFramebufferRenderbuffer;
+        PFNGLCHECKFRAMEBUFFERSTATUSPROC  mCheckFramebufferStatus;
+        PFNGLGENRENDERBUFFERSPROC        mGenRenderbuffers;
+        PFNGLDELETERENDERBUFFERSPROC     mDeleteRenderbuffers;
+        PFNGLBINDRENDERBUFFERPROC        mBindRenderbuffer;
+        PFNGLRENDERBUFFERSTORAGEPROC     mRenderbufferStorage;
+
+        Widget();
+
+        void updateFrameBuffer() const;
+
+    public:
+        Widget(int pWidth, int pHeight, const char* pTitle, const Widget* pWindow, const bool invisible);
+
+        ~Widget();
+
+        EGLContext getNativeHandle() const;
+
+        void makeContextCurrent() const;
+
+        /* detaches the context from the calling thread */
+        void releaseContext() const;
+
+        long long getGLContextHandle();
+
+        long long getDisplayHandle();
+
+        void getFrameBufferSize(int* pW, int* pH);
+
+        void setTitle(const char* pTitle);
+
+        void setPos(int pX, int pY);
+
+        void setSize(unsigned pW, unsigned pH);
+
+        void swapBuffers();
+
+        void hide();
+
+        void show();
+
+        bool close();
+
+        void resetCloseFlag();
+
+        /* whether the contents of the window were lost, by exposing or
+         * resizing it, since the last call */
+        bool takeDamage();
+
+        void pollEvents();
+
+        /* like pollEvents, but blocks until an event
+         * arrives or pTimeout seconds have passed */
+        void waitEvents(double pTimeout);
+};
+
+}
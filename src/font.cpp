@@ -11,8 +11,11 @@
 #include <font.hpp>
 #include <common.hpp>
 
+#include <array>
+#include <cfloat>
 #include <cmath>
 #include <algorithm>
+#include <mutex>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -39,24 +42,33 @@ static FT_Face     gFTFace;
 static const char* gFontVertShader =
 "#version 330\n"
 "uniform mat4 projectionMatrix;\n"
-"uniform mat4 modelViewMatrix;\n"
 "layout (location = 0) in vec2 inPosition;\n"
 "layout (location = 1) in vec2 inCoord;\n"
+"layout (location = 2) in vec4 inColor;\n"
+"layout (location = 3) in vec4 inClip;\n"
 "out vec2 texCoord;\n"
+"out vec4 textColor;\n"
+"flat out vec4 clipRect;\n"
 "void main()\n"
 "{\n"
-"    gl_Position = projectionMatrix*modelViewMatrix*vec4(inPosition, 0.0, 1.0);\n"
+"    gl_Position = projectionMatrix*vec4(inPosition, 0.0, 1.0);\n"
 "    texCoord = inCoord;\n"
+"    textColor = inColor;\n"
+"    clipRect = inClip;\n"
 "}\n";
 
 static const char* gFontFragShader =
 "#version 330\n"
 "in vec2 texCoord;\n"
+"in vec4 textColor;\n"
+"flat in vec4 clipRect;\n"
 "out vec4 outputColor;\n"
 "uniform sampler2D tex;\n"
-"uniform vec4 textColor;\n"
 "void main()\n"
 "{\n"
+"    if (any(lessThan(gl_FragCoord.xy, clipRect.xy)) ||\n"
+"        any(greaterThanEqual(gl_FragCoord.xy, clipRect.zw)))\n"
+"        discard;\n"
 "    vec4 texC = texture(tex, texCoord);\n"
 "    vec4 alpha = vec4(1.0, 1.0, 1.0, texC.r);\n"
 "    outputColor = alpha*textColor;\n"
@@ -71,7 +83,26 @@ namespace internal
 #define FT_THROW_ERROR(msg, err) \
     throw fg::Error("Freetype library", __LINE__, msg, err);
 
-void font_impl::extractGlyph(int pCharacter)
+/* number of floats per text vertex returned by layout:
+ * position, texture coordinate, color */
+static const int TEXT_VERTEX_SIZE = 8;
+/* number of floats per batched vertex, a layout vertex
+ * followed by the clip rectangle it was queued with */
+static const int BATCH_VERTEX_SIZE = TEXT_VERTEX_SIZE + 4;
+/* width of the glyph atlas, its height depends on font size */
+static const int ATLAS_WIDTH = 512;
+/* empty texels around each glyph to avoid bleeding under linear filtering */
+static const int ATLAS_PADDING = 2;
+
+/* fonts that have text queued per window id, windows may render from
+ * different threads, the mutex guards these lists and font batches */
+static std::map<int, std::vector<font_impl*> > gPendingFonts;
+static std::mutex gPendingFontsMutex;
+/* window space clip rectangle as x0, y0, x1, y1 per window id
+ * that is applied to text queued for that window */
+static std::map<int, std::array<float, 4> > gClipRects;
+
+void font_impl::extractGlyph(int pCharacter, std::vector<unsigned char>& pBitmap)
 {
     FT_Load_Glyph(gFTFace, FT_Get_Char_Index(gFTFace, pCharacter), FT_LOAD_DEFAULT);
     FT_Render_Glyph(gFTFace->glyph, FT_RENDER_MODE_NORMAL);
@@ -79,31 +110,18 @@ void font_impl::extractGlyph(int pCharacter)
 
     int pIndex = pCharacter - START_CHAR;
 
-    int bmp_w = bitmap.width;
-    int bmp_h = bitmap.rows;
-    int w     = next_p2(bmp_w);
-    int h     = next_p2(bmp_h);
+    int bmp_w = (pCharacter==32 ? 0 : bitmap.width);
+    int bmp_h = (pCharacter==32 ? 0 : bitmap.rows);
 
-    std::vector<unsigned char> glyphData(w*h, 0);
-    for (int j=0; j<h; ++j) {
-        for (int i=0; i<w; ++i) {
-            glyphData[ (j*w+i) ] =
-                (i<bmp_w && j<bmp_h ? bitmap.buffer[(bmp_h-1-j)*bmp_w+i] : 0);
+    pBitmap.resize(bmp_w*bmp_h);
+    for (int j=0; j<bmp_h; ++j) {
+        for (int i=0; i<bmp_w; ++i) {
+            pBitmap[j*bmp_w+i] = bitmap.buffer[(bmp_h-1-j)*bitmap.pitch+i];
         }
     }
 
-    CheckGL("Before Character texture creation");
-    // texture from it
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glGenTextures(1, &(mCharTextures[pIndex]));
-    glBindTexture(GL_TEXTURE_2D, mCharTextures[pIndex]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
-                 w, h, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE,
-                 (pCharacter==32 ? NULL : &glyphData.front()));
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-    CheckGL("After Character texture creation");
+    mGlyphWidth[pIndex]  = bmp_w;
+    mGlyphHeight[pIndex] = bmp_h;
 
     mAdvX[pIndex] = gFTFace->glyph->advance.x>>6;
     mBearingX[pIndex] = gFTFace->glyph->metrics.horiBearingX>>6;
@@ -114,31 +132,12 @@ void font_impl::extractGlyph(int pCharacter)
     mCharHeight[pIndex] = gFTFace->glyph->metrics.height>>6;
 
     mNewLine = std::max(mNewLine, int(gFTFace->glyph->metrics.height>>6));
-
-    // Rendering data, texture coordinates are always the same,
-    // so now we waste a little memory
-    float quad[8];
-    float quad_texcoords[8] = { 0, 1, 0, 0, 1, 1, 1, 0};
-
-    quad[0] = 0.0f; quad[1] = float(-mAdvY[pIndex]+h);
-    quad[2] = 0.0f; quad[3] = float(-mAdvY[pIndex]);
-    quad[4] = float(w); quad[5] = float(-mAdvY[pIndex]+h);
-    quad[6] = float(w); quad[7] = float(-mAdvY[pIndex]);
-
-    // texture coordinates are duplicated for each character
-    // TODO work on removing this duplicates to reduce memory usage
-    for (int i=0; i<4; ++i) {
-        float* vert_ptr = quad+2*i;
-        float* tex_ptr  = quad_texcoords+2*i;
-        mVertexData.insert(mVertexData.end(), vert_ptr, vert_ptr+2);
-        mVertexData.insert(mVertexData.end(), tex_ptr, tex_ptr+2);
-    }
 }
 
 void font_impl::bindResources(int pWindowId)
 {
     if (mVAOMap.find(pWindowId) == mVAOMap.end()) {
-        GLsizei size = sizeof(glm::vec2);
+        GLsizei stride = BATCH_VERTEX_SIZE*sizeof(float);
         GLuint vao = 0;
         /* create a vertex array object
          * with appropriate bindings */
@@ -146,9 +145,13 @@ void font_impl::bindResources(int pWindowId)
         glBindVertexArray(vao);
         glEnableVertexAttribArray(0);
         glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glEnableVertexAttribArray(3);
         glBindBuffer(GL_ARRAY_BUFFER, mVBO);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, size*2, 0);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, size*2, reinterpret_cast<void*>(size));
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, 0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(2*sizeof(float)));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(4*sizeof(float)));
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(8*sizeof(float)));
         glBindVertexArray(0);
         /* store the vertex array object corresponding to
          * the window instance in the map */
@@ -165,20 +168,22 @@ void font_impl::unbindResources() const
 void font_impl::destroyGLResources()
 {
     if (mIsFontLoaded) {
-        if (mProgram) glDeleteProgram(mProgram);
-        if (mVBO) glDeleteBuffers(1, &mVBO);
-        glDeleteTextures(NUM_CHARS, mCharTextures);
+        if (mAtlas) glDeleteTextures(1, &mAtlas);
+        mAtlas = 0;
     }
-    if (mProgram) glDeleteProgram(mProgram);
-    if (mSampler) glDeleteSamplers(1, &mSampler);
 }
 
 font_impl::font_impl()
     :   mIsFontLoaded(false), mTTFfile(""),
-        mVBO(0), mProgram(0), mSampler(0)
+        mVBO(0), mProgram(), mSampler(0), mAtlas(0), mRevision(0)
 {
-    mProgram = initShaders(gFontVertShader, gFontFragShader);
-    memset(mCharTextures, 0, NUM_CHARS);
+    mViewport[0] = mViewport[1] = mViewport[2] = mViewport[3] = 0;
+    mProgram    = acquireProgram(gFontVertShader, gFontFragShader);
+    mPMatIndex  = glGetUniformLocation(mProgram, "projectionMatrix");
+    mTexIndex   = glGetUniformLocation(mProgram, "tex");
+
+    glGenBuffers(1, &mVBO);
+
     glGenSamplers(1, &mSampler);
     glSamplerParameteri(mSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glSamplerParameteri(mSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -188,13 +193,28 @@ font_impl::font_impl()
 
 font_impl::~font_impl()
 {
+    {
+        std::lock_guard<std::mutex> lock(gPendingFontsMutex);
+        for (auto it = gPendingFonts.begin(); it!=gPendingFonts.end(); ++it) {
+            std::vector<font_impl*>& fonts = it->second;
+            fonts.erase(std::remove(fonts.begin(), fonts.end(), this), fonts.end());
+        }
+    }
     destroyGLResources();
+    for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
+        GLuint vao = it->second;
+        glDeleteVertexArrays(1, &vao);
+    }
+    if (mVBO) glDeleteBuffers(1, &mVBO);
+    releaseProgram(mProgram);
+    if (mSampler) glDeleteSamplers(1, &mSampler);
 }
 
 void font_impl::setOthro2D(int pWidth, int pHeight)
 {
     mWidth = pWidth;
     mHeight= pHeight;
+    glGetIntegerv(GL_VIEWPORT, mViewport);
 }
 
 void font_impl::loadFont(const char* const pFile, int pFontSize)
@@ -208,6 +228,7 @@ void font_impl::loadFont(const char* const pFile, int pFontSize)
         }
     }
     mLoadedPixelSize = pFontSize;
+    mNewLine = 0;
 
     CheckGL("Begin Font::loadFont");
     // Initialize freetype font library
@@ -228,15 +249,53 @@ void font_impl::loadFont(const char* const pFile, int pFontSize)
 
     // read font glyphs for only characters
     // from ' ' to '~'
-    for (int i=START_CHAR; i<END_CHAR; ++i) extractGlyph(i);
+    std::vector<unsigned char> glyphs[NUM_CHARS];
+    for (int i=START_CHAR; i<END_CHAR; ++i) extractGlyph(i, glyphs[i-START_CHAR]);
 
     FT_Done_Face(gFTFace);
     FT_Done_FreeType(gFTLib);
 
-    mVBO = createBuffer<float>(GL_ARRAY_BUFFER, mVertexData.size(), &(mVertexData.front()), GL_STATIC_DRAW);
+    /* pack glyphs into rows of the atlas */
+    int glyphX[NUM_CHARS], glyphY[NUM_CHARS];
+    int penX = ATLAS_PADDING, penY = ATLAS_PADDING, rowHeight = 0;
+    for (int i=0; i<NUM_CHARS; ++i) {
+        if (penX + mGlyphWidth[i] + ATLAS_PADDING > ATLAS_WIDTH) {
+            penX  = ATLAS_PADDING;
+            penY += rowHeight + ATLAS_PADDING;
+            rowHeight = 0;
+        }
+        glyphX[i]  = penX;
+        glyphY[i]  = penY;
+        penX      += mGlyphWidth[i] + ATLAS_PADDING;
+        rowHeight  = std::max(rowHeight, mGlyphHeight[i]);
+    }
+    int atlasHeight = next_p2(penY + rowHeight + ATLAS_PADDING);
+
+    std::vector<unsigned char> atlasData(ATLAS_WIDTH*atlasHeight, 0);
+    for (int i=0; i<NUM_CHARS; ++i) {
+        for (int j=0; j<mGlyphHeight[i]; ++j) {
+            std::copy(glyphs[i].begin() + j*mGlyphWidth[i],
+                      glyphs[i].begin() + (j+1)*mGlyphWidth[i],
+                      atlasData.begin() + (glyphY[i]+j)*ATLAS_WIDTH + glyphX[i]);
+        }
+        mGlyphCoords[i][0] = float(glyphX[i]) / ATLAS_WIDTH;
+        mGlyphCoords[i][1] = float(glyphY[i]) / atlasHeight;
+        mGlyphCoords[i][2] = float(glyphX[i] + mGlyphWidth[i]) / ATLAS_WIDTH;
+        mGlyphCoords[i][3] = float(glyphY[i] + mGlyphHeight[i]) / atlasHeight;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glGenTextures(1, &mAtlas);
+    glBindTexture(GL_TEXTURE_2D, mAtlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, atlasHeight, 0,
+                 GL_RED, GL_UNSIGNED_BYTE, &atlasData.front());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     mIsFontLoaded = true;
     mTTFfile = pFile;
+    mRevision = nextRevision();
     CheckGL("End Font::loadFont");
 }
 
@@ -303,30 +362,66 @@ void font_impl::loadSystemFont(const char* const pName, int pFontSize)
     loadFont(ttf_file_path.c_str(), pFontSize);
 }
 
-void font_impl::render(int pWindowId,
-                       const float pPos[], const float pColor[], const char* pText,
-                       int pFontSize, bool pIsVertical)
+unsigned long long font_impl::revision() const
+{
+    return mRevision;
+}
+
+void font_impl::queue(int pWindowId, const float pPos[2], const float pColor[4],
+                      const char* pText, int pFontSize, bool pIsVertical)
 {
     if(!mIsFontLoaded) {
         std::cerr<<"No font was loaded!, hence skipping text rendering."<<std::endl;
         return;
     }
 
-    glDisable(GL_DEPTH_TEST);
-    glDepthFunc(GL_ALWAYS);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    std::vector<float> vertices;
+    layout(pPos, pColor, pText, pFontSize, pIsVertical, vertices);
+    queue(pWindowId, vertices);
+}
 
-    glUseProgram(mProgram);
-    GLuint pmat_loc = glGetUniformLocation(mProgram, "projectionMatrix");
-    GLuint mvmat_loc = glGetUniformLocation(mProgram, "modelViewMatrix");
-    GLuint tex_loc = glGetUniformLocation(mProgram, "tex");
-    GLuint col_loc = glGetUniformLocation(mProgram, "textColor");
+void font_impl::queue(int pWindowId, const std::vector<float>& pVertices)
+{
+    if (!mIsFontLoaded || pVertices.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(gPendingFontsMutex);
+    std::vector<float>& batch = mBatches[pWindowId];
+    if (batch.empty())
+        gPendingFonts[pWindowId].push_back(this);
+
+    static const float noClip[4] = {-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX};
+    auto clip = gClipRects.find(pWindowId);
+    const float* rect = (clip != gClipRects.end() ? clip->second.data() : noClip);
+
+    size_t count = pVertices.size() / TEXT_VERTEX_SIZE;
+    batch.reserve(batch.size() + count*BATCH_VERTEX_SIZE);
+    for (size_t i=0; i<count; ++i) {
+        const float* v = &pVertices[i*TEXT_VERTEX_SIZE];
+        batch.insert(batch.end(), v, v+TEXT_VERTEX_SIZE);
+        batch.insert(batch.end(), rect, rect+4);
+    }
+}
+
+void font_impl::setClipRect(int pWindowId, int pX, int pY, int pWidth, int pHeight)
+{
+    std::lock_guard<std::mutex> lock(gPendingFontsMutex);
+    std::array<float, 4> rect = {{float(pX), float(pY),
+                                  float(pX+pWidth), float(pY+pHeight)}};
+    gClipRects[pWindowId] = rect;
+}
 
-    glm::mat4 projMat = glm::ortho(0.0f, float(mWidth), 0.0f, float(mHeight));
+void font_impl::resetClipRect(int pWindowId)
+{
+    std::lock_guard<std::mutex> lock(gPendingFontsMutex);
+    gClipRects.erase(pWindowId);
+}
 
-    glUniformMatrix4fv(pmat_loc, 1, GL_FALSE, (GLfloat*)&projMat);
-    glUniform4fv(col_loc, 1, pColor);
+void font_impl::layout(const float pPos[2], const float pColor[4], const char* pText,
+                       int pFontSize, bool pIsVertical, std::vector<float>& pVertices) const
+{
+    if(!mIsFontLoaded)
+        return;
 
     int loc_x = int(pPos[0]);
     int loc_y = int(pPos[1]);
@@ -334,14 +429,11 @@ void font_impl::render(int pWindowId,
         pFontSize = mLoadedPixelSize;
     float scale_factor = float(pFontSize) / float(mLoadedPixelSize);
 
-    bindResources(pWindowId);
-    CheckGL("After Font::render bind resources");
-    glActiveTexture(GL_TEXTURE0);
-    glUniform1i(tex_loc, 0);
-    glBindSampler(0, mSampler);
+    /* maps the setOthro2D coordinate space to window coordinates */
+    float sx = float(mViewport[2]) / float(mWidth);
+    float sy = float(mViewport[3]) / float(mHeight);
 
-    std::string str(pText);
-    for (std::string::iterator it = str.begin(); it != str.end(); ++it) {
+    for (const char* it = pText; *it != '\0'; ++it) {
         char currChar = *it;
 
         if(currChar == '\n') {
@@ -353,18 +445,22 @@ void font_impl::render(int pWindowId,
             int idx = int(currChar) - START_CHAR;
             loc_x += mBearingX[idx] * pFontSize / mLoadedPixelSize;
 
-            glBindTexture(GL_TEXTURE_2D, mCharTextures[idx]);
-
-            /* rotate by 90 degress if we need
-             * to render the characters vertically */
-            glm::mat4 modelView = glm::translate(glm::mat4(1.0f),
-                    glm::vec3(float(loc_x), float(loc_y), 0.0f));
-
-            modelView = glm::scale(modelView, glm::vec3(scale_factor));
-            glUniformMatrix4fv(mvmat_loc, 1, GL_FALSE, (GLfloat*)&modelView);
-
-            // Draw letter
-            glDrawArrays(GL_TRIANGLE_STRIP, idx*4, 4);
+            if (mGlyphWidth[idx] > 0 && mGlyphHeight[idx] > 0) {
+                float x0 = mViewport[0] + sx * loc_x;
+                float x1 = mViewport[0] + sx * (loc_x + scale_factor*mGlyphWidth[idx]);
+                float y0 = mViewport[1] + sy * (loc_y - scale_factor*mAdvY[idx]);
+                float y1 = mViewport[1] + sy * (loc_y + scale_factor*(mGlyphHeight[idx]-mAdvY[idx]));
+                const float* uv = mGlyphCoords[idx];
+
+                const float quad[6][4] = {
+                    {x0, y0, uv[0], uv[1]}, {x1, y0, uv[2], uv[1]}, {x0, y1, uv[0], uv[3]},
+                    {x0, y1, uv[0], uv[3]}, {x1, y0, uv[2], uv[1]}, {x1, y1, uv[2], uv[3]}
+                };
+                for (int v=0; v<6; ++v) {
+                    pVertices.insert(pVertices.end(), quad[v], quad[v]+4);
+                    pVertices.insert(pVertices.end(), pColor, pColor+4);
+                }
+            }
 
             loc_x += (mAdvX[idx] - mBearingX[idx]) * pFontSize / mLoadedPixelSize;
         }
@@ -376,14 +472,65 @@ void font_impl::render(int pWindowId,
             loc_y -= mNewLine * pFontSize / mLoadedPixelSize;
         }
     }
+}
+
+void font_impl::flush(int pWindowId, int pWidth, int pHeight)
+{
+    std::vector<float> batch;
+    {
+        std::lock_guard<std::mutex> lock(gPendingFontsMutex);
+        batch.swap(mBatches[pWindowId]);
+    }
+    if (batch.empty())
+        return;
+
+    CheckGL("Begin Font::flush");
+    glViewport(0, 0, pWidth, pHeight);
+    glDisable(GL_DEPTH_TEST);
+    glDepthFunc(GL_ALWAYS);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(mProgram);
+
+    glm::mat4 projMat = glm::ortho(0.0f, float(pWidth), 0.0f, float(pHeight));
+    glUniformMatrix4fv(mPMatIndex, 1, GL_FALSE, (GLfloat*)&projMat);
+
+    /* the buffer is respecified every frame, which lets the
+     * driver hand out fresh storage instead of stalling */
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glBufferData(GL_ARRAY_BUFFER, batch.size()*sizeof(float), &batch.front(), GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    bindResources(pWindowId);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mAtlas);
+    glUniform1i(mTexIndex, 0);
+    glBindSampler(0, mSampler);
+
+    glDrawArrays(GL_TRIANGLES, 0, GLsizei(batch.size() / BATCH_VERTEX_SIZE));
 
+    glBindSampler(0, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
     unbindResources();
 
     glUseProgram(0);
     glDisable(GL_BLEND);
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
-    CheckGL("After Font::render ");
+
+    CheckGL("End Font::flush");
+}
+
+void font_impl::flushAll(int pWindowId, int pWidth, int pHeight)
+{
+    std::vector<font_impl*> fonts;
+    {
+        std::lock_guard<std::mutex> lock(gPendingFontsMutex);
+        fonts.swap(gPendingFonts[pWindowId]);
+    }
+    for (size_t i=0; i<fonts.size(); ++i)
+        fonts[i]->flush(pWindowId, pWidth, pHeight);
 }
 
 }
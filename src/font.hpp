@@ -28,22 +28,38 @@ class font_impl {
         /* attributes */
         bool mIsFontLoaded;
         std::string mTTFfile;
-        std::vector<float> mVertexData;
         int mWidth;
         int mHeight;
+        /* viewport that was current when setOthro2D was called,
+         * queued text is placed relative to it */
+        GLint mViewport[4];
         GLuint mVBO;
-        GLuint mProgram;
+        ProgramRef mProgram;
         GLuint mSampler;
-
-        GLuint mCharTextures[NUM_CHARS];
+        /* shader uniform variable locations */
+        GLint  mPMatIndex;
+        GLint  mTexIndex;
+
+        /* all glyphs are packed into a single texture, mGlyphCoords
+         * holds the atlas region of each glyph as u0, v0, u1, v1 */
+        GLuint mAtlas;
+        float mGlyphCoords[NUM_CHARS][4];
         int mAdvX[NUM_CHARS], mAdvY[NUM_CHARS];
         int mBearingX[NUM_CHARS], mBearingY[NUM_CHARS];
         int mCharWidth[NUM_CHARS], mCharHeight[NUM_CHARS];
+        int mGlyphWidth[NUM_CHARS], mGlyphHeight[NUM_CHARS];
         int mLoadedPixelSize, mNewLine;
+        /* changes whenever a font file is loaded */
+        unsigned long long mRevision;
+
+        /* text queued since the last flush per window id, six vertices
+         * per glyph with window position, atlas coordinate, color and
+         * the clip rectangle */
+        std::map<int, std::vector<float> > mBatches;
 
-        /* helper function to extract glyph of
-         * ASCII character pointed by pIndex*/
-        void extractGlyph(int pIndex);
+        /* helper function to extract glyph of ASCII character
+         * pCharacter into pBitmap, bottom row first */
+        void extractGlyph(int pCharacter, std::vector<unsigned char>& pBitmap);
 
         /* helper functions to bind and unbind
          * rendering resources */
@@ -54,17 +70,44 @@ class font_impl {
          * given font face and size if required */
         void destroyGLResources();
 
+        void flush(int pWindowId, int pWidth, int pHeight);
+
     public:
         font_impl();
         ~font_impl();
 
+        /* sets the coordinate space of text positions passed to
+         * queue, it is mapped to the viewport current at this call */
         void setOthro2D(int pWidth, int pHeight);
         void loadFont(const char* const pFile, int pFontSize);
         void loadSystemFont(const char* const pName, int pFontSize);
 
-        void render(int pWindowId,
-                    const float pPos[2], const float pColor[4], const char* pText,
-                    int pFontSize = -1, bool pIsVertical = false);
+        unsigned long long revision() const;
+
+        /* appends the glyph quads of pText to pVertices, the result can
+         * be queued any number of times while the font revision and
+         * the setOthro2D state stay the same */
+        void layout(const float pPos[2], const float pColor[4], const char* pText,
+                    int pFontSize, bool pIsVertical, std::vector<float>& pVertices) const;
+
+        /* adds text to the batch of this font for window pWindowId,
+         * nothing is drawn until flushAll is called for that window */
+        void queue(int pWindowId, const float pPos[2], const float pColor[4],
+                   const char* pText, int pFontSize = -1, bool pIsVertical = false);
+        void queue(int pWindowId, const std::vector<float>& pVertices);
+
+        /* text queued for window pWindowId after this call is clipped
+         * to the given window rectangle when it is flushed, until
+         * resetClipRect is called. Lets a grid of cells flush the text
+         * of all cells at once */
+        static void setClipRect(int pWindowId, int pX, int pY, int pWidth, int pHeight);
+        static void resetClipRect(int pWindowId);
+
+        /* draws the text queued for window pWindowId in all fonts, one
+         * draw call per font, pWidth and pHeight are the framebuffer
+         * dimensions. Text is clipped to the scissor rectangle if
+         * scissor testing is on */
+        static void flushAll(int pWindowId, int pWidth, int pHeight);
 };
 
 class _Font {
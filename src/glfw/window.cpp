@@ -19,13 +19,14 @@ namespace wtk
 {
 
 Widget::Widget()
-    : mWindow(NULL), mClose(false)
+    : mWindow(NULL), mClose(false), mDamaged(false)
 {
 }
 
 Widget::Widget(int pWidth, int pHeight, const char* pTitle, const Widget* pWindow, const bool invisible)
 {
-    mClose = false;
+    mClose   = false;
+    mDamaged = false;
 
     if (!glfwInit()) {
         std::cerr << "ERROR: GLFW wasn't able to initalize\n";
@@ -70,6 +71,18 @@ Widget::Widget(int pWidth, int pHeight, const char* pTitle, const Widget* pWindo
         static_cast<Widget*>(glfwGetWindowUserPointer(w))->hide();
     };
     glfwSetWindowCloseCallback(mWindow, closeCallback);
+
+    auto damageCallback = [](GLFWwindow* w)
+    {
+        static_cast<Widget*>(glfwGetWindowUserPointer(w))->mDamaged = true;
+    };
+    glfwSetWindowRefreshCallback(mWindow, damageCallback);
+
+    auto fbSizeCallback = [](GLFWwindow* w, int pW, int pH)
+    {
+        static_cast<Widget*>(glfwGetWindowUserPointer(w))->mDamaged = true;
+    };
+    glfwSetFramebufferSizeCallback(mWindow, fbSizeCallback);
 }
 
 Widget::~Widget()
@@ -88,6 +101,11 @@ void Widget::makeContextCurrent() const
     glfwMakeContextCurrent(mWindow);
 }
 
+void Widget::releaseContext() const
+{
+    glfwMakeContextCurrent(NULL);
+}
+
 long long Widget::getGLContextHandle()
 {
 #ifdef OS_WIN
@@ -159,6 +177,13 @@ void Widget::resetCloseFlag()
     }
 }
 
+bool Widget::takeDamage()
+{
+    bool damaged = mDamaged;
+    mDamaged = false;
+    return damaged;
+}
+
 void Widget::keyboardHandler(int pKey, int pScancode, int pAction, int pMods)
 {
     if (pKey == GLFW_KEY_ESCAPE && pAction == GLFW_PRESS) {
@@ -171,4 +196,9 @@ void Widget::pollEvents()
     glfwPollEvents();
 }
 
+void Widget::waitEvents(double pTimeout)
+{
+    glfwWaitEventsTimeout(pTimeout);
+}
+
 }
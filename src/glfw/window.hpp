@@ -33,6 +33,7 @@ class Widget {
     private:
         GLFWwindow* mWindow;
         bool        mClose;
+        bool        mDamaged;
 
         Widget();
 
@@ -45,6 +46,9 @@ class Widget {
 
         void makeContextCurrent() const;
 
+        /* detaches the context from the calling thread */
+        void releaseContext() const;
+
         long long getGLContextHandle();
 
         long long getDisplayHandle();
@@ -67,9 +71,17 @@ class Widget {
 
         void resetCloseFlag();
 
+        /* whether the contents of the window were lost, by exposing or
+         * resizing it, since the last call */
+        bool takeDamage();
+
         void keyboardHandler(int pKey, int pScancode, int pAction, int pMods);
 
         void pollEvents();
+
+        /* like pollEvents, but blocks until an event
+         * arrives or pTimeout seconds have passed */
+        void waitEvents(double pTimeout);
 };
 
 }
@@ -10,12 +10,17 @@
 #include <common.hpp>
 #include <fg/histogram.h>
 #include <histogram.hpp>
+#include <plot.hpp>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
 
 using namespace std;
 
@@ -49,6 +54,20 @@ const char *gHistBarFragmentShaderSrc =
 "   outColor = barColor;\n"
 "}";
 
+namespace
+{
+
+template<typename T>
+void storeCounts(const std::vector<size_t>& pCounts, void* pBins)
+{
+    const double top = double(std::numeric_limits<T>::max());
+    T* bins = static_cast<T*>(pBins);
+    for (size_t b=0; b<pCounts.size(); ++b)
+        bins[b] = T(std::min(double(pCounts[b]), top));
+}
+
+}
+
 namespace internal
 {
 
@@ -65,9 +84,7 @@ void hist_impl::bindResources(int pWindowId)
         // attach histogram bar vertices
         glBindBuffer(GL_ARRAY_BUFFER, mDecorVBO);
         glVertexAttribPointer(mPointIndex, 2, GL_FLOAT, GL_FALSE, 0, 0);
-        // attach histogram frequencies
-        glBindBuffer(GL_ARRAY_BUFFER, mHistogramVBO);
-        glVertexAttribPointer(mFreqIndex, 1, mGLType, GL_FALSE, 0, 0);
+        // histogram frequencies are attached below
         glVertexAttribDivisor(mFreqIndex, 1);
         glBindVertexArray(0);
         /* store the vertex array object corresponding to
@@ -76,6 +93,7 @@ void hist_impl::bindResources(int pWindowId)
     }
 
     glBindVertexArray(mVAOMap[pWindowId]);
+    attachDataBuffer(mFreqIndex, 1, mGLType);
 }
 
 void hist_impl::unbindResources() const
@@ -86,12 +104,12 @@ void hist_impl::unbindResources() const
 
 hist_impl::hist_impl(unsigned pNBins, fg::dtype pDataType)
  : Chart2D(), mDataType(pDataType), mGLType(gl_dtype(mDataType)),
-   mNBins(pNBins), mHistogramVBO(0), mHistogramVBOSize(0), mHistBarProgram(0),
+   mNBins(pNBins), mDrawCount(pNBins), mBinSize(0), mHistBarProgram(),
    mHistBarMatIndex(0), mHistBarColorIndex(0), mHistBarYMaxIndex(0),
    mPointIndex(0), mFreqIndex(0)
 {
     CheckGL("Begin hist_impl::hist_impl");
-    mHistBarProgram = initShaders(gHistBarVertexShaderSrc, gHistBarFragmentShaderSrc);
+    mHistBarProgram = acquireProgram(gHistBarVertexShaderSrc, gHistBarFragmentShaderSrc);
 
     mPointIndex        = glGetAttribLocation (mHistBarProgram, "point");
     mFreqIndex         = glGetAttribLocation (mHistBarProgram, "freq");
@@ -101,32 +119,16 @@ hist_impl::hist_impl(unsigned pNBins, fg::dtype pDataType)
     mHistBarYMaxIndex  = glGetUniformLocation(mHistBarProgram, "ymax");
 
     switch(mGLType) {
-        case GL_FLOAT:
-            mHistogramVBO = createBuffer<float>(GL_ARRAY_BUFFER, mNBins, NULL, GL_DYNAMIC_DRAW);
-            mHistogramVBOSize = mNBins*sizeof(float);
-            break;
-        case GL_INT:
-            mHistogramVBO = createBuffer<int>(GL_ARRAY_BUFFER, mNBins, NULL, GL_DYNAMIC_DRAW);
-            mHistogramVBOSize = mNBins*sizeof(int);
-            break;
-        case GL_UNSIGNED_INT:
-            mHistogramVBO = createBuffer<unsigned>(GL_ARRAY_BUFFER, mNBins, NULL, GL_DYNAMIC_DRAW);
-            mHistogramVBOSize = mNBins*sizeof(unsigned);
-            break;
-        case GL_SHORT:
-            mHistogramVBO = createBuffer<short>(GL_ARRAY_BUFFER, mNBins, NULL, GL_DYNAMIC_DRAW);
-            mHistogramVBOSize = mNBins*sizeof(short);
-            break;
-        case GL_UNSIGNED_SHORT:
-            mHistogramVBO = createBuffer<unsigned short>(GL_ARRAY_BUFFER, mNBins, NULL, GL_DYNAMIC_DRAW);
-            mHistogramVBOSize = mNBins*sizeof(unsigned short);
-            break;
-        case GL_UNSIGNED_BYTE:
-            mHistogramVBO = createBuffer<unsigned char>(GL_ARRAY_BUFFER, mNBins, NULL, GL_DYNAMIC_DRAW);
-            mHistogramVBOSize = mNBins*sizeof(unsigned char);
-            break;
+        case GL_FLOAT:          mBinSize = sizeof(float);          break;
+        case GL_INT:            mBinSize = sizeof(int);            break;
+        case GL_UNSIGNED_INT:   mBinSize = sizeof(unsigned);       break;
+        case GL_SHORT:          mBinSize = sizeof(short);          break;
+        case GL_UNSIGNED_SHORT: mBinSize = sizeof(unsigned short); break;
+        case GL_UNSIGNED_BYTE:  mBinSize = sizeof(unsigned char);  break;
         default: fg::TypeError("Plot::Plot", __LINE__, 1, mDataType);
     }
+    setDataLayout(mGLType, 1);
+    createDataBuffer(mNBins*mBinSize);
     CheckGL("End hist_impl::hist_impl");
 }
 
@@ -137,8 +139,7 @@ hist_impl::~hist_impl()
         GLuint vao = it->second;
         glDeleteVertexArrays(1, &vao);
     }
-    glDeleteBuffers(1, &mHistogramVBO);
-    glDeleteProgram(mHistBarProgram);
+    releaseProgram(mHistBarProgram);
     CheckGL("End hist_impl::~hist_impl");
 }
 
@@ -148,20 +149,131 @@ void hist_impl::setBarColor(float r, float g, float b)
     mBarColor[1] = g;
     mBarColor[2] = b;
     mBarColor[3] = 1.0f;
+    markDirty();
+}
+
+void hist_impl::resize(unsigned pNBins)
+{
+    resizeDataBuffer(pNBins*mBinSize);
+    mNBins     = pNBins;
+    mDrawCount = pNBins;
+}
+
+void hist_impl::setDrawCount(unsigned pCount)
+{
+    mDrawCount = std::min(pCount, mNBins);
+    markDirty();
+}
+
+void hist_impl::fill(const void* pSamples, GLenum pType, size_t pCount, float pLow, float pHigh)
+{
+    if (!(pHigh > pLow))
+        throw fg::ArgumentError("Histogram::fill", __LINE__, 4,
+                                "Upper limit has to be greater than lower limit");
+
+    std::vector<size_t> counts(mNBins);
+    computeHistogram(pSamples, pType, pCount, pLow, pHigh, mNBins, counts.data());
+
+    /* the converted counts are written straight into the data buffer */
+    void* bins = map(fg::FG_MAP_WRITE);
+    switch(mGLType) {
+        case GL_FLOAT:          storeCounts<float>(counts, bins); break;
+        case GL_INT:            storeCounts<int>(counts, bins); break;
+        case GL_UNSIGNED_INT:   storeCounts<unsigned>(counts, bins); break;
+        case GL_SHORT:          storeCounts<short>(counts, bins); break;
+        case GL_UNSIGNED_SHORT: storeCounts<unsigned short>(counts, bins); break;
+        case GL_BYTE:           storeCounts<signed char>(counts, bins); break;
+        case GL_UNSIGNED_BYTE:  storeCounts<unsigned char>(counts, bins); break;
+    }
+    unmap();
+}
+
+void hist_impl::fill(GLuint pSource, size_t pOffset, GLenum pType, unsigned pComponents,
+                     unsigned pComponent, size_t pCount, float pLow, float pHigh)
+{
+    if (!(pHigh > pLow))
+        throw fg::ArgumentError("Histogram::fill", __LINE__, 3,
+                                "Upper limit has to be greater than lower limit");
+
+    CheckGL("Begin hist_impl::fill");
+    if (!mBinning)
+        mBinning.reset(new BinningPass(mGLType));
+    if (mBinning->run(currentWindowId(), pSource, pOffset, pType, pComponents, pComponent, pCount,
+                      pLow, pHigh, mNBins, mDataVBO)) {
+        dataBufferWritten();
+    } else {
+        /* too many samples for a buffer texture, bin them on the CPU */
+        size_t valueSize = gl_sizeof(pType);
+        std::vector<char> tuples(pCount * pComponents * valueSize);
+        std::vector<char> samples(pCount * valueSize);
+        glBindBuffer(GL_COPY_READ_BUFFER, pSource);
+        glGetBufferSubData(GL_COPY_READ_BUFFER, pOffset, tuples.size(), tuples.data());
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        for (size_t i=0; i<pCount; ++i)
+            memcpy(&samples[i*valueSize], &tuples[(i*pComponents + pComponent)*valueSize], valueSize);
+        fill(samples.data(), pType, pCount, pLow, pHigh);
+    }
+    CheckGL("End hist_impl::fill");
+}
+
+void hist_impl::fill(const std::shared_ptr<image_impl>& pImage, float pLow, float pHigh, unsigned pChannel)
+{
+    unsigned channels = unsigned(pImage->channelCount());
+    if (pChannel >= channels)
+        throw fg::ArgumentError("Histogram::fill", __LINE__, 4,
+                                "Channel has to be less than the channel count of the image");
+
+    size_t pixels = size_t(pImage->width()) * pImage->height();
+    fill(pImage->dataBuffer(), 0, gl_dtype(pImage->channelType()), channels, pChannel,
+         pixels, pLow, pHigh);
+}
+
+void hist_impl::fill(const std::shared_ptr<AbstractChart>& pChart, float pLow, float pHigh)
+{
+    size_t offset = 0;
+    GLuint buffer = pChart->dataBuffer(&offset);
+    fill(buffer, offset, pChart->dataType(), pChart->dataComponents(), 1,
+         pChart->dataCount(), pLow, pHigh);
+    pChart->fenceDataBuffer();
+}
+
+unsigned hist_impl::numBins() const
+{
+    return mNBins;
+}
+
+unsigned hist_impl::drawCount() const
+{
+    return mDrawCount;
 }
 
 GLuint hist_impl::vbo() const
 {
-    return mHistogramVBO;
+    return mDataVBO;
 }
 
 size_t hist_impl::size() const
 {
-    return mHistogramVBOSize;
+    return mDataSize;
+}
+
+size_t hist_impl::boundsCount() const
+{
+    return mDrawCount;
+}
+
+void hist_impl::applyDataBounds(const float* pMin, const float* pMax)
+{
+    /* the x axis spans the range that was binned, which
+     * the frequencies don't tell */
+    if (std::isfinite(pMax[0]))
+        applyAxesLimits(xmax(), xmin(), std::max(pMax[0], 0.0f), 0.0f, zmax(), zmin());
 }
 
 void hist_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
 {
+    updateAutoAxes(pWindowId);
+
     float w = float(pVPW - (mLeftMargin+mRightMargin+mTickSize));
     float h = float(pVPH - (mBottomMargin+mTopMargin+mTickSize));
     float offset_x = (2.0f * (mLeftMargin+mTickSize) + (w - pVPW)) / pVPW;
@@ -184,7 +296,7 @@ void hist_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
     glUseProgram(mHistBarProgram);
     glUniformMatrix4fv(mHistBarMatIndex, 1, GL_FALSE, glm::value_ptr(trans));
     glUniform4fv(mHistBarColorIndex, 1, mBarColor);
-    glUniform1f(mHistBarNBinsIndex, (GLfloat)mNBins);
+    glUniform1f(mHistBarNBinsIndex, (GLfloat)mDrawCount);
     glUniform1f(mHistBarYMaxIndex, ymax());
 
     /* render a rectangle for each bin. Same
@@ -192,8 +304,9 @@ void hist_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
      * for each bin. This is done by OpenGL feature of
      * instanced rendering */
     hist_impl::bindResources(pWindowId);
-    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, mNBins);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, mDrawCount);
     hist_impl::unbindResources();
+    fenceDataBuffer();
 
     glUseProgram(0);
     /* Stop clipping */
@@ -242,11 +355,71 @@ void Histogram::setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin
     value->setAxesLimits(pXmax, pXmin, pYmax, pYmin);
 }
 
+void Histogram::setAutoAxes(bool pAuto)
+{
+    value->setAutoAxes(pAuto);
+}
+
 void Histogram::setAxesTitles(const char* pXTitle, const char* pYTitle)
 {
     value->setAxesTitles(pXTitle, pYTitle);
 }
 
+void Histogram::resize(unsigned pNBins)
+{
+    value->resize(pNBins);
+}
+
+void Histogram::setDrawCount(unsigned pCount)
+{
+    value->setDrawCount(pCount);
+}
+
+void Histogram::fill(const Image& pImage, float pLow, float pHigh, unsigned pChannel)
+{
+    value->fill(pImage.get()->impl(), pLow, pHigh, pChannel);
+}
+
+void Histogram::fill(const Plot& pPlot, float pLow, float pHigh)
+{
+    value->fill(pPlot.get()->impl(), pLow, pHigh);
+}
+
+void Histogram::fill(const float* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_FLOAT, pCount, pLow, pHigh);
+}
+
+void Histogram::fill(const int* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_INT, pCount, pLow, pHigh);
+}
+
+void Histogram::fill(const unsigned* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_UNSIGNED_INT, pCount, pLow, pHigh);
+}
+
+void Histogram::fill(const short* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_SHORT, pCount, pLow, pHigh);
+}
+
+void Histogram::fill(const unsigned short* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_UNSIGNED_SHORT, pCount, pLow, pHigh);
+}
+
+void Histogram::fill(const signed char* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_BYTE, pCount, pLow, pHigh);
+}
+
+void Histogram::fill(const unsigned char* pSamples, size_t pCount, float pLow, float pHigh)
+{
+    value->fill(pSamples, GL_UNSIGNED_BYTE, pCount, pLow, pHigh);
+}
+
 float Histogram::xmax() const
 {
     return value->xmax();
@@ -277,6 +450,46 @@ unsigned Histogram::size() const
     return (unsigned)value->size();
 }
 
+void Histogram::markDirty()
+{
+    value->markDirty();
+}
+
+void Histogram::vboWritten()
+{
+    value->vboWritten();
+}
+
+void Histogram::setStreaming(bool pStreaming)
+{
+    value->setStreaming(pStreaming);
+}
+
+bool Histogram::streaming() const
+{
+    return value->streaming();
+}
+
+void Histogram::upload(const void* pData)
+{
+    value->upload(pData);
+}
+
+void Histogram::update(const void* pData, unsigned pOffset, unsigned pSize)
+{
+    value->update(pData, pOffset, pSize);
+}
+
+void* Histogram::map(MapAccess pAccess)
+{
+    return value->map(pAccess);
+}
+
+void Histogram::unmap()
+{
+    value->unmap();
+}
+
 internal::_Histogram* Histogram::get() const
 {
     return value;
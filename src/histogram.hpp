@@ -11,6 +11,8 @@
 
 #include <common.hpp>
 #include <chart.hpp>
+#include <image.hpp>
+#include <binning.hpp>
 #include <memory>
 #include <map>
 
@@ -23,11 +25,11 @@ class hist_impl : public Chart2D {
         fg::dtype mDataType;
         GLenum    mGLType;
         GLuint    mNBins;
+        GLuint    mDrawCount;
+        size_t    mBinSize;
         float     mBarColor[4];
         /* OpenGL Objects */
-        GLuint    mHistogramVBO;
-        size_t    mHistogramVBOSize;
-        GLuint    mHistBarProgram;
+        ProgramRef mHistBarProgram;
         /* internal shader attributes for mHistBarProgram
         * shader program to render histogram bars for each
         * bin*/
@@ -40,16 +42,44 @@ class hist_impl : public Chart2D {
 
         std::map<int, GLuint> mVAOMap;
 
+        /* bins data of other renderables on the GPU */
+        std::unique_ptr<BinningPass> mBinning;
+
         /* bind and unbind helper functions
          * for rendering resources */
         void bindResources(int pWindowId);
         void unbindResources() const;
 
+        /* axes limits follow the bins that are drawn,
+         * the y axis starts at zero */
+        size_t boundsCount() const;
+        void applyDataBounds(const float* pMin, const float* pMax);
+
+        /* bins component pComponent of pCount tuples of pComponents
+         * values of type pType at byte pOffset of buffer pSource */
+        void fill(GLuint pSource, size_t pOffset, GLenum pType, unsigned pComponents,
+                  unsigned pComponent, size_t pCount, float pLow, float pHigh);
+
     public:
         hist_impl(unsigned pNBins, fg::dtype pDataType);
         ~hist_impl();
 
         void setBarColor(float r, float g, float b);
+        /* changes the number of bins, contents of the first
+         * min(old, new) bins are kept */
+        void resize(unsigned pNBins);
+        /* draws only the first pCount bins */
+        void setDrawCount(unsigned pCount);
+        /* bins pCount samples of type pType over [pLow, pHigh] and
+         * uploads the counts, which saturate at the largest value of
+         * the histogram data type */
+        void fill(const void* pSamples, GLenum pType, size_t pCount, float pLow, float pHigh);
+        /* bins channel pChannel of the pixels of pImage, or the y values
+         * of the points pChart draws, on the GPU */
+        void fill(const std::shared_ptr<image_impl>& pImage, float pLow, float pHigh, unsigned pChannel);
+        void fill(const std::shared_ptr<AbstractChart>& pChart, float pLow, float pHigh);
+        unsigned numBins() const;
+        unsigned drawCount() const;
         GLuint vbo() const;
         size_t size() const;
 
@@ -76,10 +106,34 @@ class _Histogram {
             hst->setAxesLimits(pXmax, pXmin, pYmax, pYmin);
         }
 
+        inline void setAutoAxes(bool pAuto) {
+            hst->setAutoAxes(pAuto);
+        }
+
         inline void setAxesTitles(const char* pXTitle, const char* pYTitle) {
             hst->setAxesTitles(pXTitle, pYTitle);
         }
 
+        inline void resize(unsigned pNBins) {
+            hst->resize(pNBins);
+        }
+
+        inline void setDrawCount(unsigned pCount) {
+            hst->setDrawCount(pCount);
+        }
+
+        inline void fill(const void* pSamples, GLenum pType, size_t pCount, float pLow, float pHigh) {
+            hst->fill(pSamples, pType, pCount, pLow, pHigh);
+        }
+
+        inline void fill(const std::shared_ptr<image_impl>& pImage, float pLow, float pHigh, unsigned pChannel) {
+            hst->fill(pImage, pLow, pHigh, pChannel);
+        }
+
+        inline void fill(const std::shared_ptr<AbstractChart>& pChart, float pLow, float pHigh) {
+            hst->fill(pChart, pLow, pHigh);
+        }
+
         inline float xmax() const {
             return hst->xmax();
         }
@@ -103,6 +157,38 @@ class _Histogram {
         inline size_t size() const {
             return hst->size();
         }
+
+        inline void markDirty() {
+            hst->markDirty();
+        }
+
+        inline void vboWritten() {
+            hst->dataBufferWritten();
+        }
+
+        inline void setStreaming(bool pStreaming) {
+            hst->setStreaming(pStreaming);
+        }
+
+        inline bool streaming() const {
+            return hst->streaming();
+        }
+
+        inline void upload(const void* pData) {
+            hst->upload(pData);
+        }
+
+        inline void update(const void* pData, unsigned pOffset, unsigned pSize) {
+            hst->update(pData, pOffset, pSize);
+        }
+
+        inline void* map(fg::MapAccess pAccess) {
+            return hst->map(pAccess);
+        }
+
+        inline void unmap() {
+            hst->unmap();
+        }
 };
 
 }
@@ -10,6 +10,7 @@
 #include <fg/image.h>
 #include <image.hpp>
 #include <common.hpp>
+#include <algorithm>
 #include <mutex>
 #include <map>
 
@@ -30,32 +31,77 @@ static const char* vertex_shader_code =
 
 static const char* fragment_shader_code =
 "#version 330\n"
-"const int size = 259;\n"
 "uniform float cmaplen;\n"
-"layout(std140) uniform ColorMap\n"
-"{\n"
-"    vec4 ch[size];\n"
-"};\n"
+"uniform sampler1D colormap;\n"
 "uniform sampler2D tex;\n"
-"uniform bool isGrayScale;\n"
+"uniform sampler2D range;\n"
+"uniform int channels;\n"
+"uniform bool autoRange;\n"
+"uniform vec2 dataRange;\n"
 "in vec2 texcoord;\n"
 "out vec4 fragColor;\n"
 "void main()\n"
 "{\n"
+"    vec2 lohi   = autoRange ? texelFetch(range, ivec2(0, 0), 0).xy : dataRange;\n"
 "    vec4 tcolor = texture(tex, texcoord);\n"
-"    vec4 clrs = vec4(1, 0, 0, 1);\n"
-"    if(isGrayScale)\n"
-"        clrs = vec4(tcolor.r, tcolor.r, tcolor.r, 1);\n"
-"    else\n"
-"        clrs = tcolor;\n"
-"    vec4 fidx  = (cmaplen-1) * clrs;\n"
-"    ivec4 idx  = ivec4(fidx.x, fidx.y, fidx.z, fidx.w);\n"
-"    float r_ch = ch[idx.x].r;\n"
-"    float g_ch = ch[idx.y].g;\n"
-"    float b_ch = ch[idx.z].b;\n"
+"    vec4 clrs = clamp((tcolor - lohi.x) / max(lohi.y - lohi.x, 1e-30), 0.0, 1.0);\n"
+"    if(channels==1)\n"
+"        clrs = vec4(clrs.r, clrs.r, clrs.r, 1);\n"
+"    else if(channels==2)\n"
+"        clrs.b = 0;\n"
+"    vec4 cpos  = (0.5 + (cmaplen-1) * clrs) / cmaplen;\n"
+"    float r_ch = texture(colormap, cpos.x).r;\n"
+"    float g_ch = texture(colormap, cpos.y).g;\n"
+"    float b_ch = texture(colormap, cpos.z).b;\n"
 "    fragColor = vec4(r_ch, g_ch , b_ch, 1);\n"
 "}\n";
 
+static const char* range_vertex_shader_code =
+"#version 330\n"
+"layout(location = 0) in vec3 pos;\n"
+"void main() {\n"
+"    gl_Position = vec4(pos,1.0);\n"
+"}\n";
+
+/* each output texel holds the minimum and maximum of a 4x4 block of
+ * the source, which holds either image texels with the given number
+ * of color channels or, when channels is 0, results of an earlier pass */
+static const char* range_fragment_shader_code =
+"#version 330\n"
+"uniform sampler2D tex;\n"
+"uniform ivec2 extent;\n"
+"uniform int channels;\n"
+"out vec2 result;\n"
+"void main()\n"
+"{\n"
+"    ivec2 base = 4 * ivec2(gl_FragCoord.xy);\n"
+"    vec2 r = vec2(3.402823e38, -3.402823e38);\n"
+"    for (int j=0; j<4; ++j) {\n"
+"        for (int i=0; i<4; ++i) {\n"
+"            vec4 t = texelFetch(tex, min(base + ivec2(i, j), extent - 1), 0);\n"
+"            vec2 v = (channels==0 ? t.xy : t.rr);\n"
+"            if (channels > 1) v = vec2(min(v.x, t.g), max(v.y, t.g));\n"
+"            if (channels > 2) v = vec2(min(v.x, t.b), max(v.y, t.b));\n"
+"            r = vec2(min(r.x, v.x), max(r.y, v.y));\n"
+"        }\n"
+"    }\n"
+"    result = r;\n"
+"}\n";
+
+/* integral data is normalized when it is loaded into the texture */
+static float normalizationFactor(GLenum pType)
+{
+    switch(pType) {
+        case GL_INT:            return 2147483647.0f;
+        case GL_UNSIGNED_INT:   return 4294967295.0f;
+        case GL_SHORT:          return 32767.0f;
+        case GL_UNSIGNED_SHORT: return 65535.0f;
+        case GL_BYTE:           return 127.0f;
+        case GL_UNSIGNED_BYTE:  return 255.0f;
+        default:                return 1.0f;
+    }
+}
+
 GLuint imageQuadVAO(int pWindowId)
 {
     static std::map<int, GLuint> mVAOMap;
@@ -109,9 +155,14 @@ void image_impl::unbindResources() const
 image_impl::image_impl(unsigned pWidth, unsigned pHeight,
                        fg::ChannelFormat pFormat, fg::dtype pDataType)
     : mWidth(pWidth), mHeight(pHeight),
-      mFormat(pFormat), mGLformat(gl_ctype(mFormat)), mGLiformat(gl_ictype(mFormat)),
-      mDataType(pDataType), mGLType(gl_dtype(mDataType))
+      mFormat(pFormat), mGLformat(gl_ctype(mFormat)), mGLiformat(gl_ictype(mFormat, pDataType)),
+      mDataType(pDataType), mGLType(gl_dtype(mDataType)),
+      mPBOIndex(0), mTexPBOIndex(-1), mRectRevision(0), mTexRevision(0), mDataRevision(nextRevision()), mMapped(false),
+      mAutoRange(false), mRangeStale(true), mRangeProgram(), mFramebuffer(0)
 {
+    mDataRange[0] = 0.0f;
+    mDataRange[1] = 1.0f;
+
     CheckGL("Begin image_impl::image_impl");
 
     // Initialize OpenGL Items
@@ -125,8 +176,7 @@ image_impl::image_impl(unsigned pWidth, unsigned pHeight,
     glTexImage2D(GL_TEXTURE_2D, 0, mGLiformat, mWidth, mHeight, 0, mGLformat, mGLType, NULL);
 
     CheckGL("Before PBO Initialization");
-    glGenBuffers(1, &mPBO);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBO);
+    glGenBuffers(2, mPBOs);
     size_t typeSize = 0;
     switch(mGLType) {
         case GL_INT:            typeSize = sizeof(int  );           break;
@@ -147,14 +197,18 @@ image_impl::image_impl(unsigned pWidth, unsigned pHeight,
         case fg::FG_BGRA:          formatSize = 4;   break;
         default: formatSize = 1; break;
     }
-    mPBOsize = mWidth * mHeight * formatSize * typeSize;
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, mPBOsize, NULL, GL_STREAM_COPY);
+    mPixelSize = formatSize * typeSize;
+    mPBOsize = mWidth * mHeight * mPixelSize;
+    for (int i=0; i<2; ++i) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[i]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, mPBOsize, NULL, GL_STREAM_COPY);
+    }
 
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
     CheckGL("After PBO Initialization");
 
-    mProgram = initShaders(vertex_shader_code, fragment_shader_code);
+    mProgram = acquireProgram(vertex_shader_code, fragment_shader_code);
 
     CheckGL("End image_impl::image_impl");
 }
@@ -162,21 +216,30 @@ image_impl::image_impl(unsigned pWidth, unsigned pHeight,
 image_impl::~image_impl()
 {
     CheckGL("Begin image_impl::~image_impl");
-    glDeleteBuffers(1, &mPBO);
+    glDeleteBuffers(2, mPBOs);
     glDeleteTextures(1, &mTex);
-    glDeleteProgram(mProgram);
+    if (!mRangeTextures.empty())
+        glDeleteTextures((GLsizei)mRangeTextures.size(), mRangeTextures.data());
+    if (mFramebuffer)
+        glDeleteFramebuffers(1, &mFramebuffer);
+    if (mRangeProgram)
+        releaseProgram(mRangeProgram);
+    releaseProgram(mProgram);
     CheckGL("End image_impl::~image_impl");
 }
 
-void image_impl::setColorMapUBOParams(GLuint ubo, GLuint size)
+void image_impl::setColorMapParams(GLuint tex, GLuint size)
 {
-    mColorMapUBO = ubo;
-    mUBOSize = size;
+    mColorMap = tex;
+    mColorMapLength = size;
 }
 
 void image_impl::keepAspectRatio(const bool keep)
 {
-    mKeepARatio = keep;
+    if (mKeepARatio != keep) {
+        mKeepARatio = keep;
+        markDirty();
+    }
 }
 
 unsigned image_impl::width() const { return mWidth; }
@@ -187,12 +250,254 @@ fg::ChannelFormat image_impl::pixelFormat() const { return mFormat; }
 
 fg::dtype image_impl::channelType() const { return mDataType; }
 
-unsigned image_impl::pbo() const { return mPBO; }
+unsigned image_impl::pbo() const { return mPBOs[mPBOIndex]; }
 
 unsigned image_impl::size() const { return (unsigned)mPBOsize; }
 
+GLuint image_impl::dataBuffer()
+{
+    if (mMapped)
+        throw fg::Error("image_impl::dataBuffer", __LINE__,
+                        "Pixel buffer is mapped", fg::FG_ERR_RUNTIME);
+    CheckGL("Begin image_impl::dataBuffer");
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[mPBOIndex]);
+    mUpdates.flush(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    CheckGL("End image_impl::dataBuffer");
+    return mPBOs[mPBOIndex];
+}
+
+void image_impl::upload(const void* pData)
+{
+    if (mMapped)
+        throw fg::Error("image_impl::upload", __LINE__,
+                        "Pixel buffer is mapped", fg::FG_ERR_RUNTIME);
+    CheckGL("Begin image_impl::upload");
+    /* the new data replaces any pending sub-rectangle */
+    mUpdates.clear();
+    if (mPBOIndex == mTexPBOIndex)
+        mPBOIndex = 1 - mPBOIndex;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[mPBOIndex]);
+    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, mPBOsize, pData);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    dataChanged();
+    CheckGL("End image_impl::upload");
+}
+
+void image_impl::update(const void* pData, unsigned pX, unsigned pY,
+                        unsigned pWidth, unsigned pHeight)
+{
+    if (mMapped)
+        throw fg::Error("image_impl::update", __LINE__,
+                        "Pixel buffer is mapped", fg::FG_ERR_RUNTIME);
+    if (pX > mWidth || pWidth > mWidth - pX || pY > mHeight || pHeight > mHeight - pY)
+        throw fg::Error("image_impl::update", __LINE__,
+                        "Update region exceeds the image", fg::FG_ERR_SIZE);
+    if (pWidth==0 || pHeight==0)
+        return;
+
+    /* rows of full width updates are contiguous
+     * and merge into a single range */
+    const unsigned char* src = (const unsigned char*)pData;
+    size_t rowSize = pWidth * mPixelSize;
+    for (unsigned r=0; r<pHeight; ++r) {
+        size_t offset = (size_t(pY + r) * mWidth + pX) * mPixelSize;
+        mUpdates.add(offset, src + r * rowSize, rowSize);
+    }
+
+    /* the texture can be brought up to date by loading the bounding
+     * box only if it held the data of the previous revision or if
+     * every change since then was a sub-rectangle update */
+    bool partial = (mTexRevision==mDataRevision || mRectRevision==mDataRevision);
+
+    if (mRectRevision==mDataRevision && mTexRevision!=mDataRevision) {
+        mDirtyRect[0] = std::min(mDirtyRect[0], pX);
+        mDirtyRect[1] = std::min(mDirtyRect[1], pY);
+        mDirtyRect[2] = std::max(mDirtyRect[2], pX + pWidth);
+        mDirtyRect[3] = std::max(mDirtyRect[3], pY + pHeight);
+    } else {
+        mDirtyRect[0] = pX;
+        mDirtyRect[1] = pY;
+        mDirtyRect[2] = pX + pWidth;
+        mDirtyRect[3] = pY + pHeight;
+    }
+    dataChanged();
+    mRectRevision = (partial ? mDataRevision : 0);
+}
+
+void* image_impl::map(fg::MapAccess pAccess)
+{
+    if (mMapped)
+        throw fg::Error("image_impl::map", __LINE__,
+                        "Pixel buffer is already mapped", fg::FG_ERR_RUNTIME);
+
+    CheckGL("Begin image_impl::map");
+    GLbitfield access = GL_MAP_WRITE_BIT;
+    if (pAccess==fg::FG_MAP_WRITE) {
+        /* pending sub-rectangles are overwritten as well. Invalidation
+         * avoids waiting for the texture loads of the previous data */
+        mUpdates.clear();
+        if (mPBOIndex == mTexPBOIndex)
+            mPBOIndex = 1 - mPBOIndex;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[mPBOIndex]);
+        access |= GL_MAP_INVALIDATE_BUFFER_BIT;
+    } else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[mPBOIndex]);
+        mUpdates.flush(GL_PIXEL_UNPACK_BUFFER);
+        access |= GL_MAP_READ_BIT;
+    }
+    void* ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, mPBOsize, access);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    mMapped = true;
+    CheckGL("End image_impl::map");
+    return ptr;
+}
+
+void image_impl::unmap()
+{
+    if (!mMapped)
+        return;
+
+    CheckGL("Begin image_impl::unmap");
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[mPBOIndex]);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    mMapped = false;
+    dataChanged();
+    CheckGL("End image_impl::unmap");
+}
+
+void image_impl::pboWritten()
+{
+    if (mMapped)
+        throw fg::Error("image_impl::pboWritten", __LINE__,
+                        "Pixel buffer is mapped", fg::FG_ERR_RUNTIME);
+    mUpdates.clear();
+    /* the texture no longer matches any sub-rectangle bookkeeping */
+    mRectRevision = 0;
+    dataChanged();
+}
+
+void image_impl::dataChanged()
+{
+    mDataRevision = nextRevision();
+    markDirty();
+}
+
+int image_impl::channelCount() const
+{
+    switch(mFormat) {
+        case fg::FG_GRAYSCALE: return 1;
+        case fg::FG_RG:        return 2;
+        case fg::FG_RGB:
+        case fg::FG_BGR:       return 3;
+        default:               return 4;
+    }
+}
+
+void image_impl::setDataRange(float pMin, float pMax)
+{
+    if (!(pMax > pMin))
+        throw fg::ArgumentError("Image::setDataRange", __LINE__, 2,
+                                "Maximum has to be greater than minimum");
+
+    float scale = normalizationFactor(mGLType);
+    mDataRange[0] = pMin / scale;
+    mDataRange[1] = pMax / scale;
+    mAutoRange = false;
+    markDirty();
+}
+
+void image_impl::setAutoDataRange(bool pAuto)
+{
+    if (mAutoRange != pAuto) {
+        mAutoRange  = pAuto;
+        mRangeStale = true;
+        markDirty();
+    }
+}
+
+void image_impl::computeRange(int pWindowId)
+{
+    CheckGL("Begin image_impl::computeRange");
+    if (mRangeTextures.empty()) {
+        unsigned w = mWidth;
+        unsigned h = mHeight;
+        do {
+            w = (w + 3) / 4;
+            h = (h + 3) / 4;
+            GLuint tex = 0;
+            glGenTextures(1, &tex);
+            glBindTexture(GL_TEXTURE_2D, tex);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, w, h, 0, GL_RG, GL_FLOAT, NULL);
+            mRangeTextures.push_back(tex);
+        } while (w > 1 || h > 1);
+        glGenFramebuffers(1, &mFramebuffer);
+        mRangeProgram = acquireProgram(range_vertex_shader_code, range_fragment_shader_code);
+    }
+
+    /* the window may render to a framebuffer object of its own */
+    GLint fbo = 0;
+    GLint viewport[4];
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean blend   = glIsEnabled(GL_BLEND);
+    GLboolean depth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffer);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+
+    glUseProgram(mRangeProgram);
+    int ext_loc = glGetUniformLocation(mRangeProgram, "extent");
+    int chn_loc = glGetUniformLocation(mRangeProgram, "channels");
+    glUniform1i(glGetUniformLocation(mRangeProgram, "tex"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    bindResources(pWindowId);
+
+    int channels = std::min(channelCount(), 3);
+    GLuint src = mTex;
+    unsigned w = mWidth;
+    unsigned h = mHeight;
+    for (size_t i=0; i<mRangeTextures.size(); ++i) {
+        glUniform2i(ext_loc, w, h);
+        glUniform1i(chn_loc, i==0 ? channels : 0);
+        w = (w + 3) / 4;
+        h = (h + 3) / 4;
+        glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                               GL_TEXTURE_2D, mRangeTextures[i], 0);
+        glViewport(0, 0, w, h);
+        glBindTexture(GL_TEXTURE_2D, src);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        src = mRangeTextures[i];
+    }
+
+    unbindResources();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+
+    if (depth)
+        glEnable(GL_DEPTH_TEST);
+    if (blend)
+        glEnable(GL_BLEND);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    mRangeStale = false;
+    CheckGL("End image_impl::computeRange");
+}
+
 void image_impl::render(int pWindowId, int pX, int pY, int pViewPortWidth, int pViewPortHeight)
 {
+    if (mMapped)
+        throw fg::Error("image_impl::render", __LINE__,
+                        "Pixel buffer is mapped", fg::FG_ERR_RUNTIME);
+
     float xscale = 1.f;
     float yscale = 1.f;
     if (mKeepARatio) {
@@ -210,30 +515,66 @@ void image_impl::render(int pWindowId, int pX, int pY, int pViewPortWidth, int p
     }
     glm::mat4 strans = glm::scale(glm::mat4(1.0f), glm::vec3(xscale, yscale, 1));
 
+    // load texture from PBO
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mTex);
+    // bind PBO to load data into texture
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBOs[mPBOIndex]);
+    if (mTexRevision!=mDataRevision) {
+        mUpdates.flush(GL_PIXEL_UNPACK_BUFFER);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (mRectRevision==mDataRevision) {
+            /* only sub-rectangles changed since the last load */
+            size_t offset = (size_t(mDirtyRect[1]) * mWidth + mDirtyRect[0]) * mPixelSize;
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, mWidth);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, mDirtyRect[0], mDirtyRect[1],
+                            mDirtyRect[2]-mDirtyRect[0], mDirtyRect[3]-mDirtyRect[1],
+                            mGLformat, mGLType, reinterpret_cast<void*>(offset));
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mWidth, mHeight, mGLformat, mGLType, 0);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        mTexRevision = mDataRevision;
+        mTexPBOIndex = mPBOIndex;
+        mRangeStale  = true;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (mAutoRange && mRangeStale)
+        computeRange(pWindowId);
+
     glUseProgram(mProgram);
     // get uniform locations
     int mat_loc = glGetUniformLocation(mProgram, "matrix");
     int tex_loc = glGetUniformLocation(mProgram, "tex");
-    int chn_loc = glGetUniformLocation(mProgram, "isGrayScale");
+    int rng_loc = glGetUniformLocation(mProgram, "range");
+    int chn_loc = glGetUniformLocation(mProgram, "channels");
+    int aut_loc = glGetUniformLocation(mProgram, "autoRange");
+    int drg_loc = glGetUniformLocation(mProgram, "dataRange");
     int cml_loc = glGetUniformLocation(mProgram, "cmaplen");
-    int ubo_idx = glGetUniformBlockIndex(mProgram, "ColorMap");
+    int cmp_loc = glGetUniformLocation(mProgram, "colormap");
 
-    glUniform1i(chn_loc, mFormat==1);
-    // load texture from PBO
-    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(chn_loc, channelCount());
     glUniform1i(tex_loc, 0);
     glBindTexture(GL_TEXTURE_2D, mTex);
-    // bind PBO to load data into texture
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mPBO);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, mWidth, mHeight, mGLformat, mGLType, 0);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glUniform1i(aut_loc, mAutoRange);
+    glUniform2fv(drg_loc, 1, mDataRange);
+    glUniform1i(rng_loc, 1);
+    if (mAutoRange) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, mRangeTextures.back());
+        glActiveTexture(GL_TEXTURE0);
+    }
 
     glUniformMatrix4fv(mat_loc, 1, GL_FALSE, glm::value_ptr(strans));
 
-    glUniform1f(cml_loc, (GLfloat)mUBOSize);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, mColorMapUBO);
-    glUniformBlockBinding(mProgram, ubo_idx, 0);
+    glUniform1f(cml_loc, (GLfloat)mColorMapLength);
+    glUniform1i(cmp_loc, 2);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_1D, mColorMap);
+    glActiveTexture(GL_TEXTURE0);
 
     CheckGL("Before render");
 
@@ -242,8 +583,14 @@ void image_impl::render(int pWindowId, int pX, int pY, int pViewPortWidth, int p
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
     unbindResources();
 
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    if (mAutoRange) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, 0);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     // ubind the shader program
     glUseProgram(0);
@@ -291,6 +638,39 @@ unsigned Image::size() const {
     return (unsigned)value->size();
 }
 
+void Image::markDirty() {
+    value->markDirty();
+}
+
+void Image::pboWritten() {
+    value->pboWritten();
+}
+
+void Image::upload(const void* pData) {
+    value->upload(pData);
+}
+
+void Image::update(const void* pData, unsigned pX, unsigned pY,
+                   unsigned pWidth, unsigned pHeight) {
+    value->update(pData, pX, pY, pWidth, pHeight);
+}
+
+void* Image::map(MapAccess pAccess) {
+    return value->map(pAccess);
+}
+
+void Image::unmap() {
+    value->unmap();
+}
+
+void Image::setDataRange(float pMin, float pMax) {
+    value->setDataRange(pMin, pMax);
+}
+
+void Image::setAutoDataRange(bool pAuto) {
+    value->setAutoDataRange(pAuto);
+}
+
 internal::_Image* Image::get() const {
     return value;
 }
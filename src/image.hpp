@@ -11,6 +11,10 @@
 
 #include <common.hpp>
 #include <memory>
+#include <vector>
+
+/* vertex array of the quad images are drawn with, one per window */
+GLuint imageQuadVAO(int pWindowId);
 
 namespace internal
 {
@@ -24,16 +28,54 @@ class image_impl : public AbstractRenderable {
         GLenum    mGLiformat;
         fg::dtype mDataType;
         GLenum    mGLType;
-        /* internal resources for interop */
+        /* internal resources for interop. Full uploads go to the PBO
+         * the texture was not last loaded from, so that writing the
+         * next frame doesn't wait for the texture load of the previous
+         * one. mPBOs[mPBOIndex] holds the newest data, mPBOs[mTexPBOIndex]
+         * is the one last loaded into the texture, -1 before any load */
         size_t   mPBOsize;
-        GLuint   mPBO;
+        size_t   mPixelSize;
+        GLuint   mPBOs[2];
+        int      mPBOIndex;
+        int      mTexPBOIndex;
         GLuint   mTex;
-        GLuint   mProgram;
+        ProgramRef mProgram;
 
-        GLuint   mColorMapUBO;
-        GLuint   mUBOSize;
+        GLuint   mColorMap;
+        GLuint   mColorMapLength;
         bool     mKeepARatio;
 
+        /* rows of sub-rectangle updates not yet written to the PBO */
+        BufferUpdates      mUpdates;
+        /* bounding box {x0, y0, x1, y1} of the sub-rectangles written
+         * since the texture was last loaded, loading it suffices while
+         * the data revision matches mRectRevision */
+        unsigned           mDirtyRect[4];
+        unsigned long long mRectRevision;
+        /* revision of the data the texture was last loaded from */
+        unsigned long long mTexRevision;
+        /* changes only when pixels are written, unlike the renderable
+         * revision that also changes with the display parameters */
+        unsigned long long mDataRevision;
+        /* set between map and unmap */
+        bool               mMapped;
+
+        /* texel values mapped to the ends of the colormap. With the
+         * automatic range, reduction passes write the minimum and
+         * maximum of the texture to the single texel of the last of
+         * mRangeTextures, which the image shader reads */
+        float               mDataRange[2];
+        bool                mAutoRange;
+        bool                mRangeStale;
+        ProgramRef          mRangeProgram;
+        GLuint              mFramebuffer;
+        std::vector<GLuint> mRangeTextures;
+
+        void computeRange(int pWindowId);
+
+        /* marks the pixel data as modified */
+        void dataChanged();
+
         /* helper functions to bind and unbind
          * resources for render quad primitive */
         void bindResources(int pWindowId);
@@ -43,7 +85,7 @@ class image_impl : public AbstractRenderable {
         image_impl(unsigned pWidth, unsigned pHeight, fg::ChannelFormat pFormat, fg::dtype pDataType);
         ~image_impl();
 
-        void setColorMapUBOParams(GLuint ubo, GLuint size);
+        void setColorMapParams(GLuint tex, GLuint size);
         void keepAspectRatio(const bool keep=true);
 
         unsigned width() const;
@@ -52,6 +94,30 @@ class image_impl : public AbstractRenderable {
         fg::dtype channelType() const;
         unsigned pbo() const;
         unsigned size() const;
+        int channelCount() const;
+        /* returns pbo() after writing pending sub-rectangles to it */
+        GLuint dataBuffer();
+
+        /* copies size() bytes from pData to the PBO not used
+         * by the last texture load, which becomes pbo() */
+        void upload(const void* pData);
+        /* copies a pWidth x pHeight block of tightly packed pixels
+         * from pData to the region of the image at (pX, pY). Only the
+         * bounding box of the regions updated since the last draw is
+         * loaded into the texture */
+        void update(const void* pData, unsigned pX, unsigned pY,
+                    unsigned pWidth, unsigned pHeight);
+        /* returns a pointer to the size() bytes of the PBO, which are
+         * loaded into the texture in full after unmap. FG_MAP_WRITE
+         * maps the PBO not used by the last texture load */
+        void* map(fg::MapAccess pAccess);
+        void unmap();
+        /* to be called after pbo() was written in full on the GPU, drops
+         * pending sub-rectangles so that the texture is loaded in full */
+        void pboWritten();
+
+        void setDataRange(float pMin, float pMax);
+        void setAutoDataRange(bool pAuto);
 
         void render(int pWindowId, int pX, int pY, int pViewPortWidth, int pViewPortHeight);
 };
@@ -79,6 +145,25 @@ class _Image {
         inline GLuint pbo() const { return img->pbo(); }
 
         inline size_t size() const { return img->size(); }
+
+        inline void markDirty() { img->markDirty(); }
+
+        inline void pboWritten() { img->pboWritten(); }
+
+        inline void upload(const void* pData) { img->upload(pData); }
+
+        inline void update(const void* pData, unsigned pX, unsigned pY,
+                           unsigned pWidth, unsigned pHeight) {
+            img->update(pData, pX, pY, pWidth, pHeight);
+        }
+
+        inline void* map(fg::MapAccess pAccess) { return img->map(pAccess); }
+
+        inline void unmap() { img->unmap(); }
+
+        inline void setDataRange(float pMin, float pMax) { img->setDataRange(pMin, pMax); }
+
+        inline void setAutoDataRange(bool pAuto) { img->setAutoDataRange(pAuto); }
 };
 
 }
@@ -11,6 +11,7 @@
 #include <plot.hpp>
 #include <common.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 #include <glm/glm.hpp>
@@ -87,8 +88,6 @@ void plot_impl::bindResources(int pWindowId)
         glBindVertexArray(vao);
         // attach plot vertices
         glEnableVertexAttribArray(mPointIndex);
-        glBindBuffer(GL_ARRAY_BUFFER, mMainVBO);
-        glVertexAttribPointer(mPointIndex, 2, mGLType, GL_FALSE, 0, 0);
         glBindVertexArray(0);
         /* store the vertex array object corresponding to
          * the window instance in the map */
@@ -96,6 +95,7 @@ void plot_impl::bindResources(int pWindowId)
     }
 
     glBindVertexArray(mVAOMap[pWindowId]);
+    attachDataBuffer(mPointIndex, 2, mGLType);
 }
 
 void plot_impl::unbindResources() const
@@ -105,46 +105,29 @@ void plot_impl::unbindResources() const
 
 plot_impl::plot_impl(unsigned pNumPoints, fg::dtype pDataType,
         fg::PlotType pPlotType, fg::MarkerType pMarkerType)
-    : Chart2D(), mNumPoints(pNumPoints),
-      mDataType(pDataType), mGLType(gl_dtype(mDataType)),
-      mMarkerType(pMarkerType), mPlotType(pPlotType),
-      mMainVBO(0), mMainVBOsize(0), mPointIndex(0)
+    : Chart2D(), mNumPoints(pNumPoints), mDrawCount(pNumPoints),
+      mDataType(pDataType), mGLType(gl_dtype(mDataType)), mPointSize(0),
+      mMarkerType(pMarkerType), mPlotType(pPlotType), mPointIndex(0),
+      mLODRevision(0), mLODCount(0), mDensityLogScale(false), mColorMap(0), mColorMapLength(0)
 {
-    mMarkerProgram   = initShaders(gMarkerVertexShaderSrc, gMarkerSpriteFragmentShaderSrc);
+    mMarkerProgram   = acquireProgram(gMarkerVertexShaderSrc, gMarkerSpriteFragmentShaderSrc);
     mMarkerTypeIndex = glGetUniformLocation(mMarkerProgram, "marker_type");
     mSpriteTMatIndex = glGetUniformLocation(mMarkerProgram, "transform");
     mPointIndex      = mBorderAttribPointIndex;
 
-    unsigned total_points = 2*mNumPoints;
-    // buffersubdata calls on mMainVBO
-    // will only update the points data
+    // each point is a (x, y) pair
     switch(mGLType) {
-        case GL_FLOAT:
-            mMainVBO = createBuffer<float>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(float);
-            break;
-        case GL_INT:
-            mMainVBO = createBuffer<int>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(int);
-            break;
-        case GL_UNSIGNED_INT:
-            mMainVBO = createBuffer<unsigned>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned);
-            break;
-        case GL_SHORT:
-            mMainVBO = createBuffer<short>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(short);
-            break;
-        case GL_UNSIGNED_SHORT:
-            mMainVBO = createBuffer<unsigned short>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned short);
-            break;
-        case GL_UNSIGNED_BYTE:
-            mMainVBO = createBuffer<unsigned char>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned char);
-            break;
+        case GL_FLOAT:          mPointSize = 2*sizeof(float);          break;
+        case GL_INT:            mPointSize = 2*sizeof(int);            break;
+        case GL_UNSIGNED_INT:   mPointSize = 2*sizeof(unsigned);       break;
+        case GL_SHORT:          mPointSize = 2*sizeof(short);          break;
+        case GL_UNSIGNED_SHORT: mPointSize = 2*sizeof(unsigned short); break;
+        case GL_BYTE:           mPointSize = 2*sizeof(signed char);    break;
+        case GL_UNSIGNED_BYTE:  mPointSize = 2*sizeof(unsigned char);  break;
         default: fg::TypeError("Plot::Plot", __LINE__, 1, mDataType);
     }
+    setDataLayout(mGLType, 2);
+    createDataBuffer(mNumPoints*mPointSize);
 }
 
 plot_impl::~plot_impl()
@@ -154,8 +137,9 @@ plot_impl::~plot_impl()
         GLuint vao = it->second;
         glDeleteVertexArrays(1, &vao);
     }
-    glDeleteBuffers(1, &mMainVBO);
-    glDeleteProgram(mMarkerProgram);
+    mLOD.reset();
+    mDensity.reset();
+    releaseProgram(mMarkerProgram);
     CheckGL("End Plot::~Plot");
 }
 
@@ -165,6 +149,7 @@ void plot_impl::setColor(fg::Color col)
     mLineColor[1] = (((int) col >> 16 ) & 0xFF ) / 255.f;
     mLineColor[2] = (((int) col >> 8  ) & 0xFF ) / 255.f;
     mLineColor[3] = (((int) col       ) & 0xFF ) / 255.f;
+    markDirty();
 }
 
 void plot_impl::setColor(float r, float g, float b)
@@ -173,20 +158,83 @@ void plot_impl::setColor(float r, float g, float b)
     mLineColor[1] = clampTo01(g);
     mLineColor[2] = clampTo01(b);
     mLineColor[3] = 1.0f;
+    markDirty();
+}
+
+void plot_impl::resize(unsigned pNumPoints)
+{
+    resizeDataBuffer(pNumPoints*mPointSize);
+    mNumPoints = pNumPoints;
+    mDrawCount = pNumPoints;
+}
+
+void plot_impl::setDrawCount(unsigned pCount)
+{
+    mDrawCount = std::min(pCount, mNumPoints);
+    markDirty();
+}
+
+void plot_impl::setLevelOfDetail(bool pEnable)
+{
+    if (pEnable && !mLOD) {
+        mLOD.reset(new PlotLOD(mGLType));
+        mLODRevision = 0;
+    } else if (!pEnable) {
+        mLOD.reset();
+    }
+    markDirty();
+}
+
+void plot_impl::setDensityMap(bool pEnable, bool pLogScale)
+{
+    if (pEnable && !mDensity)
+        mDensity.reset(new DensityMap());
+    else if (!pEnable)
+        mDensity.reset();
+    mDensityLogScale = pLogScale;
+    markDirty();
+}
+
+void plot_impl::setColorMapParams(GLuint tex, GLuint size)
+{
+    mColorMap = tex;
+    mColorMapLength = size;
+}
+
+unsigned plot_impl::numPoints() const
+{
+    return mNumPoints;
+}
+
+unsigned plot_impl::drawCount() const
+{
+    return mDrawCount;
 }
 
 GLuint plot_impl::vbo() const
 {
-    return mMainVBO;
+    return mDataVBO;
 }
 
 size_t plot_impl::size() const
 {
-    return mMainVBOsize;
+    return mDataSize;
+}
+
+size_t plot_impl::boundsCount() const
+{
+    return mDrawCount;
+}
+
+void plot_impl::drawPoints(GLenum pMode)
+{
+    glDrawArrays(pMode, 0, mDrawCount);
 }
 
 void plot_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
 {
+    updateAutoAxes(pWindowId);
+
     float range_x = xmax() - xmin();
     float range_y = ymax() - ymin();
     // set scale to zero if input is constant array
@@ -215,17 +263,37 @@ void plot_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
     transform = glm::scale(transform,
             glm::vec3(graph_scale_x * view_scale_x , graph_scale_y * view_scale_y ,1));
 
-    if(mPlotType == fg::FG_LINE) {
+    bool lineDrawn = false;
+    if(mPlotType == fg::FG_LINE && mLOD) {
+        size_t offset = 0;
+        GLuint buffer = dataBuffer(&offset);
+        unsigned first = unsigned(offset/mPointSize);
+        if (mLODRevision != dataRevision() || mLODCount != mDrawCount) {
+            mLOD->build(pWindowId, buffer, first, mDrawCount);
+            mLODRevision = dataRevision();
+            mLODCount    = mDrawCount;
+        }
+        lineDrawn = mLOD->draw(pWindowId, buffer, first, xmin(), xmax(),
+                               unsigned(viewWidth), transform, mLineColor);
+    }
+
+    if(mPlotType == fg::FG_LINE && !lineDrawn) {
         glUseProgram(mBorderProgram);
         glUniformMatrix4fv(mBorderUniformMatIndex, 1, GL_FALSE, glm::value_ptr(transform));
         glUniform4fv(mBorderUniformColorIndex, 1, mLineColor);
         plot_impl::bindResources(pWindowId);
-        glDrawArrays(GL_LINE_STRIP, 0, mNumPoints);
+        drawPoints(GL_LINE_STRIP);
         plot_impl::unbindResources();
         glUseProgram(0);
     }
 
-    if(mMarkerType != fg::FG_NONE){
+    if(mDensity && (mPlotType == fg::FG_SCATTER || mMarkerType != fg::FG_NONE)) {
+        mDensity->begin(transform);
+        plot_impl::bindResources(pWindowId);
+        drawPoints(GL_POINTS);
+        plot_impl::unbindResources();
+        mDensity->end(pWindowId, mColorMap, mColorMapLength, mDensityLogScale);
+    } else if(mMarkerType != fg::FG_NONE){
         glEnable(GL_PROGRAM_POINT_SIZE);
         glUseProgram(mMarkerProgram);
 
@@ -234,12 +302,14 @@ void plot_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
         glUniform1i(mMarkerTypeIndex, mMarkerType);
 
         plot_impl::bindResources(pWindowId);
-        glDrawArrays(GL_POINTS, 0, mNumPoints);
+        drawPoints(GL_POINTS);
         plot_impl::unbindResources();
         glUseProgram(0);
         glDisable(GL_PROGRAM_POINT_SIZE);
     }
 
+    fenceDataBuffer();
+
     /* Stop clipping and reset viewport to window dimensions */
     glDisable(GL_SCISSOR_TEST);
     /* render graph border and axes */
@@ -284,11 +354,36 @@ void Plot::setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin)
     value->setAxesLimits(pXmax, pXmin, pYmax, pYmin);
 }
 
+void Plot::setAutoAxes(bool pAuto)
+{
+    value->setAutoAxes(pAuto);
+}
+
 void Plot::setAxesTitles(const char* pXTitle, const char* pYTitle)
 {
     value->setAxesTitles(pXTitle, pYTitle);
 }
 
+void Plot::resize(unsigned pNumPoints)
+{
+    value->resize(pNumPoints);
+}
+
+void Plot::setDrawCount(unsigned pCount)
+{
+    value->setDrawCount(pCount);
+}
+
+void Plot::setLevelOfDetail(bool pEnable)
+{
+    value->setLevelOfDetail(pEnable);
+}
+
+void Plot::setDensityMap(bool pEnable, bool pLogScale)
+{
+    value->setDensityMap(pEnable, pLogScale);
+}
+
 float Plot::xmax() const
 {
     return value->xmax();
@@ -319,6 +414,46 @@ unsigned Plot::size() const
     return (unsigned)value->size();
 }
 
+void Plot::markDirty()
+{
+    value->markDirty();
+}
+
+void Plot::vboWritten()
+{
+    value->vboWritten();
+}
+
+void Plot::setStreaming(bool pStreaming)
+{
+    value->setStreaming(pStreaming);
+}
+
+bool Plot::streaming() const
+{
+    return value->streaming();
+}
+
+void Plot::upload(const void* pData)
+{
+    value->upload(pData);
+}
+
+void Plot::update(const void* pData, unsigned pOffset, unsigned pSize)
+{
+    value->update(pData, pOffset, pSize);
+}
+
+void* Plot::map(MapAccess pAccess)
+{
+    return value->map(pAccess);
+}
+
+void Plot::unmap()
+{
+    value->unmap();
+}
+
 internal::_Plot* Plot::get() const
 {
     return value;
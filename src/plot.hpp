@@ -11,6 +11,8 @@
 
 #include <common.hpp>
 #include <chart.hpp>
+#include <plotlod.hpp>
+#include <density.hpp>
 #include <memory>
 #include <map>
 #include <glm/glm.hpp>
@@ -22,15 +24,15 @@ class plot_impl : public Chart2D {
     protected:
         /* plot points characteristics */
         GLuint    mNumPoints;
+        GLuint    mDrawCount;
         fg::dtype mDataType;
         GLenum    mGLType;
+        size_t    mPointSize;
         float     mLineColor[4];
         fg::MarkerType mMarkerType;
         fg::PlotType   mPlotType;
         /* OpenGL Objects */
-        GLuint    mMainVBO;
-        size_t    mMainVBOsize;
-        GLuint    mMarkerProgram;
+        ProgramRef mMarkerProgram;
         /* shared variable index locations */
         GLuint    mPointIndex;
         GLuint    mMarkerTypeIndex;
@@ -38,17 +40,47 @@ class plot_impl : public Chart2D {
 
         std::map<int, GLuint> mVAOMap;
 
+        /* min/max pyramid of the line, rebuilt when the data
+         * revision or the number of points drawn change */
+        std::unique_ptr<PlotLOD> mLOD;
+        unsigned long long mLODRevision;
+        unsigned           mLODCount;
+
+        /* points drawn as a density map instead of markers */
+        std::unique_ptr<DensityMap> mDensity;
+        bool      mDensityLogScale;
+        GLuint    mColorMap;
+        GLuint    mColorMapLength;
+
         /* bind and unbind helper functions
          * for rendering resources */
         void bindResources(int pWindowId);
         void unbindResources() const;
 
+        /* axes limits follow the points that are drawn */
+        size_t boundsCount() const;
+
+        /* issues the draw calls for the plot points
+         * with the bound program and vertex array */
+        virtual void drawPoints(GLenum pMode);
+
     public:
         plot_impl(unsigned pNumPoints, fg::dtype pDataType, fg::PlotType, fg::MarkerType);
         ~plot_impl();
 
         void setColor(fg::Color col);
         void setColor(float r, float g, float b);
+        /* changes the number of points, existing points are kept */
+        void resize(unsigned pNumPoints);
+        /* draws only the first pCount points */
+        void setDrawCount(unsigned pCount);
+        /* draws lines from a min/max pyramid of the points */
+        void setLevelOfDetail(bool pEnable);
+        /* draws the points as a density map through the window colormap */
+        void setDensityMap(bool pEnable, bool pLogScale);
+        void setColorMapParams(GLuint tex, GLuint size);
+        unsigned numPoints() const;
+        unsigned drawCount() const;
         GLuint vbo() const;
         size_t size() const;
 
@@ -79,10 +111,30 @@ class _Plot {
             plt->setAxesLimits(pXmax, pXmin, pYmax, pYmin);
         }
 
+        inline void setAutoAxes(bool pAuto) {
+            plt->setAutoAxes(pAuto);
+        }
+
         inline void setAxesTitles(const char* pXTitle, const char* pYTitle) {
             plt->setAxesTitles(pXTitle, pYTitle);
         }
 
+        inline void resize(unsigned pNumPoints) {
+            plt->resize(pNumPoints);
+        }
+
+        inline void setDrawCount(unsigned pCount) {
+            plt->setDrawCount(pCount);
+        }
+
+        inline void setLevelOfDetail(bool pEnable) {
+            plt->setLevelOfDetail(pEnable);
+        }
+
+        inline void setDensityMap(bool pEnable, bool pLogScale) {
+            plt->setDensityMap(pEnable, pLogScale);
+        }
+
         inline float xmax() const {
             return plt->xmax();
         }
@@ -106,6 +158,38 @@ class _Plot {
         inline size_t size() const {
             return plt->size();
         }
+
+        inline void markDirty() {
+            plt->markDirty();
+        }
+
+        inline void vboWritten() {
+            plt->dataBufferWritten();
+        }
+
+        inline void setStreaming(bool pStreaming) {
+            plt->setStreaming(pStreaming);
+        }
+
+        inline bool streaming() const {
+            return plt->streaming();
+        }
+
+        inline void upload(const void* pData) {
+            plt->upload(pData);
+        }
+
+        inline void update(const void* pData, unsigned pOffset, unsigned pSize) {
+            plt->update(pData, pOffset, pSize);
+        }
+
+        inline void* map(fg::MapAccess pAccess) {
+            return plt->map(pAccess);
+        }
+
+        inline void unmap() {
+            plt->unmap();
+        }
 };
 
 }
@@ -11,6 +11,7 @@
 #include <plot3.hpp>
 #include <common.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 #include <glm/glm.hpp>
@@ -111,9 +112,6 @@ void plot3_impl::bindResources(int pWindowId)
         glBindVertexArray(vao);
         // attach plot vertices
         glEnableVertexAttribArray(mPointIndex);
-        glBindBuffer(GL_ARRAY_BUFFER, mMainVBO);
-        glVertexAttribPointer(mPointIndex, 3, mDataType, GL_FALSE, 0, 0);
-        //attach indices
         glBindVertexArray(0);
         /* store the vertex array object corresponding to
          * the window instance in the map */
@@ -121,23 +119,24 @@ void plot3_impl::bindResources(int pWindowId)
     }
 
     glBindVertexArray(mVAOMap[pWindowId]);
+    attachDataBuffer(mPointIndex, 3, mDataType);
 }
 
 void plot3_impl::unbindResources() const { glBindVertexArray(0); }
 
 plot3_impl::plot3_impl(unsigned pNumPoints, fg::dtype pDataType, fg::PlotType pPlotType, fg::MarkerType pMarkerType)
-    : Chart3D(), mNumPoints(pNumPoints),
-      mDataType(gl_dtype(pDataType)), mPlotType(pPlotType),
-      mMainVBO(0), mMainVBOsize(0),
+    : Chart3D(), mNumPoints(pNumPoints), mDrawCount(pNumPoints),
+      mDataType(gl_dtype(pDataType)), mPointSize(0), mPlotType(pPlotType),
       mIndexVBOsize(0), mPointIndex(0), mMarkerTypeIndex(0),
       mMarkerColIndex(0), mSpriteTMatIndex(0), mPlot3PointIndex(0),
-      mPlot3TMatIndex(0), mPlot3RangeIndex(0)
+      mPlot3TMatIndex(0), mPlot3RangeIndex(0), mDensityLogScale(false),
+      mColorMap(0), mColorMapLength(0)
 {
     CheckGL("Begin plot3_impl::plot3_impl");
     mPointIndex      = mBorderAttribPointIndex;
     mMarkerType      = pMarkerType;
-    mPlot3Program    = initShaders(gMarkerVertexShaderSrc, gPlot3FragmentShaderSrc);
-    mMarkerProgram   = initShaders(gMarkerVertexShaderSrc, gMarkerSpriteFragmentShaderSrc);
+    mPlot3Program    = acquireProgram(gMarkerVertexShaderSrc, gPlot3FragmentShaderSrc);
+    mMarkerProgram   = acquireProgram(gMarkerVertexShaderSrc, gMarkerSpriteFragmentShaderSrc);
 
     mPlot3PointIndex = glGetAttribLocation (mPlot3Program, "point");
     mPlot3TMatIndex  = glGetUniformLocation(mPlot3Program, "transform");
@@ -147,29 +146,16 @@ plot3_impl::plot3_impl(unsigned pNumPoints, fg::dtype pDataType, fg::PlotType pP
     mMarkerColIndex  = glGetUniformLocation(mMarkerProgram, "line_color");
     mSpriteTMatIndex = glGetUniformLocation(mMarkerProgram, "transform");
 
-    unsigned total_points = 3 * mNumPoints;
-
-    // buffersubdata calls on mMainVBO
-    // will only update the points data
+    // each point is a (x, y, z) triple
     switch(mDataType) {
-        case GL_FLOAT:
-            mMainVBO = createBuffer<float>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(float);
-            break;
-        case GL_INT:
-            mMainVBO = createBuffer<int>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(int);
-            break;
-        case GL_UNSIGNED_INT:
-            mMainVBO = createBuffer<unsigned>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned);
-            break;
-        case GL_UNSIGNED_BYTE:
-            mMainVBO = createBuffer<unsigned char>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned char);
-            break;
+        case GL_FLOAT:         mPointSize = 3*sizeof(float);         break;
+        case GL_INT:           mPointSize = 3*sizeof(int);           break;
+        case GL_UNSIGNED_INT:  mPointSize = 3*sizeof(unsigned);      break;
+        case GL_UNSIGNED_BYTE: mPointSize = 3*sizeof(unsigned char); break;
         default: fg::TypeError("Plot::Plot", __LINE__, 1, pDataType);
     }
+    setDataLayout(mDataType, 3);
+    createDataBuffer(mNumPoints*mPointSize);
     CheckGL("End plot3_impl::plot3_impl");
 }
 
@@ -180,9 +166,9 @@ plot3_impl::~plot3_impl()
         GLuint vao = it->second;
         glDeleteVertexArrays(1, &vao);
     }
-    glDeleteBuffers(1, &mMainVBO);
-    glDeleteProgram(mMarkerProgram);
-    glDeleteProgram(mPlot3Program);
+    mDensity.reset();
+    releaseProgram(mMarkerProgram);
+    releaseProgram(mPlot3Program);
     CheckGL("End Plot::~Plot");
 }
 
@@ -192,6 +178,7 @@ void plot3_impl::setColor(fg::Color col)
     mLineColor[1] = (((int) col >> 16 ) & 0xFF ) / 255.f;
     mLineColor[2] = (((int) col >> 8  ) & 0xFF ) / 255.f;
     mLineColor[3] = (((int) col       ) & 0xFF ) / 255.f;
+    markDirty();
 }
 
 void plot3_impl::setColor(float r, float g, float b)
@@ -200,14 +187,55 @@ void plot3_impl::setColor(float r, float g, float b)
     mLineColor[1] = clampTo01(g);
     mLineColor[2] = clampTo01(b);
     mLineColor[3] = 1.0f;
+    markDirty();
+}
+
+void plot3_impl::resize(unsigned pNumPoints)
+{
+    resizeDataBuffer(pNumPoints*mPointSize);
+    mNumPoints = pNumPoints;
+    mDrawCount = pNumPoints;
 }
 
-GLuint plot3_impl::vbo() const { return mMainVBO; }
+void plot3_impl::setDrawCount(unsigned pCount)
+{
+    mDrawCount = std::min(pCount, mNumPoints);
+    markDirty();
+}
+
+void plot3_impl::setDensityMap(bool pEnable, bool pLogScale)
+{
+    if (pEnable && !mDensity)
+        mDensity.reset(new DensityMap());
+    else if (!pEnable)
+        mDensity.reset();
+    mDensityLogScale = pLogScale;
+    markDirty();
+}
+
+void plot3_impl::setColorMapParams(GLuint tex, GLuint size)
+{
+    mColorMap = tex;
+    mColorMapLength = size;
+}
+
+unsigned plot3_impl::numPoints() const { return mNumPoints; }
+
+unsigned plot3_impl::drawCount() const { return mDrawCount; }
+
+GLuint plot3_impl::vbo() const { return mDataVBO; }
 
-size_t plot3_impl::size() const { return mMainVBOsize; }
+size_t plot3_impl::size() const { return mDataSize; }
+
+size_t plot3_impl::boundsCount() const
+{
+    return mDrawCount;
+}
 
 void plot3_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
 {
+    updateAutoAxes(pWindowId);
+
     float range_x = xmax() - xmin();
     float range_y = ymax() - ymin();
     float range_z = zmax() - zmin();
@@ -237,12 +265,18 @@ void plot3_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
         glUniformMatrix4fv(mPlot3TMatIndex, 1, GL_FALSE, glm::value_ptr(transform));
 
         bindResources(pWindowId);
-        glDrawArrays(GL_LINE_STRIP, 0, mNumPoints);
+        glDrawArrays(GL_LINE_STRIP, 0, mDrawCount);
         unbindResources();
         glUseProgram(0);
     }
 
-    if(mMarkerType != fg::FG_NONE) {
+    if(mDensity && (mPlotType == fg::FG_SCATTER || mMarkerType != fg::FG_NONE)) {
+        mDensity->begin(transform);
+        bindResources(pWindowId);
+        glDrawArrays(GL_POINTS, 0, mDrawCount);
+        unbindResources();
+        mDensity->end(pWindowId, mColorMap, mColorMapLength, mDensityLogScale);
+    } else if(mMarkerType != fg::FG_NONE) {
         glEnable(GL_PROGRAM_POINT_SIZE);
         glUseProgram(mMarkerProgram);
 
@@ -251,12 +285,14 @@ void plot3_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
         glUniform1i(mMarkerTypeIndex, mMarkerType);
 
         bindResources(pWindowId);
-        glDrawArrays(GL_POINTS, 0, mNumPoints);
+        glDrawArrays(GL_POINTS, 0, mDrawCount);
         unbindResources();
         glUseProgram(0);
         glDisable(GL_PROGRAM_POINT_SIZE);
     }
 
+    fenceDataBuffer();
+
     /* render graph border and axes */
     renderChart(pWindowId, pX, pY, pVPW, pVPH);
 
@@ -299,11 +335,31 @@ void Plot3::setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin, fl
     value->setAxesLimits(pXmax, pXmin, pYmax, pYmin, pZmax, pZmin);
 }
 
+void Plot3::setAutoAxes(bool pAuto)
+{
+    value->setAutoAxes(pAuto);
+}
+
 void Plot3::setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle)
 {
     value->setAxesTitles(pXTitle, pYTitle, pZTitle);
 }
 
+void Plot3::resize(unsigned pNumPoints)
+{
+    value->resize(pNumPoints);
+}
+
+void Plot3::setDrawCount(unsigned pCount)
+{
+    value->setDrawCount(pCount);
+}
+
+void Plot3::setDensityMap(bool pEnable, bool pLogScale)
+{
+    value->setDensityMap(pEnable, pLogScale);
+}
+
 float Plot3::xmax() const
 {
     return value->xmax();
@@ -344,6 +400,46 @@ unsigned Plot3::size() const
     return (unsigned)value->size();
 }
 
+void Plot3::markDirty()
+{
+    value->markDirty();
+}
+
+void Plot3::vboWritten()
+{
+    value->vboWritten();
+}
+
+void Plot3::setStreaming(bool pStreaming)
+{
+    value->setStreaming(pStreaming);
+}
+
+bool Plot3::streaming() const
+{
+    return value->streaming();
+}
+
+void Plot3::upload(const void* pData)
+{
+    value->upload(pData);
+}
+
+void Plot3::update(const void* pData, unsigned pOffset, unsigned pSize)
+{
+    value->update(pData, pOffset, pSize);
+}
+
+void* Plot3::map(MapAccess pAccess)
+{
+    return value->map(pAccess);
+}
+
+void Plot3::unmap()
+{
+    value->unmap();
+}
+
 internal::_Plot3* Plot3::get() const
 {
     return value;
@@ -11,6 +11,7 @@
 
 #include <common.hpp>
 #include <chart.hpp>
+#include <density.hpp>
 #include <memory>
 #include <map>
 #include <glm/glm.hpp>
@@ -22,16 +23,16 @@ class plot3_impl : public Chart3D {
     protected:
         /* plot points characteristics */
         GLuint    mNumPoints;
+        GLuint    mDrawCount;
         GLenum    mDataType;
+        size_t    mPointSize;
         float     mLineColor[4];
         fg::MarkerType mMarkerType;
         fg::PlotType mPlotType;
         /* OpenGL Objects */
-        GLuint    mMainVBO;
-        size_t    mMainVBOsize;
         size_t    mIndexVBOsize;
-        GLuint    mMarkerProgram;
-        GLuint    mPlot3Program;
+        ProgramRef mMarkerProgram;
+        ProgramRef mPlot3Program;
         /* shared variable index locations */
         GLuint    mPointIndex;
         GLuint    mMarkerTypeIndex;
@@ -43,17 +44,35 @@ class plot3_impl : public Chart3D {
 
         std::map<int, GLuint> mVAOMap;
 
+        /* points drawn as a density map instead of markers */
+        std::unique_ptr<DensityMap> mDensity;
+        bool      mDensityLogScale;
+        GLuint    mColorMap;
+        GLuint    mColorMapLength;
+
         /* bind and unbind helper functions
          * for rendering resources */
         void bindResources(int pWindowId);
         void unbindResources() const;
 
+        /* axes limits follow the points that are drawn */
+        size_t boundsCount() const;
+
     public:
         plot3_impl(unsigned pNumPoints, fg::dtype pDataType, fg::PlotType pPlotType, fg::MarkerType pMarkerType);
         ~plot3_impl();
 
         void setColor(fg::Color col);
         void setColor(float r, float g, float b);
+        /* changes the number of points, existing points are kept */
+        void resize(unsigned pNumPoints);
+        /* draws only the first pCount points */
+        void setDrawCount(unsigned pCount);
+        /* draws the points as a density map through the window colormap */
+        void setDensityMap(bool pEnable, bool pLogScale);
+        void setColorMapParams(GLuint tex, GLuint size);
+        unsigned numPoints() const;
+        unsigned drawCount() const;
         GLuint vbo() const;
         size_t size() const;
 
@@ -85,11 +104,27 @@ class _Plot3 {
             plt->setAxesLimits(pXmax, pXmin, pYmax, pYmin, pZmax, pZmin);
         }
 
+        inline void setAutoAxes(bool pAuto) {
+            plt->setAutoAxes(pAuto);
+        }
+
         inline void setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle)
         {
             plt->setAxesTitles(pXTitle, pYTitle, pZTitle);
         }
 
+        inline void resize(unsigned pNumPoints) {
+            plt->resize(pNumPoints);
+        }
+
+        inline void setDrawCount(unsigned pCount) {
+            plt->setDrawCount(pCount);
+        }
+
+        inline void setDensityMap(bool pEnable, bool pLogScale) {
+            plt->setDensityMap(pEnable, pLogScale);
+        }
+
         inline float xmax() const {
             return plt->xmax();
         }
@@ -121,6 +156,38 @@ class _Plot3 {
         inline size_t size() const {
             return plt->size();
         }
+
+        inline void markDirty() {
+            plt->markDirty();
+        }
+
+        inline void vboWritten() {
+            plt->dataBufferWritten();
+        }
+
+        inline void setStreaming(bool pStreaming) {
+            plt->setStreaming(pStreaming);
+        }
+
+        inline bool streaming() const {
+            return plt->streaming();
+        }
+
+        inline void upload(const void* pData) {
+            plt->upload(pData);
+        }
+
+        inline void update(const void* pData, unsigned pOffset, unsigned pSize) {
+            plt->update(pData, pOffset, pSize);
+        }
+
+        inline void* map(fg::MapAccess pAccess) {
+            return plt->map(pAccess);
+        }
+
+        inline void unmap() {
+            plt->unmap();
+        }
 };
 
 }
@@ -0,0 +1,485 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <plotlod.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include <glm/gtc/type_ptr.hpp>
+
+/* full viewport quad from gl_VertexID, drawn as a 4 vertex strip */
+static const char *gLODPassVertexShaderSrc =
+"#version 330\n"
+"void main(void) {\n"
+"   vec2 pos = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+"   gl_Position = vec4(pos * 2 - 1, 0, 1);\n"
+"}";
+
+/* level 1: one fragment per bucket of points, the sampler type
+ * is prepended as it depends on the data type of the plot */
+static const char *gLODReduceFragmentShaderSrc =
+"samplerBuffer points;\n"
+"uniform int base;\n"
+"uniform int count;\n"
+"uniform int bucket;\n"
+"uniform int width;\n"
+"uniform int row;\n"
+"out vec4 extrema;\n"
+"void main(void) {\n"
+"   ivec2 texel = ivec2(gl_FragCoord.xy);\n"
+"   int i0 = ((texel.y - row) * width + texel.x) * bucket;\n"
+"   if (i0 >= count)\n"
+"       discard;\n"
+"   int i1 = min(i0 + bucket, count);\n"
+"   vec2 lo = vec2(texelFetch(points, base + i0).xy);\n"
+"   vec2 hi = lo;\n"
+"   for (int i = i0 + 1; i < i1; ++i) {\n"
+"       vec2 p = vec2(texelFetch(points, base + i).xy);\n"
+"       if (p.y < lo.y) lo = p;\n"
+"       if (p.y > hi.y) hi = p;\n"
+"   }\n"
+"   extrema = vec4(lo, hi);\n"
+"}";
+
+/* further levels: merges pairs of buckets of the level below */
+static const char *gLODMergeFragmentShaderSrc =
+"#version 330\n"
+"uniform sampler2D pyramid;\n"
+"uniform int count;\n"
+"uniform int width;\n"
+"uniform int row;\n"
+"out vec4 extrema;\n"
+"void main(void) {\n"
+"   ivec2 texel = ivec2(gl_FragCoord.xy);\n"
+"   int b = 2 * (texel.y * width + texel.x);\n"
+"   if (b >= count)\n"
+"       discard;\n"
+"   vec4 m = texelFetch(pyramid, ivec2(b % width, row + b / width), 0);\n"
+"   if (b + 1 < count) {\n"
+"       vec4 m1 = texelFetch(pyramid, ivec2((b + 1) % width, row + (b + 1) / width), 0);\n"
+"       if (m1.y < m.y) m.xy = m1.xy;\n"
+"       if (m1.w > m.w) m.zw = m1.zw;\n"
+"   }\n"
+"   extrema = m;\n"
+"}";
+
+/* one fragment per pixel column: the first, lowest, highest and last
+ * point in it, lowest and highest in x order. The columns on either
+ * side of the view hold the points next to it. The sampler type is
+ * prepended as for the reduction */
+static const char *gLODColumnFragmentShaderSrc =
+"samplerBuffer points;\n"
+"uniform sampler2D pyramid;\n"
+"uniform int base;\n"
+"uniform int count;\n"
+"uniform int bucket;\n"
+"uniform int width;\n"
+"uniform int levels;\n"
+"uniform int levelRow[32];\n"
+"uniform float xmin;\n"
+"uniform float xstep;\n"
+"uniform int columns;\n"
+"layout(location = 0) out vec4 firstLeft;\n"
+"layout(location = 1) out vec4 rightLast;\n"
+"vec2 point(int i) {\n"
+"   return vec2(texelFetch(points, base + i).xy);\n"
+"}\n"
+"int lowerBound(float x) {\n"
+"   int lo = 0;\n"
+"   int hi = count;\n"
+"   while (lo < hi) {\n"
+"       int mid = (lo + hi) / 2;\n"
+"       if (point(mid).x < x)\n"
+"           lo = mid + 1;\n"
+"       else\n"
+"           hi = mid;\n"
+"   }\n"
+"   return lo;\n"
+"}\n"
+"void main(void) {\n"
+"   int c = int(gl_FragCoord.x) - 1;\n"
+"   int i0, i1;\n"
+"   if (c < 0) {\n"
+"       i1 = lowerBound(xmin);\n"
+"       i0 = max(i1 - 1, 0);\n"
+"   } else if (c >= columns) {\n"
+"       i0 = lowerBound(xmin + columns * xstep);\n"
+"       i1 = min(i0 + 1, count);\n"
+"   } else {\n"
+"       i0 = lowerBound(xmin + c * xstep);\n"
+"       i1 = lowerBound(xmin + (c + 1) * xstep);\n"
+"   }\n"
+"   if (i0 >= i1) {\n"
+"       /* empty column, the line passes to the next point */\n"
+"       vec2 p = point(min(i0, count - 1));\n"
+"       firstLeft = vec4(p, p);\n"
+"       rightLast = vec4(p, p);\n"
+"       return;\n"
+"   }\n"
+"   vec2 lo = point(i0);\n"
+"   vec2 hi = lo;\n"
+"   int i = i0 + 1;\n"
+"   while (i < i1 && (i % bucket) != 0) {\n"
+"       vec2 p = point(i++);\n"
+"       if (p.y < lo.y) lo = p;\n"
+"       if (p.y > hi.y) hi = p;\n"
+"   }\n"
+"   /* largest aligned buckets that fit in the column */\n"
+"   int l = 0;\n"
+"   while (i + bucket <= i1) {\n"
+"       while (l + 1 < levels && (i % (bucket << (l + 1))) == 0 &&\n"
+"              i + (bucket << (l + 1)) <= i1)\n"
+"           ++l;\n"
+"       while (i + (bucket << l) > i1)\n"
+"           --l;\n"
+"       int b = i / (bucket << l);\n"
+"       vec4 m = texelFetch(pyramid, ivec2(b % width, levelRow[l] + b / width), 0);\n"
+"       if (m.y < lo.y) lo = m.xy;\n"
+"       if (m.w > hi.y) hi = m.zw;\n"
+"       i += bucket << l;\n"
+"   }\n"
+"   while (i < i1) {\n"
+"       vec2 p = point(i++);\n"
+"       if (p.y < lo.y) lo = p;\n"
+"       if (p.y > hi.y) hi = p;\n"
+"   }\n"
+"   vec2 left  = (lo.x <= hi.x ? lo : hi);\n"
+"   vec2 right = (lo.x <= hi.x ? hi : lo);\n"
+"   firstLeft = vec4(point(i0), left);\n"
+"   rightLast = vec4(right, point(i1 - 1));\n"
+"}";
+
+/* 4 vertices per pixel column, expanded from the points
+ * the column pass found for it */
+static const char *gLODDrawVertexShaderSrc =
+"#version 330\n"
+"uniform sampler2D firstLeft;\n"
+"uniform sampler2D rightLast;\n"
+"uniform mat4 transform;\n"
+"void main(void) {\n"
+"   ivec2 texel = ivec2(gl_VertexID / 4, 0);\n"
+"   int k = gl_VertexID % 4;\n"
+"   vec4 m = (k < 2 ? texelFetch(firstLeft, texel, 0) : texelFetch(rightLast, texel, 0));\n"
+"   vec2 pos = ((k & 1) == 0 ? m.xy : m.zw);\n"
+"   gl_Position = transform * vec4(pos, 0, 1);\n"
+"}";
+
+static const char *gLODDrawFragmentShaderSrc =
+"#version 330\n"
+"uniform vec4 color;\n"
+"out vec4 outputColor;\n"
+"void main(void) {\n"
+"   outputColor = color;\n"
+"}";
+
+
+namespace internal
+{
+
+const unsigned PlotLOD::BASE_BUCKET;
+const unsigned PlotLOD::TOP_BUCKETS;
+const unsigned PlotLOD::MAX_LEVELS;
+const unsigned PlotLOD::LEVEL_WIDTH;
+
+PlotLOD::PlotLOD(GLenum pType)
+    : mTexelFormat(0), mPointSize(0), mSamplerPrefix(""), mCount(0),
+      mPointTexture(0), mPyramid(0), mScratch(0), mFramebuffer(0),
+      mColumnFramebuffer(0), mColumnWidth(0)
+{
+    CheckGL("Begin PlotLOD::PlotLOD");
+    switch(pType) {
+        case GL_FLOAT:          mTexelFormat = GL_RG32F;  mPointSize = 2*sizeof(float);          break;
+        case GL_INT:            mTexelFormat = GL_RG32I;  mPointSize = 2*sizeof(int);            break;
+        case GL_UNSIGNED_INT:   mTexelFormat = GL_RG32UI; mPointSize = 2*sizeof(unsigned);       break;
+        case GL_SHORT:          mTexelFormat = GL_RG16I;  mPointSize = 2*sizeof(short);          break;
+        case GL_UNSIGNED_SHORT: mTexelFormat = GL_RG16UI; mPointSize = 2*sizeof(unsigned short); break;
+        case GL_BYTE:           mTexelFormat = GL_RG8I;   mPointSize = 2*sizeof(signed char);    break;
+        case GL_UNSIGNED_BYTE:  mTexelFormat = GL_RG8UI;  mPointSize = 2*sizeof(unsigned char);  break;
+    }
+    switch(mTexelFormat) {
+        case GL_RG32I: case GL_RG16I: case GL_RG8I:    mSamplerPrefix = "i"; break;
+        case GL_RG32UI: case GL_RG16UI: case GL_RG8UI: mSamplerPrefix = "u"; break;
+    }
+
+    std::string prefix = std::string("#version 330\nuniform ") + mSamplerPrefix;
+    std::string reduce = prefix + gLODReduceFragmentShaderSrc;
+    std::string column = prefix + gLODColumnFragmentShaderSrc;
+    mReduceProgram = acquireProgram(gLODPassVertexShaderSrc, reduce.c_str());
+    mMergeProgram  = acquireProgram(gLODPassVertexShaderSrc, gLODMergeFragmentShaderSrc);
+    mColumnProgram = acquireProgram(gLODPassVertexShaderSrc, column.c_str());
+    mDrawProgram   = acquireProgram(gLODDrawVertexShaderSrc, gLODDrawFragmentShaderSrc);
+
+    glGenTextures(1, &mPointTexture);
+    glGenTextures(2, mColumns);
+    for (int t=0; t<2; ++t) {
+        glBindTexture(GL_TEXTURE_2D, mColumns[t]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(1, &mFramebuffer);
+    glGenFramebuffers(1, &mColumnFramebuffer);
+    CheckGL("End PlotLOD::PlotLOD");
+}
+
+PlotLOD::~PlotLOD()
+{
+    CheckGL("Begin PlotLOD::~PlotLOD");
+    releaseLevels();
+    for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
+        GLuint vao = it->second;
+        glDeleteVertexArrays(1, &vao);
+    }
+    glDeleteFramebuffers(1, &mColumnFramebuffer);
+    glDeleteFramebuffers(1, &mFramebuffer);
+    glDeleteTextures(2, mColumns);
+    glDeleteTextures(1, &mPointTexture);
+    releaseProgram(mDrawProgram);
+    releaseProgram(mColumnProgram);
+    releaseProgram(mMergeProgram);
+    releaseProgram(mReduceProgram);
+    CheckGL("End PlotLOD::~PlotLOD");
+}
+
+void PlotLOD::bindVAO(int pWindowId)
+{
+    /* the passes generate their vertices, but a vertex
+     * array object has to be bound for draws */
+    if (mVAOMap.find(pWindowId) == mVAOMap.end()) {
+        GLuint vao = 0;
+        glGenVertexArrays(1, &vao);
+        mVAOMap[pWindowId] = vao;
+    }
+    glBindVertexArray(mVAOMap[pWindowId]);
+}
+
+void PlotLOD::releaseLevels()
+{
+    if (mPyramid)
+        glDeleteTextures(1, &mPyramid);
+    if (mScratch)
+        glDeleteTextures(1, &mScratch);
+    mPyramid = 0;
+    mScratch = 0;
+    mBuckets.clear();
+    mRows.clear();
+}
+
+void PlotLOD::build(int pWindowId, GLuint pBuffer, unsigned pFirst, unsigned pCount)
+{
+    CheckGL("Begin PlotLOD::build");
+    GLint maxTexels = 0;
+    GLint maxSize   = 0;
+    GLint bufSize   = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    glBindBuffer(GL_TEXTURE_BUFFER, pBuffer);
+    glGetBufferParameteriv(GL_TEXTURE_BUFFER, GL_BUFFER_SIZE, &bufSize);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    mCount = pCount;
+
+    std::vector<unsigned> buckets;
+    std::vector<GLint> rows(1, 0);
+    unsigned n = (pCount + BASE_BUCKET - 1) / BASE_BUCKET;
+    do {
+        buckets.push_back(n);
+        rows.push_back(rows.back() + (n + LEVEL_WIDTH - 1) / LEVEL_WIDTH);
+        n = (n + 1) / 2;
+    } while (buckets.back() > TOP_BUCKETS && buckets.size() < MAX_LEVELS);
+
+    if (pCount < 2*BASE_BUCKET || size_t(bufSize)/mPointSize > size_t(maxTexels) ||
+        rows.back() > maxSize) {
+        releaseLevels();
+        CheckGL("End PlotLOD::build");
+        return;
+    }
+
+    if (buckets != mBuckets) {
+        releaseLevels();
+        mBuckets = buckets;
+        mRows    = rows;
+        /* levels after the first are built in the scratch texture,
+         * which holds the largest of them, and copied to the pyramid */
+        GLuint* textures[] = {&mPyramid, &mScratch};
+        GLint   heights[]  = {rows.back(), (rows.size() > 2 ? rows[2] - rows[1] : 1)};
+        for (int t=0; t<2; ++t) {
+            glGenTextures(1, textures[t]);
+            glBindTexture(GL_TEXTURE_2D, *textures[t]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, LEVEL_WIDTH, heights[t],
+                         0, GL_RGBA, GL_FLOAT, NULL);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    /* the window may render to a framebuffer object of its own */
+    GLint drawFbo = 0;
+    GLint readFbo = 0;
+    GLint viewport[4];
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean blend   = glIsEnabled(GL_BLEND);
+    GLboolean depth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    bindVAO(pWindowId);
+
+    /* level 1 from the points */
+    glUseProgram(mReduceProgram);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "points"), 0);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "base"), pFirst);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "count"), pCount);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "bucket"), BASE_BUCKET);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "width"), LEVEL_WIDTH);
+    glUniform1i(glGetUniformLocation(mReduceProgram, "row"), mRows[0]);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, mPointTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, mTexelFormat, pBuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mPyramid, 0);
+    glViewport(0, mRows[0], std::min(mBuckets[0], LEVEL_WIDTH), mRows[1] - mRows[0]);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    /* further levels into the scratch texture,
+     * which is copied to the rows of the level */
+    glUseProgram(mMergeProgram);
+    glUniform1i(glGetUniformLocation(mMergeProgram, "pyramid"), 0);
+    glUniform1i(glGetUniformLocation(mMergeProgram, "width"), LEVEL_WIDTH);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mScratch, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindTexture(GL_TEXTURE_2D, mPyramid);
+    for (size_t i=1; i<mBuckets.size(); ++i) {
+        GLsizei width  = std::min(mBuckets[i], LEVEL_WIDTH);
+        GLsizei height = mRows[i+1] - mRows[i];
+        glUniform1i(glGetUniformLocation(mMergeProgram, "count"), mBuckets[i-1]);
+        glUniform1i(glGetUniformLocation(mMergeProgram, "row"), mRows[i-1]);
+        glViewport(0, 0, width, height);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, mRows[i], 0, 0, width, height);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glBindVertexArray(0);
+
+    if (depth)
+        glEnable(GL_DEPTH_TEST);
+    if (blend)
+        glEnable(GL_BLEND);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo);
+    CheckGL("End PlotLOD::build");
+}
+
+bool PlotLOD::draw(int pWindowId, GLuint pBuffer, unsigned pFirst,
+                   float pXMin, float pXMax, unsigned pColumns,
+                   const glm::mat4& pTransform, const float* pColor)
+{
+    if (mBuckets.empty() || !(pXMax > pXMin) || mCount <= 4*(pColumns + 2))
+        return false;
+
+    CheckGL("Begin PlotLOD::draw");
+    /* the window may render to a framebuffer object of its own */
+    GLint drawFbo = 0;
+    GLint readFbo = 0;
+    GLint viewport[4];
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean blend   = glIsEnabled(GL_BLEND);
+    GLboolean depth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    GLsizei columns = GLsizei(pColumns + 2);
+    if (columns != mColumnWidth) {
+        for (int t=0; t<2; ++t) {
+            glBindTexture(GL_TEXTURE_2D, mColumns[t]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, columns, 1, 0, GL_RGBA, GL_FLOAT, NULL);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, mColumnFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mColumns[0], 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mColumns[1], 0);
+        const GLenum attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, attachments);
+        mColumnWidth = columns;
+    }
+
+    /* the points of each column are found once, in a pass of
+     * one fragment per column, rather than by each of its vertices */
+    glBindFramebuffer(GL_FRAMEBUFFER, mColumnFramebuffer);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glViewport(0, 0, columns, 1);
+    bindVAO(pWindowId);
+
+    glUseProgram(mColumnProgram);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "points"), 0);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "pyramid"), 1);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "base"), pFirst);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "count"), mCount);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "bucket"), BASE_BUCKET);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "width"), LEVEL_WIDTH);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "levels"), GLint(mBuckets.size()));
+    glUniform1iv(glGetUniformLocation(mColumnProgram, "levelRow"), GLsizei(mBuckets.size()), mRows.data());
+    glUniform1f(glGetUniformLocation(mColumnProgram, "xmin"), pXMin);
+    glUniform1f(glGetUniformLocation(mColumnProgram, "xstep"), (pXMax - pXMin) / pColumns);
+    glUniform1i(glGetUniformLocation(mColumnProgram, "columns"), pColumns);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mPyramid);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, mPointTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, mTexelFormat, pBuffer);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    if (depth)
+        glEnable(GL_DEPTH_TEST);
+    if (blend)
+        glEnable(GL_BLEND);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, drawFbo);
+
+    glUseProgram(mDrawProgram);
+    glUniform1i(glGetUniformLocation(mDrawProgram, "firstLeft"), 0);
+    glUniform1i(glGetUniformLocation(mDrawProgram, "rightLast"), 1);
+    glUniformMatrix4fv(glGetUniformLocation(mDrawProgram, "transform"),
+                       1, GL_FALSE, glm::value_ptr(pTransform));
+    glUniform4fv(glGetUniformLocation(mDrawProgram, "color"), 1, pColor);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, mColumns[1]);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, mColumns[0]);
+    glDrawArrays(GL_LINE_STRIP, 0, 4*columns);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glUseProgram(0);
+    CheckGL("End PlotLOD::draw");
+    return true;
+}
+
+}
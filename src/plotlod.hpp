@@ -0,0 +1,98 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace internal
+{
+
+/* Min/max pyramid of the points of a line plot
+ *
+ * Level 1 splits the points into buckets of BASE_BUCKET points, every
+ * further level merges pairs of buckets of the level below, until a
+ * level has at most TOP_BUCKETS buckets. A bucket stores the points of
+ * it with the smallest and the largest y. The pyramid is built on the
+ * GPU from the buffer the plot draws from, one fragment per bucket, and
+ * the levels are stored one after the other in a single texture.
+ *
+ * Draws emit the first, lowest, highest and last point of the points
+ * that fall in each pixel column (M4 aggregation), which rasterizes to
+ * the same pixels as the whole line strip. A pass of one fragment per
+ * column finds the points of the column by binary search on x, so x has
+ * to be non-decreasing, and combines the largest buckets that fit in
+ * the column. The line is then drawn with 4 vertices per column read
+ * from the result of that pass, so a draw costs a few dozen fetches per
+ * column however many points the plot has. */
+class PlotLOD {
+    public:
+        static const unsigned BASE_BUCKET = 16;
+        static const unsigned TOP_BUCKETS = 256;
+        static const unsigned MAX_LEVELS  = 32;
+        /* width of the pyramid texture, bucket b of a
+         * level is at (b % W, first row of level + b / W) */
+        static const unsigned LEVEL_WIDTH = 2048;
+
+    private:
+        GLenum      mTexelFormat;
+        size_t      mPointSize;
+        const char* mSamplerPrefix;
+
+        unsigned    mCount;
+        /* bucket counts and first rows of the levels,
+         * the last row entry is the height of the pyramid */
+        std::vector<unsigned> mBuckets;
+        std::vector<GLint>    mRows;
+
+        GLuint      mPointTexture;
+        GLuint      mPyramid;
+        GLuint      mScratch;
+        GLuint      mFramebuffer;
+        /* first and lowest, highest and last point of each
+         * column, one texel per column in the two textures */
+        GLuint      mColumns[2];
+        GLuint      mColumnFramebuffer;
+        GLsizei     mColumnWidth;
+        ProgramRef  mReduceProgram;
+        ProgramRef  mMergeProgram;
+        ProgramRef  mColumnProgram;
+        ProgramRef  mDrawProgram;
+        std::map<int, GLuint> mVAOMap;
+
+        PlotLOD(const PlotLOD& other);
+        PlotLOD& operator=(const PlotLOD& other);
+
+        void bindVAO(int pWindowId);
+        void releaseLevels();
+
+    public:
+        /* pType is the type of the x, y pairs of the plot */
+        PlotLOD(GLenum pType);
+        ~PlotLOD();
+
+        /* rebuilds the pyramid from pCount points of pBuffer starting
+         * at point pFirst. Too few points, or more than a buffer texture
+         * can hold, leave no levels */
+        void build(int pWindowId, GLuint pBuffer, unsigned pFirst, unsigned pCount);
+
+        /* draws the points the pyramid was built from, with pBuffer and
+         * pFirst as passed to build, for the x range [pXMin, pXMax] over
+         * pColumns pixel columns. Returns false without drawing when there
+         * are no levels or drawing the points themselves is cheaper */
+        bool draw(int pWindowId, GLuint pBuffer, unsigned pFirst,
+                  float pXMin, float pXMax, unsigned pColumns,
+                  const glm::mat4& pTransform, const float* pColor);
+};
+
+}
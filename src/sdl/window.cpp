@@ -25,12 +25,12 @@ namespace wtk
 {
 
 Widget::Widget()
-    : mWindow(nullptr), mClose(false)
+    : mWindow(nullptr), mClose(false), mDamaged(false)
 {
 }
 
 Widget::Widget(int pWidth, int pHeight, const char* pTitle, const Widget* pWindow, const bool invisible)
-    : mWindow(nullptr), mClose(false)
+    : mWindow(nullptr), mClose(false), mDamaged(false)
 {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "ERROR: SDL wasn't able to initalize\n";
@@ -86,6 +86,11 @@ void Widget::makeContextCurrent() const
     SDL_GL_MakeCurrent(mWindow, mContext);
 }
 
+void Widget::releaseContext() const
+{
+    SDL_GL_MakeCurrent(mWindow, NULL);
+}
+
 long long Widget::getGLContextHandle()
 {
 #ifdef OS_WIN
@@ -156,27 +161,49 @@ void Widget::resetCloseFlag()
     }
 }
 
+bool Widget::takeDamage()
+{
+    bool damaged = mDamaged;
+    mDamaged = false;
+    return damaged;
+}
+
 void Widget::pollEvents()
 {
     SDL_Event evnt;
-    SDL_PollEvent(&evnt);
+    if (SDL_PollEvent(&evnt))
+        handleEvent(evnt);
+}
 
+void Widget::waitEvents(double pTimeout)
+{
+    SDL_Event evnt;
+    if (SDL_WaitEventTimeout(&evnt, int(pTimeout*1000.0)))
+        handleEvent(evnt);
+}
+
+void Widget::handleEvent(const SDL_Event& pEvent)
+{
     /* handle window events that are triggered
        when 'this' window was in focus
      */
-    if (evnt.type == SDL_WINDOWEVENT && evnt.window.windowID == mWindowId) {
-        switch(evnt.window.event) {
+    if (pEvent.type == SDL_WINDOWEVENT && pEvent.window.windowID == mWindowId) {
+        switch(pEvent.window.event) {
             case SDL_WINDOWEVENT_CLOSE:
                 hide();
                 break;
+            case SDL_WINDOWEVENT_EXPOSED:
+            case SDL_WINDOWEVENT_SIZE_CHANGED:
+                mDamaged = true;
+                break;
         }
     }
 
     /* handle keyboard press down events that are triggered
        when 'this' window was in focus
      */
-    if (evnt.type == SDL_KEYDOWN && evnt.key.windowID == mWindowId) {
-        switch(evnt.key.keysym.sym) {
+    if (pEvent.type == SDL_KEYDOWN && pEvent.key.windowID == mWindowId) {
+        switch(pEvent.key.keysym.sym) {
             case SDLK_ESCAPE:
                 hide();
                 break;
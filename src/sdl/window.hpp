@@ -21,10 +21,14 @@ class Widget {
         SDL_Window*     mWindow;
         SDL_GLContext   mContext;
         bool            mClose;
+        bool            mDamaged;
         uint32_t        mWindowId;
 
         Widget();
 
+        /* reacts to window and keyboard events of this window */
+        void handleEvent(const SDL_Event& pEvent);
+
     public:
         Widget(int pWidth, int pHeight, const char* pTitle, const Widget* pWindow, const bool invisible);
 
@@ -34,6 +38,9 @@ class Widget {
 
         void makeContextCurrent() const;
 
+        /* detaches the context from the calling thread */
+        void releaseContext() const;
+
         long long getGLContextHandle();
 
         long long getDisplayHandle();
@@ -60,8 +67,16 @@ class Widget {
 
         void resetCloseFlag();
 
+        /* whether the contents of the window were lost, by exposing or
+         * resizing it, since the last call */
+        bool takeDamage();
+
         void pollEvents();
 
+        /* like pollEvents, but blocks until an event
+         * arrives or pTimeout seconds have passed */
+        void waitEvents(double pTimeout);
+
 };
 
 }
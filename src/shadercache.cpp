@@ -0,0 +1,238 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <shadercache.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(OS_WIN)
+#include <direct.h>
+#include <process.h>
+#define FG_MKDIR(path) _mkdir(path)
+#define FG_GETPID()    _getpid()
+static const char PATH_SEPARATOR = '\\';
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define FG_MKDIR(path) mkdir(path, 0755)
+#define FG_GETPID()    getpid()
+static const char PATH_SEPARATOR = '/';
+#endif
+
+/* bump whenever the layout of cache files changes */
+static const uint32_t CACHE_FILE_VERSION = 1;
+
+struct CacheHeader {
+    char     mMagic[4];
+    uint32_t mVersion;
+    uint64_t mDriverHash;
+    uint64_t mSourceHash;
+    uint32_t mVertexLength;
+    uint32_t mFragmentLength;
+    uint32_t mFormat;
+    uint32_t mLength;
+};
+
+/* FNV-1a, unlike std::hash the value is the same for every build
+ * and hence can be used to name files shared between processes */
+static uint64_t fnv1a(const char* pData, size_t pSize, uint64_t pHash=14695981039346656037ULL)
+{
+    for (size_t i=0; i<pSize; ++i) {
+        pHash ^= (unsigned char)pData[i];
+        pHash *= 1099511628211ULL;
+    }
+    return pHash;
+}
+
+static uint64_t hashString(const char* pStr, uint64_t pHash=14695981039346656037ULL)
+{
+    return fnv1a(pStr, strlen(pStr)+1, pHash);
+}
+
+static uint64_t driverHash()
+{
+    const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i=0; i<sizeof(names)/sizeof(names[0]); ++i) {
+        const char* str = (const char*)glGetString(names[i]);
+        hash = hashString(str ? str : "", hash);
+    }
+    return hash;
+}
+
+static uint64_t sourceHash(const char* vshader_code, const char* fshader_code)
+{
+    return hashString(fshader_code, hashString(vshader_code));
+}
+
+static void makeDirectory(const std::string& pPath)
+{
+    /* create every missing component, errors are
+     * caught later when the cache file is written */
+    for (size_t i=1; i<=pPath.size(); ++i) {
+        if (i==pPath.size() || pPath[i]=='/' || pPath[i]==PATH_SEPARATOR) {
+            FG_MKDIR(pPath.substr(0, i).c_str());
+        }
+    }
+}
+
+static const std::string& cacheDirectory()
+{
+    static const std::string dir = []() {
+        std::string path;
+        const char* env = getenv("FG_SHADER_CACHE_DIR");
+        if (env) {
+            path = env;
+        } else {
+#if defined(OS_WIN)
+            const char* base = getenv("LOCALAPPDATA");
+            if (base && *base)
+                path = std::string(base) + PATH_SEPARATOR + "forge";
+#else
+            const char* xdg  = getenv("XDG_CACHE_HOME");
+            const char* home = getenv("HOME");
+            if (xdg && *xdg)
+                path = std::string(xdg) + PATH_SEPARATOR + "forge";
+            else if (home && *home)
+                path = std::string(home) + PATH_SEPARATOR + ".cache" + PATH_SEPARATOR + "forge";
+#endif
+        }
+        if (!path.empty())
+            makeDirectory(path);
+        return path;
+    }();
+    return dir;
+}
+
+static std::string cacheFilePath(uint64_t pDriverHash, uint64_t pSourceHash)
+{
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx.bin",
+             (unsigned long long)fnv1a((const char*)&pSourceHash, sizeof(pSourceHash), pDriverHash));
+    return cacheDirectory() + PATH_SEPARATOR + name;
+}
+
+bool programCacheEnabled()
+{
+    if (cacheDirectory().empty())
+        return false;
+    if (!GLEW_ARB_get_program_binary && !GLEW_VERSION_4_1)
+        return false;
+
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    return numFormats > 0;
+}
+
+GLuint loadCachedProgram(const char* vshader_code, const char* fshader_code)
+{
+    if (!programCacheEnabled())
+        return 0;
+
+    uint64_t dHash = driverHash();
+    uint64_t sHash = sourceHash(vshader_code, fshader_code);
+    std::string path = cacheFilePath(dHash, sHash);
+
+    std::ifstream file(path.c_str(), std::ios::in|std::ios::binary);
+    if (!file.is_open())
+        return 0;
+
+    CacheHeader header;
+    if (!file.read((char*)&header, sizeof(header)))
+        return 0;
+
+    if (memcmp(header.mMagic, "FGPB", 4)!=0 || header.mVersion!=CACHE_FILE_VERSION ||
+        header.mDriverHash!=dHash || header.mSourceHash!=sHash ||
+        header.mVertexLength!=strlen(vshader_code) ||
+        header.mFragmentLength!=strlen(fshader_code) || header.mLength==0)
+        return 0;
+
+    std::vector<char> binary(header.mLength);
+    if (!file.read(binary.data(), header.mLength))
+        return 0;
+    file.close();
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, (GLenum)header.mFormat, binary.data(), (GLsizei)header.mLength);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        /* the driver rejected the binary, possibly after an
+         * update that didn't change its version string. Drop the
+         * entry so that it is rewritten after the regular link */
+        glDeleteProgram(program);
+        while (glGetError()!=GL_NO_ERROR);
+        remove(path.c_str());
+        return 0;
+    }
+    return program;
+}
+
+void storeCachedProgram(GLuint pProgram, const char* vshader_code, const char* fshader_code)
+{
+    if (!programCacheEnabled())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(pProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format  = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(pProgram, length, &written, &format, binary.data());
+    if (written <= 0) {
+        while (glGetError()!=GL_NO_ERROR);
+        return;
+    }
+
+    CacheHeader header;
+    memcpy(header.mMagic, "FGPB", 4);
+    header.mVersion        = CACHE_FILE_VERSION;
+    header.mDriverHash     = driverHash();
+    header.mSourceHash     = sourceHash(vshader_code, fshader_code);
+    header.mVertexLength   = (uint32_t)strlen(vshader_code);
+    header.mFragmentLength = (uint32_t)strlen(fshader_code);
+    header.mFormat         = (uint32_t)format;
+    header.mLength         = (uint32_t)written;
+
+    std::string path = cacheFilePath(header.mDriverHash, header.mSourceHash);
+
+    /* several processes may populate the cache at once, each writes
+     * a private file and renames it in place so that readers never
+     * see a partially written entry */
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%d.tmp", (int)FG_GETPID());
+    std::string tmpPath = path + suffix;
+
+    {
+        std::ofstream file(tmpPath.c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+        if (!file.is_open())
+            return;
+        file.write((const char*)&header, sizeof(header));
+        file.write(binary.data(), written);
+        if (!file.good()) {
+            file.close();
+            remove(tmpPath.c_str());
+            return;
+        }
+    }
+
+    if (rename(tmpPath.c_str(), path.c_str())!=0)
+        remove(tmpPath.c_str());
+}
@@ -0,0 +1,36 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+/* On-disk cache of linked program binaries
+ *
+ * Linked programs are stored with glGetProgramBinary in a cache
+ * directory and reloaded with glProgramBinary by later processes,
+ * which saves compiling and linking the shaders on startup. Entries
+ * are keyed by the OpenGL vendor, renderer and version strings along
+ * with the shader sources, so a driver update invalidates them.
+ *
+ * The cache directory is taken from the FG_SHADER_CACHE_DIR environment
+ * variable, an empty value disables the cache. Otherwise a forge
+ * directory under the user's cache directory is used.
+ */
+
+/* true when the current context can retrieve and load program binaries
+ * and a cache directory is available */
+bool programCacheEnabled();
+
+/* returns a linked program loaded from the cache or 0 when there
+ * is no valid cache entry for the given sources */
+GLuint loadCachedProgram(const char* vshader_code, const char* fshader_code);
+
+/* stores the binary of a linked program, failures are ignored */
+void storeCachedProgram(GLuint pProgram, const char* vshader_code, const char* fshader_code);
@@ -0,0 +1,327 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <streambuffer.hpp>
+#include <bounds.hpp>
+
+#include <algorithm>
+
+namespace internal
+{
+
+StreamBuffer::StreamBuffer(size_t pRegionSize, GLuint pSource)
+    : mBuffer(0), mRegionSize(pRegionSize), mMappedPtr(NULL), mNewest(0), mWriting(-1)
+{
+    CheckGL("Begin StreamBuffer::StreamBuffer");
+    for (int i=0; i<STREAM_REGIONS; ++i)
+        mFences[i] = 0;
+
+    GLsizeiptr total = GLsizeiptr(mRegionSize * STREAM_REGIONS);
+
+    glGenBuffers(1, &mBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    if (GLEW_ARB_buffer_storage || GLEW_VERSION_4_4) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        /* dynamic storage allows partial updates with glBufferSubData */
+        glBufferStorage(GL_ARRAY_BUFFER, total, NULL, flags | GL_DYNAMIC_STORAGE_BIT);
+        mMappedPtr = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags);
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, total, NULL, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (pSource) {
+        glBindBuffer(GL_COPY_READ_BUFFER, pSource);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mRegionSize);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    CheckGL("End StreamBuffer::StreamBuffer");
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (int i=0; i<STREAM_REGIONS; ++i) {
+        if (mFences[i])
+            glDeleteSync(mFences[i]);
+    }
+    if (mMappedPtr) {
+        glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &mBuffer);
+}
+
+GLuint StreamBuffer::buffer() const
+{
+    return mBuffer;
+}
+
+size_t StreamBuffer::regionSize() const
+{
+    return mRegionSize;
+}
+
+size_t StreamBuffer::drawOffset() const
+{
+    return mNewest * mRegionSize;
+}
+
+int StreamBuffer::freeRegion()
+{
+    /* the newest region may be drawn again, any other
+     * region whose last draw has completed is free */
+    for (int i=1; i<STREAM_REGIONS; ++i) {
+        int region = (mNewest + i) % STREAM_REGIONS;
+        if (mFences[region]==0)
+            return region;
+
+        GLenum status = glClientWaitSync(mFences[region], 0, 0);
+        if (status==GL_ALREADY_SIGNALED || status==GL_CONDITION_SATISFIED) {
+            glDeleteSync(mFences[region]);
+            mFences[region] = 0;
+            return region;
+        }
+    }
+
+    /* the GPU is more than a frame behind, wait for the
+     * oldest region since writing any other would tear */
+    int oldest = (mNewest + 1) % STREAM_REGIONS;
+    glClientWaitSync(mFences[oldest], GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(-1));
+    glDeleteSync(mFences[oldest]);
+    mFences[oldest] = 0;
+    return oldest;
+}
+
+void* StreamBuffer::beginWrite()
+{
+    mWriting = freeRegion();
+
+    if (mMappedPtr)
+        return mMappedPtr + mWriting * mRegionSize;
+
+    /* the fence check above makes the region safe to
+     * overwrite, so the driver need not synchronize */
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    void* ptr = glMapBufferRange(GL_ARRAY_BUFFER, mWriting * mRegionSize, mRegionSize,
+                                 GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                 GL_MAP_INVALIDATE_RANGE_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return ptr;
+}
+
+void StreamBuffer::endWrite()
+{
+    if (mWriting < 0)
+        return;
+
+    if (!mMappedPtr) {
+        glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    mNewest  = mWriting;
+    mWriting = -1;
+}
+
+void StreamBuffer::update(BufferUpdates& pUpdates)
+{
+    int region = freeRegion();
+    size_t offset = region * mRegionSize;
+
+    /* both the copy and the writes are ordered
+     * by the GL, so no mapping is needed */
+    glBindBuffer(GL_COPY_READ_BUFFER, mBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, drawOffset(), offset, mRegionSize);
+    pUpdates.flush(GL_COPY_WRITE_BUFFER, offset);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    mNewest = region;
+}
+
+void StreamBuffer::copyTo(GLuint pTarget) const
+{
+    glBindBuffer(GL_COPY_READ_BUFFER, mBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pTarget);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, drawOffset(), 0, mRegionSize);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void StreamBuffer::copyFrom(GLuint pSource, size_t pSize)
+{
+    int region = freeRegion();
+
+    glBindBuffer(GL_COPY_READ_BUFFER, pSource);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, region * mRegionSize, pSize);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    mNewest = region;
+}
+
+void StreamBuffer::fence()
+{
+    if (mFences[mNewest])
+        glDeleteSync(mFences[mNewest]);
+    mFences[mNewest] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+AsyncUpload::AsyncUpload(AbstractRenderable* pOwner)
+    : mReady(-1), mReading(-1), mOwner(pOwner), mBoundsType(0), mBoundsComponents(0),
+      mDataSize(0)
+{
+    for (int i=0; i<ASYNC_SLOTS; ++i) {
+        mSlots[i].mBuffer    = 0;
+        mSlots[i].mSize      = 0;
+        mSlots[i].mCapacity  = 0;
+        mSlots[i].mWritten   = 0;
+        mSlots[i].mRead      = 0;
+        mSlots[i].mHasBounds = false;
+    }
+}
+
+AsyncUpload::~AsyncUpload()
+{
+    for (int i=0; i<ASYNC_SLOTS; ++i) {
+        if (mSlots[i].mWritten)
+            glDeleteSync(mSlots[i].mWritten);
+        if (mSlots[i].mRead)
+            glDeleteSync(mSlots[i].mRead);
+        if (mSlots[i].mBuffer)
+            glDeleteBuffers(1, &mSlots[i].mBuffer);
+    }
+}
+
+void AsyncUpload::detach()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mOwner = NULL;
+}
+
+void AsyncUpload::setBoundsLayout(GLenum pType, unsigned pComponents)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBoundsType       = pType;
+    mBoundsComponents = pComponents;
+}
+
+void AsyncUpload::setDataSize(size_t pSize)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mDataSize = pSize;
+}
+
+size_t AsyncUpload::dataSize()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mDataSize;
+}
+
+void AsyncUpload::write(const void* pData, size_t pSize)
+{
+    std::lock_guard<std::mutex> writeLock(mWriteMutex);
+
+    int s = 0;
+    GLenum   type = 0;
+    unsigned components = 0;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        while (s==mReady || s==mReading)
+            ++s;
+        type       = mBoundsType;
+        components = mBoundsComponents;
+    }
+    Slot& slot = mSlots[s];
+
+    /* the bounds are computed on the upload thread
+     * so that the render thread doesn't have to */
+    slot.mHasBounds = (components > 0);
+    if (slot.mHasBounds) {
+        size_t tuple = components * gl_sizeof(type);
+        computeBounds(pData, type, components, pSize / tuple, slot.mMin, slot.mMax);
+    }
+
+    /* the render thread may still be copying from this
+     * buffer, make the GPU wait for that before writing */
+    if (slot.mRead) {
+        glWaitSync(slot.mRead, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(slot.mRead);
+        slot.mRead = 0;
+    }
+    if (slot.mWritten) {
+        glDeleteSync(slot.mWritten);
+        slot.mWritten = 0;
+    }
+    if (!slot.mBuffer)
+        glGenBuffers(1, &slot.mBuffer);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, slot.mBuffer);
+    if (pSize > slot.mCapacity) {
+        glBufferData(GL_COPY_WRITE_BUFFER, pSize, NULL, GL_STREAM_COPY);
+        slot.mCapacity = pSize;
+    }
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, pSize, pData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    slot.mSize    = pSize;
+    slot.mWritten = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    /* a fence waited for by another context has to be flushed */
+    glFlush();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mReady = s;
+    if (mOwner)
+        mOwner->markDirty();
+}
+
+GLuint AsyncUpload::receive(size_t* pSize)
+{
+    int s = -1;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mReady < 0)
+            return 0;
+        s = mReady;
+        mReading = s;
+        mReady   = -1;
+    }
+    glWaitSync(mSlots[s].mWritten, 0, GL_TIMEOUT_IGNORED);
+    *pSize = mSlots[s].mSize;
+    return mSlots[s].mBuffer;
+}
+
+bool AsyncUpload::receivedBounds(float* pMin, float* pMax) const
+{
+    if (mReading < 0 || !mSlots[mReading].mHasBounds)
+        return false;
+    std::copy(mSlots[mReading].mMin, mSlots[mReading].mMin + 3, pMin);
+    std::copy(mSlots[mReading].mMax, mSlots[mReading].mMax + 3, pMax);
+    return true;
+}
+
+void AsyncUpload::endReceive()
+{
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mReading >= 0) {
+        mSlots[mReading].mRead = fence;
+        mReading = -1;
+    } else {
+        glDeleteSync(fence);
+    }
+}
+
+}
@@ -0,0 +1,146 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <mutex>
+
+namespace internal
+{
+
+/* Vertex data storage for objects whose data changes every frame
+ *
+ * The buffer holds STREAM_REGIONS copies of the data. Writes go to a
+ * region the GPU is not reading, draws use the most recently written
+ * region and fence it, so uploads don't wait for earlier draws
+ * to finish. Storage is persistently mapped when buffer storage
+ * is available, otherwise regions are mapped unsynchronized. */
+class StreamBuffer {
+    public:
+        static const int STREAM_REGIONS = 3;
+
+    private:
+        GLuint         mBuffer;
+        size_t         mRegionSize;
+        unsigned char* mMappedPtr;
+        GLsync         mFences[STREAM_REGIONS];
+        int            mNewest;
+        int            mWriting;
+
+        StreamBuffer(const StreamBuffer& other);
+        StreamBuffer& operator=(const StreamBuffer& other);
+
+        int freeRegion();
+
+    public:
+        /* pSource is copied to the first region, if not zero */
+        StreamBuffer(size_t pRegionSize, GLuint pSource);
+        ~StreamBuffer();
+
+        GLuint buffer() const;
+        size_t regionSize() const;
+        /* byte offset of the region draws read from */
+        size_t drawOffset() const;
+
+        /* returns a pointer to mRegionSize bytes of a region that is
+         * not read by pending draws, endWrite makes it the one
+         * subsequent draws read from */
+        void* beginWrite();
+        void endWrite();
+
+        /* makes a copy of the region draws read from with
+         * pUpdates applied the one subsequent draws read from */
+        void update(BufferUpdates& pUpdates);
+
+        /* copies the region draws read from to pTarget */
+        void copyTo(GLuint pTarget) const;
+        /* makes a copy of the first pSize bytes of pSource
+         * the region subsequent draws read from */
+        void copyFrom(GLuint pSource, size_t pSize);
+
+        /* to be called after each draw that read the buffer */
+        void fence();
+};
+
+/* Hands data written by an upload thread to the render thread
+ *
+ * The upload thread writes into one of ASYNC_SLOTS buffers that is
+ * neither the newest published one nor read by the render thread,
+ * fences the write and publishes the buffer. The render thread waits
+ * for that fence on the GPU, copies the buffer to where draws read
+ * from and fences the copy, which the upload thread waits for on the
+ * GPU before writing the buffer again. Neither thread blocks the
+ * other for longer than the bookkeeping. */
+class AsyncUpload {
+    public:
+        static const int ASYNC_SLOTS = 3;
+
+    private:
+        struct Slot {
+            GLuint mBuffer;
+            size_t mSize;
+            size_t mCapacity;
+            GLsync mWritten;
+            GLsync mRead;
+            bool   mHasBounds;
+            float  mMin[3];
+            float  mMax[3];
+        };
+
+        Slot                mSlots[ASYNC_SLOTS];
+        int                 mReady;
+        int                 mReading;
+        /* marked modified when data is published, reset
+         * when the renderable is destroyed */
+        AbstractRenderable* mOwner;
+        std::mutex          mMutex;
+        /* serializes upload threads of different windows */
+        std::mutex          mWriteMutex;
+        /* layout of the data for computeBounds */
+        GLenum              mBoundsType;
+        unsigned            mBoundsComponents;
+        /* bytes of data the owner holds */
+        size_t              mDataSize;
+
+        AsyncUpload(const AsyncUpload& other);
+        AsyncUpload& operator=(const AsyncUpload& other);
+
+    public:
+        AsyncUpload(AbstractRenderable* pOwner);
+        ~AsyncUpload();
+
+        void detach();
+
+        /* makes write compute the bounds of data of pComponents values of
+         * type pType per tuple, none are computed while pComponents is 0 */
+        void setBoundsLayout(GLenum pType, unsigned pComponents);
+
+        /* render thread: records the size of the data of the owner */
+        void setDataSize(size_t pSize);
+        /* any thread: the size of the data of the owner, to be
+         * uploaded instead of reading the owner's own size */
+        size_t dataSize();
+
+        /* upload thread: copies pSize bytes from pData and publishes them */
+        void write(const void* pData, size_t pSize);
+
+        /* render thread: returns the buffer holding data published since
+         * the last call or 0, and its size in pSize. Commands issued after
+         * the call see the complete data. endReceive must follow the
+         * commands that read the buffer */
+        GLuint receive(size_t* pSize);
+        /* bounds of the data returned by receive, false
+         * if none were computed for it */
+        bool receivedBounds(float* pMin, float* pMax) const;
+        void endReceive();
+};
+
+}
@@ -0,0 +1,209 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <fg/streamplot.h>
+#include <streamplot.hpp>
+#include <common.hpp>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace internal
+{
+
+streamplot_impl::streamplot_impl(unsigned pCapacity, fg::dtype pDataType,
+                                 fg::PlotType pPlotType, fg::MarkerType pMarkerType)
+    : plot_impl(pCapacity+1, pDataType, pPlotType, pMarkerType),
+      mCapacity(pCapacity), mHead(0), mCount(0),
+      mSampleX(pCapacity), mScrollPending(false)
+{
+    if (pCapacity==0)
+        throw fg::ArgumentError("StreamPlot::StreamPlot", __LINE__, 1,
+                                "Capacity has to be positive");
+}
+
+float streamplot_impl::sampleX(const unsigned char* pSample) const
+{
+    switch(mGLType) {
+        case GL_INT:            return float(*(const int*)pSample);
+        case GL_UNSIGNED_INT:   return float(*(const unsigned*)pSample);
+        case GL_SHORT:          return float(*(const short*)pSample);
+        case GL_UNSIGNED_SHORT: return float(*(const unsigned short*)pSample);
+        case GL_UNSIGNED_BYTE:  return float(*pSample);
+        default:                return *(const float*)pSample;
+    }
+}
+
+void streamplot_impl::append(const void* pData, unsigned pCount)
+{
+    const unsigned char* samples = (const unsigned char*)pData;
+
+    /* only the newest mCapacity samples can be displayed */
+    if (pCount > mCapacity) {
+        samples += (pCount - mCapacity) * mPointSize;
+        pCount   = mCapacity;
+    }
+    if (pCount==0)
+        return;
+
+    /* at most two writes, the second one
+     * for samples that wrap around */
+    unsigned first = std::min(pCount, mCapacity - mHead);
+    update(samples, mHead * mPointSize, first * mPointSize);
+    if (pCount > first)
+        update(samples + first * mPointSize, 0, (pCount - first) * mPointSize);
+
+    if (mHead==0 || pCount > first) {
+        const unsigned char* zero = samples + (mHead==0 ? 0 : first) * mPointSize;
+        update(zero, mCapacity * mPointSize, mPointSize);
+    }
+
+    for (unsigned i=0; i<pCount; ++i)
+        mSampleX[(mHead + i) % mCapacity] = sampleX(samples + i * mPointSize);
+
+    mHead  = (mHead + pCount) % mCapacity;
+    mCount = std::min(mCount + pCount, mCapacity);
+
+    unsigned oldest = (mCount < mCapacity ? 0 : mHead);
+    unsigned newest = (mHead + mCapacity - 1) % mCapacity;
+    mXMin = mSampleX[oldest];
+    mXMax = mSampleX[newest];
+    /* tick labels are generated once per frame by render */
+    mScrollPending = true;
+}
+
+void streamplot_impl::clear()
+{
+    mHead  = 0;
+    mCount = 0;
+    markDirty();
+}
+
+unsigned streamplot_impl::capacity() const
+{
+    return mCapacity;
+}
+
+unsigned streamplot_impl::count() const
+{
+    return mCount;
+}
+
+void streamplot_impl::drawPoints(GLenum pMode)
+{
+    if (mCount < mCapacity || mHead==0) {
+        glDrawArrays(pMode, 0, mCount);
+        return;
+    }
+
+    /* the ring has wrapped around, the older samples are at
+     * its end. A line strip continues to the mirrored first
+     * slot to join the newer samples at the start */
+    GLsizei tail = mCapacity - mHead + (pMode==GL_LINE_STRIP ? 1 : 0);
+    glDrawArrays(pMode, mHead, tail);
+    glDrawArrays(pMode, 0, mHead);
+}
+
+void streamplot_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
+{
+    if (mScrollPending) {
+        applyAxesLimits(xmax(), xmin(), ymax(), ymin(), zmax(), zmin());
+        mScrollPending = false;
+    }
+    plot_impl::render(pWindowId, pX, pY, pVPW, pVPH);
+}
+
+}
+
+namespace fg
+{
+
+StreamPlot::StreamPlot(unsigned pCapacity, fg::dtype pDataType,
+                       fg::PlotType pPlotType, fg::MarkerType pMarkerType)
+{
+    value = new internal::_StreamPlot(pCapacity, pDataType, pPlotType, pMarkerType);
+}
+
+StreamPlot::StreamPlot(const StreamPlot& other)
+{
+    value = new internal::_StreamPlot(*other.get());
+}
+
+StreamPlot::~StreamPlot()
+{
+    delete value;
+}
+
+void StreamPlot::setColor(fg::Color col)
+{
+    value->setColor(col);
+}
+
+void StreamPlot::setColor(float r, float g, float b)
+{
+    value->setColor(r, g, b);
+}
+
+void StreamPlot::setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin)
+{
+    value->setAxesLimits(pXmax, pXmin, pYmax, pYmin);
+}
+
+void StreamPlot::setAxesTitles(const char* pXTitle, const char* pYTitle)
+{
+    value->setAxesTitles(pXTitle, pYTitle);
+}
+
+float StreamPlot::xmax() const
+{
+    return value->xmax();
+}
+
+float StreamPlot::xmin() const
+{
+    return value->xmin();
+}
+
+float StreamPlot::ymax() const
+{
+    return value->ymax();
+}
+
+float StreamPlot::ymin() const
+{
+    return value->ymin();
+}
+
+void StreamPlot::append(const void* pData, unsigned pCount)
+{
+    value->append(pData, pCount);
+}
+
+void StreamPlot::clear()
+{
+    value->clear();
+}
+
+unsigned StreamPlot::capacity() const
+{
+    return value->capacity();
+}
+
+unsigned StreamPlot::count() const
+{
+    return value->count();
+}
+
+internal::_StreamPlot* StreamPlot::get() const
+{
+    return value;
+}
+
+}
@@ -0,0 +1,116 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <plot.hpp>
+#include <memory>
+#include <vector>
+
+namespace internal
+{
+
+/* Plot of the most recent samples of a time series
+ *
+ * The vertex buffer is a ring of mCapacity points, appended samples
+ * overwrite the oldest ones and only the new samples are uploaded.
+ * The slot following the ring mirrors its first slot so that a line
+ * strip over the older samples at the end of the ring connects to
+ * the newer ones that wrapped around to its start. */
+class streamplot_impl : public plot_impl {
+    private:
+        unsigned mCapacity;
+        /* slot the next sample is written to */
+        unsigned mHead;
+        /* number of valid samples, at most mCapacity */
+        unsigned mCount;
+        /* x coordinates of the samples in the ring, the
+         * x-axis spans from the oldest to the newest one */
+        std::vector<float> mSampleX;
+        bool     mScrollPending;
+
+        float sampleX(const unsigned char* pSample) const;
+
+    protected:
+        void drawPoints(GLenum pMode);
+
+    public:
+        streamplot_impl(unsigned pCapacity, fg::dtype pDataType, fg::PlotType, fg::MarkerType);
+
+        void append(const void* pData, unsigned pCount);
+        void clear();
+
+        unsigned capacity() const;
+        unsigned count() const;
+
+        void render(int pWindowId, int pX, int pY, int pViewPortWidth, int pViewPortHeight);
+};
+
+class _StreamPlot {
+    private:
+        std::shared_ptr<streamplot_impl> plt;
+
+    public:
+        _StreamPlot(unsigned pCapacity, fg::dtype pDataType, fg::PlotType pType, fg::MarkerType mType)
+            : plt(std::make_shared<streamplot_impl>(pCapacity, pDataType, pType, mType)) {}
+
+        inline const std::shared_ptr<streamplot_impl>& impl() const {
+            return plt;
+        }
+
+        inline void setColor(fg::Color col) {
+            plt->setColor(col);
+        }
+
+        inline void setColor(float r, float g, float b) {
+            plt->setColor(r, g, b);
+        }
+
+        inline void setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin) {
+            plt->setAxesLimits(pXmax, pXmin, pYmax, pYmin);
+        }
+
+        inline void setAxesTitles(const char* pXTitle, const char* pYTitle) {
+            plt->setAxesTitles(pXTitle, pYTitle);
+        }
+
+        inline float xmax() const {
+            return plt->xmax();
+        }
+
+        inline float xmin() const {
+            return plt->xmin();
+        }
+
+        inline float ymax() const {
+            return plt->ymax();
+        }
+
+        inline float ymin() const {
+            return plt->ymin();
+        }
+
+        inline void append(const void* pData, unsigned pCount) {
+            plt->append(pData, pCount);
+        }
+
+        inline void clear() {
+            plt->clear();
+        }
+
+        inline unsigned capacity() const {
+            return plt->capacity();
+        }
+
+        inline unsigned count() const {
+            return plt->count();
+        }
+};
+
+}
@@ -11,7 +11,9 @@
 #include <surface.hpp>
 #include <common.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -111,8 +113,6 @@ void surface_impl::bindResources(int pWindowId)
         glBindVertexArray(vao);
         // attach plot vertices
         glEnableVertexAttribArray(mPointIndex);
-        glBindBuffer(GL_ARRAY_BUFFER, mMainVBO);
-        glVertexAttribPointer(mPointIndex, 3, mDataType, GL_FALSE, 0, 0);
         //attach indices
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexVBO);
         glBindVertexArray(0);
@@ -122,6 +122,7 @@ void surface_impl::bindResources(int pWindowId)
     }
 
     glBindVertexArray(mVAOMap[pWindowId]);
+    attachDataBuffer(mPointIndex, 3, mDataType);
 }
 
 void surface_impl::unbindResources() const { glBindVertexArray(0); }
@@ -149,16 +150,17 @@ void generate_grid_indices(unsigned short rows, unsigned short cols, unsigned sh
 surface_impl::surface_impl(unsigned pNumXPoints, unsigned pNumYPoints,
                            fg::dtype pDataType, fg::MarkerType pMarkerType)
     : Chart3D(), mNumXPoints(pNumXPoints),mNumYPoints(pNumYPoints),
-      mDataType(gl_dtype(pDataType)), mMainVBO(0), mMainVBOsize(0),
-      mIndexVBO(0), mIndexVBOsize(0), mPointIndex(0), mMarkerTypeIndex(0),
+      mDataType(gl_dtype(pDataType)), mPointSize(0),
+      mIndexVBO(0), mIndexVBOsize(0), mIndexVBOcapacity(0), mPointIndex(0), mMarkerTypeIndex(0),
       mMarkerColIndex(0), mSpriteTMatIndex(0), mSurfPointIndex(0),
-      mSurfTMatIndex(0), mSurfRangeIndex(0)
+      mSurfTMatIndex(0), mSurfRangeIndex(0), mDensityLogScale(false),
+      mColorMap(0), mColorMapLength(0)
 {
     CheckGL("Begin surface_impl::surface_impl");
     mPointIndex    = mBorderAttribPointIndex;
     mMarkerType    = pMarkerType;
-    mSurfProgram   = initShaders(gMarkerVertexShaderSrc, gSurfFragmentShaderSrc);
-    mMarkerProgram = initShaders(gMarkerVertexShaderSrc, gMarkerSpriteFragmentShaderSrc);
+    mSurfProgram   = acquireProgram(gMarkerVertexShaderSrc, gSurfFragmentShaderSrc);
+    mMarkerProgram = acquireProgram(gMarkerVertexShaderSrc, gMarkerSpriteFragmentShaderSrc);
 
     mSurfPointIndex   = glGetAttribLocation (mSurfProgram, "point");
     mSurfTMatIndex    = glGetUniformLocation(mSurfProgram, "transform");
@@ -168,45 +170,33 @@ surface_impl::surface_impl(unsigned pNumXPoints, unsigned pNumYPoints,
     mMarkerColIndex   = glGetUniformLocation(mMarkerProgram, "line_color");
     mSpriteTMatIndex  = glGetUniformLocation(mMarkerProgram, "transform");
 
-    unsigned total_points = 3*(mNumXPoints * mNumYPoints);
+    glGenBuffers(1, &mIndexVBO);
+    generateIndices();
 
-    mIndexVBOsize = (2 * mNumYPoints) * (mNumXPoints - 1);
-    unsigned short* indices = new unsigned short[mIndexVBOsize];
-    generate_grid_indices(mNumXPoints, mNumYPoints, indices);
-    mIndexVBO = createBuffer<unsigned short>(GL_ELEMENT_ARRAY_BUFFER, mIndexVBOsize, NULL, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexVBO);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, mIndexVBOsize * sizeof(unsigned short), indices);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    delete[] indices;
-
-    // buffersubdata calls on mMainVBO
-    // will only update the points data
+    // each point is a (x, y, z) triple
     switch(mDataType) {
-        case GL_FLOAT:
-            mMainVBO = createBuffer<float>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(float);
-            break;
-        case GL_INT:
-            mMainVBO = createBuffer<int>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(int);
-            break;
-        case GL_UNSIGNED_INT:
-            mMainVBO = createBuffer<unsigned>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned);
-            break;
-        case GL_UNSIGNED_BYTE:
-            mMainVBO = createBuffer<unsigned char>(GL_ARRAY_BUFFER, total_points, NULL, GL_DYNAMIC_DRAW);
-            mMainVBOsize = total_points*sizeof(unsigned char);
-            break;
+        case GL_FLOAT:         mPointSize = 3*sizeof(float);         break;
+        case GL_INT:           mPointSize = 3*sizeof(int);           break;
+        case GL_UNSIGNED_INT:  mPointSize = 3*sizeof(unsigned);      break;
+        case GL_UNSIGNED_BYTE: mPointSize = 3*sizeof(unsigned char); break;
         default: fg::TypeError("Plot::Plot", __LINE__, 1, pDataType);
     }
+    setDataLayout(mDataType, 3);
+    createDataBuffer(mNumXPoints*mNumYPoints*mPointSize);
     CheckGL("End surface_impl::surface_impl");
 }
 
 surface_impl::~surface_impl()
 {
     CheckGL("Begin Plot::~Plot");
-    glDeleteBuffers(1, &mMainVBO);
+    for (auto it = mVAOMap.begin(); it!=mVAOMap.end(); ++it) {
+        GLuint vao = it->second;
+        glDeleteVertexArrays(1, &vao);
+    }
+    glDeleteBuffers(1, &mIndexVBO);
+    mDensity.reset();
+    releaseProgram(mMarkerProgram);
+    releaseProgram(mSurfProgram);
     CheckGL("End Plot::~Plot");
 }
 
@@ -216,6 +206,7 @@ void surface_impl::setColor(fg::Color col)
     mLineColor[1] = (((int) col >> 16 ) & 0xFF ) / 255.f;
     mLineColor[2] = (((int) col >> 8  ) & 0xFF ) / 255.f;
     mLineColor[3] = (((int) col       ) & 0xFF ) / 255.f;
+    markDirty();
 }
 
 void surface_impl::setColor(float r, float g, float b)
@@ -224,14 +215,67 @@ void surface_impl::setColor(float r, float g, float b)
     mLineColor[1] = clampTo01(g);
     mLineColor[2] = clampTo01(b);
     mLineColor[3] = 1.0f;
+    markDirty();
+}
+
+void surface_impl::generateIndices()
+{
+    mIndexVBOsize = mNumXPoints ? (2 * mNumYPoints) * (mNumXPoints - 1) : 0;
+    std::vector<unsigned short> indices(mIndexVBOsize);
+    if (mIndexVBOsize)
+        generate_grid_indices(mNumXPoints, mNumYPoints, indices.data());
+
+    /* the buffer object is kept, so the vertex
+     * arrays referring to it remain valid */
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexVBO);
+    if (mIndexVBOsize > mIndexVBOcapacity) {
+        mIndexVBOcapacity = std::max(mIndexVBOsize, 2*mIndexVBOcapacity);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndexVBOcapacity * sizeof(unsigned short), NULL, GL_STATIC_DRAW);
+    }
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, mIndexVBOsize * sizeof(unsigned short), indices.data());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
-GLuint surface_impl::vbo() const { return mMainVBO; }
+void surface_impl::resize(unsigned pNumXPoints, unsigned pNumYPoints)
+{
+    CheckGL("Begin surface_impl::resize");
+    resizeDataBuffer(pNumXPoints*pNumYPoints*mPointSize);
+    if (pNumXPoints!=mNumXPoints || pNumYPoints!=mNumYPoints) {
+        mNumXPoints = pNumXPoints;
+        mNumYPoints = pNumYPoints;
+        generateIndices();
+    }
+    CheckGL("End surface_impl::resize");
+}
 
-size_t surface_impl::size() const { return mMainVBOsize; }
+void surface_impl::setDensityMap(bool pEnable, bool pLogScale)
+{
+    if (pEnable && !mDensity)
+        mDensity.reset(new DensityMap());
+    else if (!pEnable)
+        mDensity.reset();
+    mDensityLogScale = pLogScale;
+    markDirty();
+}
+
+void surface_impl::setColorMapParams(GLuint tex, GLuint size)
+{
+    mColorMap = tex;
+    mColorMapLength = size;
+}
+
+unsigned surface_impl::numXPoints() const { return mNumXPoints; }
+
+unsigned surface_impl::numYPoints() const { return mNumYPoints; }
+
+GLuint surface_impl::vbo() const { return mDataVBO; }
+
+size_t surface_impl::size() const { return mDataSize; }
 
 void surface_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
 {
+    updateAutoAxes(pWindowId);
+
     float range_x = xmax() - xmin();
     float range_y = ymax() - ymin();
     float range_z = zmax() - zmin();
@@ -253,6 +297,7 @@ void surface_impl::render(int pWindowId, int pX, int pY, int pVPW, int pVPH)
     glm::mat4 mvp = projection * view * model;
     glm::mat4 transform = mvp;
     renderGraph(pWindowId, transform);
+    fenceDataBuffer();
 
     /* render graph border and axes */
     renderChart(pWindowId, pX, pY, pVPW, pVPH);
@@ -274,7 +319,9 @@ void surface_impl::renderGraph(int pWindowId, glm::mat4 transform)
     unbindResources();
     unbindSurfProgram();
 
-    if(mMarkerType != fg::FG_NONE) {
+    if(mDensity && mMarkerType != fg::FG_NONE) {
+        renderDensity(pWindowId, transform);
+    } else if(mMarkerType != fg::FG_NONE) {
         glEnable(GL_PROGRAM_POINT_SIZE);
         glUseProgram(mMarkerProgram);
 
@@ -291,6 +338,16 @@ void surface_impl::renderGraph(int pWindowId, glm::mat4 transform)
     CheckGL("End surface_impl::renderGraph");
 }
 
+void surface_impl::renderDensity(int pWindowId, const glm::mat4& pTransform)
+{
+    /* the index buffer visits points more than once */
+    mDensity->begin(pTransform);
+    bindResources(pWindowId);
+    glDrawArrays(GL_POINTS, 0, mNumXPoints*mNumYPoints);
+    unbindResources();
+    mDensity->end(pWindowId, mColorMap, mColorMapLength, mDensityLogScale);
+}
+
 GLuint surface_impl::markerTypeIndex() const { return mMarkerTypeIndex; }
 
 GLuint surface_impl::spriteMatIndex() const { return mSpriteTMatIndex; }
@@ -308,7 +365,9 @@ void surface_impl::unbindSurfProgram() const { glUseProgram(0); }
 
 void scatter3_impl::renderGraph(int pWindowId, glm::mat4 transform)
 {
-    if(mMarkerType != fg::FG_NONE) {
+    if(mDensity) {
+        renderDensity(pWindowId, transform);
+    } else if(mMarkerType != fg::FG_NONE) {
         glEnable(GL_PROGRAM_POINT_SIZE);
         glUseProgram(mMarkerProgram);
 
@@ -359,11 +418,26 @@ void Surface::setAxesLimits(float pXmax, float pXmin, float pYmax, float pYmin,
     value->setAxesLimits(pXmax, pXmin, pYmax, pYmin, pZmax, pZmin);
 }
 
+void Surface::setAutoAxes(bool pAuto)
+{
+    value->setAutoAxes(pAuto);
+}
+
 void Surface::setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle)
 {
     value->setAxesTitles(pXTitle, pYTitle, pZTitle);
 }
 
+void Surface::resize(unsigned pNumXPoints, unsigned pNumYPoints)
+{
+    value->resize(pNumXPoints, pNumYPoints);
+}
+
+void Surface::setDensityMap(bool pEnable, bool pLogScale)
+{
+    value->setDensityMap(pEnable, pLogScale);
+}
+
 float Surface::xmax() const
 {
     return value->xmax();
@@ -404,6 +478,46 @@ unsigned Surface::size() const
     return (unsigned)value->size();
 }
 
+void Surface::markDirty()
+{
+    value->markDirty();
+}
+
+void Surface::vboWritten()
+{
+    value->vboWritten();
+}
+
+void Surface::setStreaming(bool pStreaming)
+{
+    value->setStreaming(pStreaming);
+}
+
+bool Surface::streaming() const
+{
+    return value->streaming();
+}
+
+void Surface::upload(const void* pData)
+{
+    value->upload(pData);
+}
+
+void Surface::update(const void* pData, unsigned pOffset, unsigned pSize)
+{
+    value->update(pData, pOffset, pSize);
+}
+
+void* Surface::map(MapAccess pAccess)
+{
+    return value->map(pAccess);
+}
+
+void Surface::unmap()
+{
+    value->unmap();
+}
+
 internal::_Surface* Surface::get() const
 {
     return value;
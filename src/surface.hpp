@@ -11,6 +11,7 @@
 
 #include <common.hpp>
 #include <chart.hpp>
+#include <density.hpp>
 #include <memory>
 #include <map>
 #include <glm/glm.hpp>
@@ -24,15 +25,15 @@ class surface_impl : public Chart3D {
         GLuint    mNumXPoints;
         GLuint    mNumYPoints;
         GLenum    mDataType;
+        size_t    mPointSize;
         float     mLineColor[4];
         fg::MarkerType mMarkerType;
         /* OpenGL Objects */
-        GLuint    mMainVBO;
-        size_t    mMainVBOsize;
         GLuint    mIndexVBO;
         size_t    mIndexVBOsize;
-        GLuint    mMarkerProgram;
-        GLuint    mSurfProgram;
+        size_t    mIndexVBOcapacity;
+        ProgramRef mMarkerProgram;
+        ProgramRef mSurfProgram;
         /* shared variable index locations */
         GLuint    mPointIndex;
         GLuint    mMarkerTypeIndex;
@@ -44,10 +45,20 @@ class surface_impl : public Chart3D {
 
         std::map<int, GLuint> mVAOMap;
 
+        /* points drawn as a density map instead of markers */
+        std::unique_ptr<DensityMap> mDensity;
+        bool      mDensityLogScale;
+        GLuint    mColorMap;
+        GLuint    mColorMapLength;
+
         /* bind and unbind helper functions
          * for rendering resources */
         void bindResources(int pWindowId);
         void unbindResources() const;
+        /* draws every point of the grid once into the density map */
+        void renderDensity(int pWindowId, const glm::mat4& pTransform);
+        /* fills the index buffer for the current grid size */
+        void generateIndices();
         void bindSurfProgram() const;
         void unbindSurfProgram() const;
         GLuint markerTypeIndex() const;
@@ -63,6 +74,14 @@ class surface_impl : public Chart3D {
 
         void setColor(fg::Color col);
         void setColor(float r, float g, float b);
+        /* changes the grid size, the data is kept as a flat
+         * array of points rather than by grid position */
+        void resize(unsigned pNumXPoints, unsigned pNumYPoints);
+        /* draws the points as a density map through the window colormap */
+        void setDensityMap(bool pEnable, bool pLogScale);
+        void setColorMapParams(GLuint tex, GLuint size);
+        unsigned numXPoints() const;
+        unsigned numYPoints() const;
         GLuint vbo() const;
         size_t size() const;
 
@@ -114,11 +133,23 @@ class _Surface {
             plt->setAxesLimits(pXmax, pXmin, pYmax, pYmin, pZmax, pZmin);
         }
 
+        inline void setAutoAxes(bool pAuto) {
+            plt->setAutoAxes(pAuto);
+        }
+
         inline void setAxesTitles(const char* pXTitle, const char* pYTitle, const char* pZTitle)
         {
             plt->setAxesTitles(pXTitle, pYTitle, pZTitle);
         }
 
+        inline void resize(unsigned pNumXPoints, unsigned pNumYPoints) {
+            plt->resize(pNumXPoints, pNumYPoints);
+        }
+
+        inline void setDensityMap(bool pEnable, bool pLogScale) {
+            plt->setDensityMap(pEnable, pLogScale);
+        }
+
         inline float xmax() const {
             return plt->xmax();
         }
@@ -150,6 +181,38 @@ class _Surface {
         inline size_t size() const {
             return plt->size();
         }
+
+        inline void markDirty() {
+            plt->markDirty();
+        }
+
+        inline void vboWritten() {
+            plt->dataBufferWritten();
+        }
+
+        inline void setStreaming(bool pStreaming) {
+            plt->setStreaming(pStreaming);
+        }
+
+        inline bool streaming() const {
+            return plt->streaming();
+        }
+
+        inline void upload(const void* pData) {
+            plt->upload(pData);
+        }
+
+        inline void update(const void* pData, unsigned pOffset, unsigned pSize) {
+            plt->update(pData, pOffset, pSize);
+        }
+
+        inline void* map(fg::MapAccess pAccess) {
+            return plt->map(pAccess);
+        }
+
+        inline void unmap() {
+            plt->unmap();
+        }
 };
 
 }
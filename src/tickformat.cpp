@@ -0,0 +1,114 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <tickformat.hpp>
+#include <algorithm>
+#include <cmath>
+
+double niceTickStep(double pMin, double pMax, int pMaxTicks)
+{
+    double range = pMax - pMin;
+    if (!std::isfinite(pMin) || !std::isfinite(pMax) || !std::isfinite(range) ||
+        !(range > 0.0) || pMaxTicks < 2)
+        return 0.0;
+
+    /* a spacing of range/(pMaxTicks-1) always fits, smaller ones
+     * may fit too depending on where the multiples of it fall. The
+     * first decades tried are below that spacing, so a few suffice */
+    static const int    MAX_DECADES = 4;
+    static const double MULTIPLES[] = {1.0, 2.0, 5.0};
+    double base = std::pow(10.0, std::floor(std::log10(range / (pMaxTicks + 1))));
+    if (!(base > 0.0))
+        return 0.0;
+
+    for (int e=0; e<MAX_DECADES; ++e, base *= 10.0) {
+        for (int m=0; m<3; ++m) {
+            double step  = MULTIPLES[m] * base;
+            double count = std::floor(pMax/step + 1.0e-6) - std::ceil(pMin/step - 1.0e-6) + 1;
+            if (count <= pMaxTicks)
+                return step;
+        }
+    }
+    return 0.0;
+}
+
+/* digits after the decimal point that represent multiples of pStep */
+static int decimalsFor(double pStep)
+{
+    if (!(pStep > 0.0))
+        return 0;
+    int decimals = -int(std::floor(std::log10(pStep) + 1.0e-9));
+    return std::min(std::max(decimals, 0), 9);
+}
+
+TickFormat tickFormat(double pMagnitude, double pStep)
+{
+    TickFormat format = {decimalsFor(pStep), 0};
+
+    if (!std::isfinite(pMagnitude) || !std::isfinite(pStep))
+        return format;
+
+    if (pMagnitude >= 1.0e5 || (pMagnitude > 0.0 && pMagnitude < 1.0e-3)) {
+        format.mExponent = 3*int(std::floor(std::log10(pMagnitude)/3.0));
+        format.mDecimals = decimalsFor(pStep * std::pow(10.0, -format.mExponent));
+    }
+    return format;
+}
+
+int formatTick(char pBuffer[TICK_LABEL_SIZE], double pValue, const TickFormat& pFormat)
+{
+    static const double POW10[] = {1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4,
+                                   1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9};
+
+    double mantissa = (pFormat.mExponent==0 ? pValue : pValue * std::pow(10.0, -pFormat.mExponent));
+    double scaled   = std::fabs(mantissa) * POW10[pFormat.mDecimals] + 0.5;
+
+    /* values that don't fit the integer conversion below can only
+     * come from formats that don't belong to this value */
+    if (!(scaled < 9.0e18)) {
+        pBuffer[0] = '\0';
+        return 0;
+    }
+    unsigned long long digits = (unsigned long long)scaled;
+
+    /* digits are produced in reverse order */
+    char reversed[TICK_LABEL_SIZE];
+    int count = 0;
+    do {
+        reversed[count++] = char('0' + digits % 10);
+        digits /= 10;
+    } while (digits > 0 || count <= pFormat.mDecimals);
+
+    int len = 0;
+    bool isZero = std::all_of(reversed, reversed+count, [](char c) { return c=='0'; });
+    if (mantissa < 0 && !isZero)
+        pBuffer[len++] = '-';
+    for (int i=count-1; i>=0; --i) {
+        pBuffer[len++] = reversed[i];
+        if (i==pFormat.mDecimals && i>0)
+            pBuffer[len++] = '.';
+    }
+
+    if (pFormat.mExponent != 0) {
+        int exponent = pFormat.mExponent;
+        pBuffer[len++] = 'e';
+        if (exponent < 0) {
+            pBuffer[len++] = '-';
+            exponent = -exponent;
+        }
+        if (exponent >= 100)
+            pBuffer[len++] = char('0' + exponent/100);
+        if (exponent >= 10)
+            pBuffer[len++] = char('0' + (exponent/10)%10);
+        pBuffer[len++] = char('0' + exponent%10);
+    }
+
+    pBuffer[len] = '\0';
+    return len;
+}
@@ -0,0 +1,40 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+/* tick placement and label formatting of chart axes, this
+ * header has no OpenGL dependencies so that benchmarks can
+ * build tickformat.cpp on its own */
+
+/* size of the buffer formatTick writes to, enough
+ * for any label that tickFormat can ask for */
+static const int TICK_LABEL_SIZE = 32;
+
+/* returns the smallest tick spacing of the form {1, 2, 5}x10^k
+ * that places at most pMaxTicks ticks within [pMin, pMax], or
+ * zero if the range is empty or not finite */
+double niceTickStep(double pMin, double pMax, int pMaxTicks);
+
+/* number format shared by all labels of an axis. Axes whose values
+ * are very large or very small use engineering notation, that is a
+ * mantissa scaled by a power of ten that is a multiple of three */
+struct TickFormat {
+    int mDecimals;
+    int mExponent;
+};
+
+/* picks the format that tells apart values pStep apart
+ * when the largest absolute value on the axis is pMagnitude */
+TickFormat tickFormat(double pMagnitude, double pStep);
+
+/* writes pValue to pBuffer in the given format and returns
+ * the length of the label. Neither allocates memory nor
+ * depends on the C or C++ locale */
+int formatTick(char pBuffer[TICK_LABEL_SIZE], double pValue, const TickFormat& pFormat);
@@ -0,0 +1,521 @@
+/*******************************************************
+ * Copyright (c) 2015-2019, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <fg/tiledimage.h>
+#include <tiledimage.hpp>
+#include <image.hpp>
+#include <common.hpp>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+static const char* vertex_shader_code =
+"#version 330\n"
+"layout(location = 0) in vec3 pos;\n"
+"layout(location = 1) in vec2 tex;\n"
+"uniform mat4 matrix;\n"
+"uniform vec2 texscale;\n"
+"out vec2 texcoord;\n"
+"void main() {\n"
+"    texcoord = tex * texscale;\n"
+"    gl_Position = matrix * vec4(pos,1.0);\n"
+"}\n";
+
+static const char* fragment_shader_code =
+"#version 330\n"
+"uniform float cmaplen;\n"
+"uniform sampler1D colormap;\n"
+"uniform sampler2D tex;\n"
+"uniform bool isGrayScale;\n"
+"in vec2 texcoord;\n"
+"out vec4 fragColor;\n"
+"void main()\n"
+"{\n"
+"    vec4 tcolor = texture(tex, texcoord);\n"
+"    vec4 clrs = vec4(1, 0, 0, 1);\n"
+"    if(isGrayScale)\n"
+"        clrs = vec4(tcolor.r, tcolor.r, tcolor.r, 1);\n"
+"    else\n"
+"        clrs = tcolor;\n"
+"    vec4 cpos  = (0.5 + (cmaplen-1) * clrs) / cmaplen;\n"
+"    float r_ch = texture(colormap, cpos.x).r;\n"
+"    float g_ch = texture(colormap, cpos.y).g;\n"
+"    float b_ch = texture(colormap, cpos.z).b;\n"
+"    fragColor = vec4(r_ch, g_ch , b_ch, 1);\n"
+"}\n";
+
+static const char* downsample_vertex_shader_code =
+"#version 330\n"
+"layout(location = 0) in vec3 pos;\n"
+"void main() {\n"
+"    gl_Position = vec4(pos,1.0);\n"
+"}\n";
+
+/* averages 2x2 texels of the child tile, texels past the
+ * valid extent of the child repeat its last row or column */
+static const char* downsample_fragment_shader_code =
+"#version 330\n"
+"uniform sampler2D tex;\n"
+"uniform ivec2 origin;\n"
+"uniform ivec2 extent;\n"
+"out vec4 fragColor;\n"
+"void main()\n"
+"{\n"
+"    ivec2 p    = 2 * (ivec2(gl_FragCoord.xy) - origin);\n"
+"    ivec2 last = extent - 1;\n"
+"    vec4 sum = texelFetch(tex, min(p, last), 0) +\n"
+"               texelFetch(tex, min(p + ivec2(1, 0), last), 0) +\n"
+"               texelFetch(tex, min(p + ivec2(0, 1), last), 0) +\n"
+"               texelFetch(tex, min(p + ivec2(1, 1), last), 0);\n"
+"    fragColor = 0.25 * sum;\n"
+"}\n";
+
+static size_t pixelSize(GLenum pType, fg::ChannelFormat pFormat)
+{
+    size_t typeSize = 0;
+    switch(pType) {
+        case GL_INT:            typeSize = sizeof(int  );           break;
+        case GL_UNSIGNED_INT:   typeSize = sizeof(unsigned int);    break;
+        case GL_SHORT:          typeSize = sizeof(short  );         break;
+        case GL_UNSIGNED_SHORT: typeSize = sizeof(unsigned short);  break;
+        case GL_BYTE:           typeSize = sizeof(char );           break;
+        case GL_UNSIGNED_BYTE:  typeSize = sizeof(unsigned char);   break;
+        default: typeSize = sizeof(float); break;
+    }
+    size_t formatSize = 0;
+    switch(pFormat) {
+        case fg::FG_GRAYSCALE:     formatSize = 1;   break;
+        case fg::FG_RG:            formatSize = 2;   break;
+        case fg::FG_RGB:           formatSize = 3;   break;
+        case fg::FG_BGR:           formatSize = 3;   break;
+        case fg::FG_RGBA:          formatSize = 4;   break;
+        case fg::FG_BGRA:          formatSize = 4;   break;
+        default: formatSize = 1; break;
+    }
+    return formatSize * typeSize;
+}
+
+/* sized internal format of the tiles. Coarser levels are rendered
+ * into tiles, so formats that aren't color-renderable are replaced,
+ * RGB by RGBA and the signed normalized ones by float formats */
+static GLenum tileFormat(fg::ChannelFormat pFormat, fg::dtype pDataType)
+{
+    if (pFormat==fg::FG_RGB || pFormat==fg::FG_BGR)
+        pFormat = fg::FG_RGBA;
+    if (pDataType==fg::s8 || pDataType==fg::s16)
+        pDataType = fg::f32;
+    return gl_ictype(pFormat, pDataType);
+}
+
+namespace internal
+{
+
+const unsigned tiledimage_impl::TILE_SIZE;
+
+tiledimage_impl::tiledimage_impl(unsigned pWidth, unsigned pHeight,
+                                 fg::ChannelFormat pFormat, fg::dtype pDataType)
+    : mWidth(pWidth), mHeight(pHeight),
+      mFormat(pFormat), mGLformat(gl_ctype(mFormat)), mGLiformat(tileFormat(mFormat, pDataType)),
+      mDataType(pDataType), mGLType(gl_dtype(mDataType)),
+      mPixelSize(pixelSize(mGLType, mFormat)),
+      mColorMap(0), mColorMapLength(0), mKeepARatio(true)
+{
+    if (pWidth==0 || pHeight==0)
+        throw fg::Error("tiledimage_impl::tiledimage_impl", __LINE__,
+                        "Image dimensions have to be positive", fg::FG_ERR_SIZE);
+
+    CheckGL("Begin tiledimage_impl::tiledimage_impl");
+
+    unsigned w = mWidth;
+    unsigned h = mHeight;
+    while (true) {
+        Level level;
+        level.mWidth  = w;
+        level.mHeight = h;
+        level.mCols   = (w + TILE_SIZE - 1) / TILE_SIZE;
+        level.mRows   = (h + TILE_SIZE - 1) / TILE_SIZE;
+        level.mTiles.resize(level.mCols * level.mRows, Tile{0, false});
+        mLevels.push_back(level);
+        if (w <= TILE_SIZE && h <= TILE_SIZE)
+            break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+
+    glGenFramebuffers(1, &mFramebuffer);
+
+    mProgram           = acquireProgram(vertex_shader_code, fragment_shader_code);
+    mDownsampleProgram = acquireProgram(downsample_vertex_shader_code,
+                                        downsample_fragment_shader_code);
+
+    CheckGL("End tiledimage_impl::tiledimage_impl");
+}
+
+tiledimage_impl::~tiledimage_impl()
+{
+    CheckGL("Begin tiledimage_impl::~tiledimage_impl");
+    for (size_t l=0; l<mLevels.size(); ++l) {
+        for (size_t t=0; t<mLevels[l].mTiles.size(); ++t) {
+            if (mLevels[l].mTiles[t].mTex)
+                glDeleteTextures(1, &mLevels[l].mTiles[t].mTex);
+        }
+    }
+    glDeleteFramebuffers(1, &mFramebuffer);
+    releaseProgram(mDownsampleProgram);
+    releaseProgram(mProgram);
+    CheckGL("End tiledimage_impl::~tiledimage_impl");
+}
+
+tiledimage_impl::Tile& tiledimage_impl::tile(unsigned pLevel, unsigned pCol, unsigned pRow)
+{
+    Level& level = mLevels[pLevel];
+    Tile& t = level.mTiles[pRow * level.mCols + pCol];
+    if (t.mTex)
+        return t;
+
+    glGenTextures(1, &t.mTex);
+    glBindTexture(GL_TEXTURE_2D, t.mTex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, mGLiformat, TILE_SIZE, TILE_SIZE, 0, mGLformat, mGLType, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    /* texture contents are undefined until written, parts of
+     * the image that were never written are displayed as zero */
+    GLint fbo = 0;
+    GLfloat color[4];
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, color);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffer);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t.mTex, 0);
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glClearColor(color[0], color[1], color[2], color[3]);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    return t;
+}
+
+unsigned tiledimage_impl::tileWidth(unsigned pLevel, unsigned pCol) const
+{
+    return std::min(TILE_SIZE, mLevels[pLevel].mWidth - pCol * TILE_SIZE);
+}
+
+unsigned tiledimage_impl::tileHeight(unsigned pLevel, unsigned pRow) const
+{
+    return std::min(TILE_SIZE, mLevels[pLevel].mHeight - pRow * TILE_SIZE);
+}
+
+void tiledimage_impl::setColorMapParams(GLuint tex, GLuint size)
+{
+    mColorMap = tex;
+    mColorMapLength = size;
+}
+
+void tiledimage_impl::keepAspectRatio(const bool keep)
+{
+    if (mKeepARatio != keep) {
+        mKeepARatio = keep;
+        markDirty();
+    }
+}
+
+unsigned tiledimage_impl::width() const { return mWidth; }
+
+unsigned tiledimage_impl::height() const { return mHeight; }
+
+fg::ChannelFormat tiledimage_impl::pixelFormat() const { return mFormat; }
+
+fg::dtype tiledimage_impl::channelType() const { return mDataType; }
+
+void tiledimage_impl::update(const void* pData, unsigned pX, unsigned pY,
+                             unsigned pWidth, unsigned pHeight)
+{
+    if (pX > mWidth || pWidth > mWidth - pX || pY > mHeight || pHeight > mHeight - pY)
+        throw fg::Error("tiledimage_impl::update", __LINE__,
+                        "Update region exceeds the image", fg::FG_ERR_SIZE);
+    if (pWidth==0 || pHeight==0)
+        return;
+
+    CheckGL("Begin tiledimage_impl::update");
+    const unsigned char* src = (const unsigned char*)pData;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pWidth);
+    for (unsigned r=pY/TILE_SIZE; r<=(pY+pHeight-1)/TILE_SIZE; ++r) {
+        unsigned y0 = std::max(pY, r * TILE_SIZE);
+        unsigned y1 = std::min(pY + pHeight, (r + 1) * TILE_SIZE);
+        for (unsigned c=pX/TILE_SIZE; c<=(pX+pWidth-1)/TILE_SIZE; ++c) {
+            unsigned x0 = std::max(pX, c * TILE_SIZE);
+            unsigned x1 = std::min(pX + pWidth, (c + 1) * TILE_SIZE);
+            size_t offset = (size_t(y0 - pY) * pWidth + (x0 - pX)) * mPixelSize;
+
+            glBindTexture(GL_TEXTURE_2D, tile(0, c, r).mTex);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x0 - c * TILE_SIZE, y0 - r * TILE_SIZE,
+                            x1 - x0, y1 - y0, mGLformat, mGLType, src + offset);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    /* the region covers fewer tiles on every level, higher
+     * levels are rebuilt only when they are drawn */
+    for (unsigned l=1; l<mLevels.size(); ++l) {
+        Level& level = mLevels[l];
+        unsigned c0 = (pX >> l) / TILE_SIZE;
+        unsigned c1 = ((pX + pWidth - 1) >> l) / TILE_SIZE;
+        unsigned r0 = (pY >> l) / TILE_SIZE;
+        unsigned r1 = ((pY + pHeight - 1) >> l) / TILE_SIZE;
+        for (unsigned r=r0; r<=r1; ++r)
+            for (unsigned c=c0; c<=c1; ++c)
+                level.mTiles[r * level.mCols + c].mDirty = true;
+    }
+    markDirty();
+    CheckGL("End tiledimage_impl::update");
+}
+
+void tiledimage_impl::downsample(unsigned pLevel, unsigned pCol, unsigned pRow)
+{
+    static const unsigned HALF_TILE = TILE_SIZE / 2;
+
+    Tile& t = tile(pLevel, pCol, pRow);
+    const Level& child = mLevels[pLevel - 1];
+
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t.mTex, 0);
+    glViewport(0, 0, TILE_SIZE, TILE_SIZE);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    int org_loc = glGetUniformLocation(mDownsampleProgram, "origin");
+    int ext_loc = glGetUniformLocation(mDownsampleProgram, "extent");
+
+    /* each of the four child tiles fills a quadrant, the
+     * quadrants of missing children stay zero */
+    for (unsigned q=0; q<4; ++q) {
+        unsigned c = 2 * pCol + (q & 1);
+        unsigned r = 2 * pRow + (q >> 1);
+        if (c >= child.mCols || r >= child.mRows)
+            continue;
+        GLuint tex = child.mTiles[r * child.mCols + c].mTex;
+        if (!tex)
+            continue;
+
+        int x = (q & 1) * HALF_TILE;
+        int y = (q >> 1) * HALF_TILE;
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glViewport(x, y, HALF_TILE, HALF_TILE);
+        glUniform2i(org_loc, x, y);
+        glUniform2i(ext_loc, tileWidth(pLevel - 1, c), tileHeight(pLevel - 1, r));
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    }
+    t.mDirty = false;
+}
+
+void tiledimage_impl::buildLevels(int pWindowId, unsigned pLevel)
+{
+    bool dirty = false;
+    for (unsigned l=1; l<=pLevel && !dirty; ++l) {
+        for (size_t t=0; t<mLevels[l].mTiles.size() && !dirty; ++t)
+            dirty = mLevels[l].mTiles[t].mDirty;
+    }
+    if (!dirty)
+        return;
+
+    CheckGL("Begin tiledimage_impl::buildLevels");
+    /* the window may render to a framebuffer object of its own */
+    GLint fbo = 0;
+    GLint viewport[4];
+    GLfloat color[4];
+    GLboolean scissor = glIsEnabled(GL_SCISSOR_TEST);
+    GLboolean blend   = glIsEnabled(GL_BLEND);
+    GLboolean depth   = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, color);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFramebuffer);
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glClearColor(0, 0, 0, 0);
+
+    glUseProgram(mDownsampleProgram);
+    glUniform1i(glGetUniformLocation(mDownsampleProgram, "tex"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(imageQuadVAO(pWindowId));
+
+    /* a level is complete before the next one reads it */
+    for (unsigned l=1; l<=pLevel; ++l) {
+        Level& level = mLevels[l];
+        for (unsigned r=0; r<level.mRows; ++r) {
+            for (unsigned c=0; c<level.mCols; ++c) {
+                if (level.mTiles[r * level.mCols + c].mDirty)
+                    downsample(l, c, r);
+            }
+        }
+    }
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+
+    glClearColor(color[0], color[1], color[2], color[3]);
+    if (depth)
+        glEnable(GL_DEPTH_TEST);
+    if (blend)
+        glEnable(GL_BLEND);
+    if (scissor)
+        glEnable(GL_SCISSOR_TEST);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+    CheckGL("End tiledimage_impl::buildLevels");
+}
+
+void tiledimage_impl::render(int pWindowId, int pX, int pY, int pViewPortWidth, int pViewPortHeight)
+{
+    float xscale = 1.f;
+    float yscale = 1.f;
+    if (mKeepARatio) {
+        if (mWidth > mHeight) {
+            float trgtH = pViewPortWidth * float(mHeight)/float(mWidth);
+            float trgtW = trgtH * float(mWidth)/float(mHeight);
+            xscale = trgtW/pViewPortWidth;
+            yscale = trgtH/pViewPortHeight;
+        } else {
+            float trgtW = pViewPortHeight * float(mWidth)/float(mHeight);
+            float trgtH = trgtW * float(mHeight)/float(mWidth);
+            xscale = trgtW/pViewPortWidth;
+            yscale = trgtH/pViewPortHeight;
+        }
+    }
+
+    /* the coarsest level that is displayed at least at half its
+     * size, so the linear filter doesn't skip any texels */
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    float scale = std::max(xscale * viewport[2] / mWidth, yscale * viewport[3] / mHeight);
+    unsigned lvl = 0;
+    while (lvl+1 < mLevels.size() && scale * float(1u << lvl) < 0.5f)
+        ++lvl;
+
+    buildLevels(pWindowId, lvl);
+
+    CheckGL("Begin tiledimage_impl::render");
+    glUseProgram(mProgram);
+    // get uniform locations
+    int mat_loc = glGetUniformLocation(mProgram, "matrix");
+    int scl_loc = glGetUniformLocation(mProgram, "texscale");
+    int tex_loc = glGetUniformLocation(mProgram, "tex");
+    int chn_loc = glGetUniformLocation(mProgram, "isGrayScale");
+    int cml_loc = glGetUniformLocation(mProgram, "cmaplen");
+    int cmp_loc = glGetUniformLocation(mProgram, "colormap");
+
+    glUniform1i(chn_loc, mFormat==fg::FG_GRAYSCALE);
+    glUniform1i(tex_loc, 0);
+
+    glUniform1f(cml_loc, (GLfloat)mColorMapLength);
+    glUniform1i(cmp_loc, 1);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_1D, mColorMap);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(imageQuadVAO(pWindowId));
+
+    /* every tile maps its valid texels to its share
+     * of the rectangle the whole image is drawn to */
+    const Level& level = mLevels[lvl];
+    for (unsigned r=0; r<level.mRows; ++r) {
+        for (unsigned c=0; c<level.mCols; ++c) {
+            unsigned tw = tileWidth(lvl, c);
+            unsigned th = tileHeight(lvl, r);
+            float x0 = float(c * TILE_SIZE) / level.mWidth;
+            float x1 = float(c * TILE_SIZE + tw) / level.mWidth;
+            float y0 = float(r * TILE_SIZE) / level.mHeight;
+            float y1 = float(r * TILE_SIZE + th) / level.mHeight;
+
+            glm::vec3 center(xscale * (x0 + x1 - 1.0f), yscale * (1.0f - y0 - y1), 0);
+            glm::mat4 trans = glm::translate(glm::mat4(1.0f), center);
+            trans = glm::scale(trans, glm::vec3(xscale * (x1 - x0), yscale * (y1 - y0), 1));
+
+            glUniformMatrix4fv(mat_loc, 1, GL_FALSE, glm::value_ptr(trans));
+            glUniform2f(scl_loc, float(tw) / TILE_SIZE, float(th) / TILE_SIZE);
+            glBindTexture(GL_TEXTURE_2D, tile(lvl, c, r).mTex);
+
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        }
+    }
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_1D, 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    // ubind the shader program
+    glUseProgram(0);
+    CheckGL("End tiledimage_impl::render");
+}
+
+}
+
+namespace fg
+{
+
+TiledImage::TiledImage(unsigned pWidth, unsigned pHeight, fg::ChannelFormat pFormat, fg::dtype pDataType) {
+    value = new internal::_TiledImage(pWidth, pHeight, pFormat, pDataType);
+}
+
+TiledImage::TiledImage(const TiledImage& other) {
+    value = new internal::_TiledImage(*other.get());
+}
+
+TiledImage::~TiledImage() {
+    delete value;
+}
+
+unsigned TiledImage::width() const {
+    return value->width();
+}
+
+unsigned TiledImage::height() const {
+    return value->height();
+}
+
+ChannelFormat TiledImage::pixelFormat() const {
+    return value->pixelFormat();
+}
+
+fg::dtype TiledImage::channelType() const {
+    return value->channelType();
+}
+
+void TiledImage::upload(const void* pData) {
+    value->upload(pData);
+}
+
+void TiledImage::update(const void* pData, unsigned pX, unsigned pY,
+                        unsigned pWidth, unsigned pHeight) {
+    value->update(pData, pX, pY, pWidth, pHeight);
+}
+
+internal::_TiledImage* TiledImage::get() const {
+    return value;
+}
+
+}
@@ -0,0 +1,124 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+#include <memory>
+#include <vector>
+
+namespace internal
+{
+
+/* Image of any size stored as a pyramid of fixed size tiles
+ *
+ * Level 0 holds the image, every further level halves the previous
+ * one until a level fits in a single tile. Tiles are allocated when
+ * data is written to them. Writes mark the tiles covering the same
+ * area on the higher levels, which are rebuilt from the level below
+ * on the GPU when they are about to be drawn. Draws use the finest
+ * level that isn't minified by more than two, so the number of tiles
+ * drawn depends on the viewport size but not on the image size. */
+class tiledimage_impl : public AbstractRenderable {
+    public:
+        static const unsigned TILE_SIZE = 512;
+
+    private:
+        struct Tile {
+            GLuint mTex;
+            bool   mDirty;
+        };
+
+        struct Level {
+            unsigned          mWidth;
+            unsigned          mHeight;
+            unsigned          mCols;
+            unsigned          mRows;
+            std::vector<Tile> mTiles;
+        };
+
+        unsigned  mWidth;
+        unsigned  mHeight;
+        fg::ChannelFormat mFormat;
+        GLenum    mGLformat;
+        GLenum    mGLiformat;
+        fg::dtype mDataType;
+        GLenum    mGLType;
+        size_t    mPixelSize;
+
+        std::vector<Level> mLevels;
+
+        ProgramRef mProgram;
+        ProgramRef mDownsampleProgram;
+        GLuint    mFramebuffer;
+
+        GLuint    mColorMap;
+        GLuint    mColorMapLength;
+        bool      mKeepARatio;
+
+        /* returns the tile, allocating a cleared texture for it */
+        Tile& tile(unsigned pLevel, unsigned pCol, unsigned pRow);
+        /* number of valid texels of a tile along x and y */
+        unsigned tileWidth(unsigned pLevel, unsigned pCol) const;
+        unsigned tileHeight(unsigned pLevel, unsigned pRow) const;
+        /* rebuilds dirty tiles of levels [1, pLevel] from the level below */
+        void buildLevels(int pWindowId, unsigned pLevel);
+        void downsample(unsigned pLevel, unsigned pCol, unsigned pRow);
+
+    public:
+        tiledimage_impl(unsigned pWidth, unsigned pHeight, fg::ChannelFormat pFormat, fg::dtype pDataType);
+        ~tiledimage_impl();
+
+        void setColorMapParams(GLuint tex, GLuint size);
+        void keepAspectRatio(const bool keep=true);
+
+        unsigned width() const;
+        unsigned height() const;
+        fg::ChannelFormat pixelFormat() const;
+        fg::dtype channelType() const;
+
+        /* copies a pWidth x pHeight block of tightly packed pixels
+         * from pData to the region of the image at (pX, pY) */
+        void update(const void* pData, unsigned pX, unsigned pY,
+                    unsigned pWidth, unsigned pHeight);
+
+        void render(int pWindowId, int pX, int pY, int pViewPortWidth, int pViewPortHeight);
+};
+
+class _TiledImage {
+    private:
+        std::shared_ptr<tiledimage_impl> img;
+
+    public:
+        _TiledImage(unsigned pWidth, unsigned pHeight, fg::ChannelFormat pFormat, fg::dtype pDataType)
+            : img(std::make_shared<tiledimage_impl>(pWidth, pHeight, pFormat, pDataType)) {}
+
+        inline const std::shared_ptr<tiledimage_impl>& impl() const { return img; }
+
+        inline void keepAspectRatio(const bool keep) { img->keepAspectRatio(keep); }
+
+        inline unsigned width() const { return img->width(); }
+
+        inline unsigned height() const { return img->height(); }
+
+        inline fg::ChannelFormat pixelFormat() const { return img->pixelFormat(); }
+
+        inline fg::dtype channelType() const { return img->channelType(); }
+
+        inline void upload(const void* pData) {
+            img->update(pData, 0, 0, img->width(), img->height());
+        }
+
+        inline void update(const void* pData, unsigned pX, unsigned pY,
+                           unsigned pWidth, unsigned pHeight) {
+            img->update(pData, pX, pY, pWidth, pHeight);
+        }
+};
+
+}
@@ -0,0 +1,151 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <uploader.hpp>
+#include <window.hpp>
+
+namespace internal
+{
+
+UploadQueue::UploadQueue(size_t pCapacity)
+    : mMask(0), mEnqueuePos(0), mDequeuePos(0)
+{
+    size_t capacity = 2;
+    while (capacity < pCapacity)
+        capacity *= 2;
+
+    mCells.reset(new Cell[capacity]);
+    mMask = capacity - 1;
+    for (size_t i=0; i<capacity; ++i)
+        mCells[i].mSequence.store(i, std::memory_order_relaxed);
+}
+
+bool UploadQueue::push(const UploadJob& pJob)
+{
+    Cell* cell = NULL;
+    size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &mCells[pos & mMask];
+        size_t seq = cell->mSequence.load(std::memory_order_acquire);
+        long long diff = (long long)seq - (long long)pos;
+        if (diff == 0) {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* the consumer hasn't freed the cell yet */
+            return false;
+        } else {
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->mJob = pJob;
+    cell->mSequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool UploadQueue::pop(UploadJob& pJob)
+{
+    Cell* cell = NULL;
+    size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &mCells[pos & mMask];
+        size_t seq = cell->mSequence.load(std::memory_order_acquire);
+        long long diff = (long long)seq - (long long)(pos + 1);
+        if (diff == 0) {
+            if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* no producer has filled the cell yet */
+            return false;
+        } else {
+            pos = mDequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    pJob = cell->mJob;
+    cell->mJob = UploadJob();
+    cell->mSequence.store(pos + mMask + 1, std::memory_order_release);
+    return true;
+}
+
+uploader_impl::uploader_impl(const wtk::Widget* pShare, GLEWContext* pGLEWContext,
+                             unsigned pQueueLength)
+    : mWidget(NULL), mGLEWContext(pGLEWContext), mQueue(pQueueLength),
+      mPending(0), mStop(false), mSleeping(false)
+{
+    mWidget = new wtk::Widget(16, 16, "Forge upload context", pShare, true);
+    mWorker = std::thread(&uploader_impl::run, this);
+}
+
+uploader_impl::~uploader_impl()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mStop = true;
+        mWake.notify_all();
+    }
+    mWorker.join();
+
+    /* jobs left in the queue are dropped */
+    UploadJob job;
+    while (mQueue.pop(job));
+
+    delete mWidget;
+}
+
+bool uploader_impl::push(const std::shared_ptr<AsyncUpload>& pTarget,
+                         const void* pData, size_t pSize)
+{
+    UploadJob job;
+    job.mTarget = pTarget;
+    job.mData   = pData;
+    job.mSize   = pSize;
+
+    ++mPending;
+    if (!mQueue.push(job)) {
+        --mPending;
+        return false;
+    }
+    /* mPending was raised before mSleeping is read, so either the
+     * upload thread sees the job before it waits, or it is waiting
+     * or about to once the lock is taken and gets the notification */
+    if (mSleeping) {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWake.notify_one();
+    }
+    return true;
+}
+
+unsigned uploader_impl::pending() const
+{
+    return mPending;
+}
+
+void uploader_impl::run()
+{
+    MakeContextCurrent(mWidget, mGLEWContext);
+
+    UploadJob job;
+    while (!mStop) {
+        if (mQueue.pop(job)) {
+            job.mTarget->write(job.mData, job.mSize);
+            job = UploadJob();
+            --mPending;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mSleeping = true;
+        mWake.wait(lock, [this] { return mStop || mPending != 0; });
+        mSleeping = false;
+    }
+
+    mWidget->releaseContext();
+}
+
+}
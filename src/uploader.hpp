@@ -0,0 +1,107 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+#include <streambuffer.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace wtk
+{
+class Widget;
+}
+
+namespace internal
+{
+
+/* data of a renderable to be uploaded, pData has to
+ * stay valid until the upload is no longer pending */
+struct UploadJob {
+    std::shared_ptr<AsyncUpload> mTarget;
+    const void*                  mData;
+    size_t                       mSize;
+};
+
+/* Bounded multi-producer multi-consumer queue that needs no locks
+ *
+ * Every cell carries a sequence number telling whether it is free
+ * for the producer or filled for the consumer at the current turn
+ * of the ring, so producers and consumers only contend on the
+ * atomic position they advance. */
+class UploadQueue {
+    private:
+        struct Cell {
+            std::atomic<size_t> mSequence;
+            UploadJob           mJob;
+        };
+
+        std::unique_ptr<Cell[]> mCells;
+        size_t                  mMask;
+        std::atomic<size_t>     mEnqueuePos;
+        std::atomic<size_t>     mDequeuePos;
+
+        UploadQueue(const UploadQueue& other);
+        UploadQueue& operator=(const UploadQueue& other);
+
+    public:
+        /* the capacity is pCapacity rounded up to a power of two */
+        UploadQueue(size_t pCapacity);
+
+        /* false if the queue is full */
+        bool push(const UploadJob& pJob);
+        /* false if the queue is empty */
+        bool pop(UploadJob& pJob);
+};
+
+/* Uploads data to renderables on a thread of its own
+ *
+ * The thread owns a hidden widget whose context shares objects with
+ * the window, so data written there is visible to the window once
+ * the render thread picks it up (see AsyncUpload). Producers only
+ * touch the lock free queue and never wait for the render thread or
+ * buffer swaps, they take a lock only to wake the idle upload thread. */
+class uploader_impl {
+    private:
+        wtk::Widget*  mWidget;
+        GLEWContext*  mGLEWContext;
+
+        UploadQueue           mQueue;
+        std::atomic<unsigned> mPending;
+        std::atomic<bool>     mStop;
+
+        /* the upload thread sleeps while no job is pending */
+        std::atomic<bool>       mSleeping;
+        std::mutex              mWakeMutex;
+        std::condition_variable mWake;
+        std::thread             mWorker;
+
+        void run();
+
+    public:
+        /* creates the upload context, to be called on the thread that
+         * created pShare. The current context may change */
+        uploader_impl(const wtk::Widget* pShare, GLEWContext* pGLEWContext,
+                      unsigned pQueueLength);
+        ~uploader_impl();
+
+        /* thread safe, false if the queue is full */
+        bool push(const std::shared_ptr<AsyncUpload>& pTarget,
+                  const void* pData, size_t pSize);
+
+        /* number of jobs queued or being uploaded */
+        unsigned pending() const;
+};
+
+}
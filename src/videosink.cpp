@@ -0,0 +1,312 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#include <videosink.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(OS_WIN)
+#include <io.h>
+#define FG_WRITE _write
+#else
+#include <unistd.h>
+#define FG_WRITE write
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FG_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/* number of frames that can be waiting for the worker */
+static const int NUM_FRAME_BUFFERS = 4;
+
+/* Full range BT.601 coefficients (the Y4M C420jpeg colorspace)
+ * scaled by 256, chroma is computed from 2x2 pixel averages */
+static const int KY[3]  = {  77, 150,  29 };
+static const int KCB[3] = { -43, -85, 128 };
+static const int KCR[3] = { 128, -107, -21 };
+
+static inline unsigned char clampU8(int v)
+{
+    return (unsigned char)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+static void lumaRowScalar(const unsigned char* pSrc, unsigned char* pDst, int pCount)
+{
+    for (int i=0; i<pCount; ++i, pSrc+=4)
+        pDst[i] = clampU8((KY[0]*pSrc[0] + KY[1]*pSrc[1] + KY[2]*pSrc[2] + 128) >> 8);
+}
+
+/* pRow0/pRow1 are two consecutive RGBA rows, pCount is number of chroma samples */
+static void chromaRowScalar(const unsigned char* pRow0, const unsigned char* pRow1,
+                            int pWidth, unsigned char* pCb, unsigned char* pCr,
+                            int pStart, int pCount)
+{
+    for (int i=pStart; i<pCount; ++i) {
+        int x0 = 2*i;
+        int x1 = (x0+1 < pWidth ? x0+1 : x0);
+        int s[3];
+        for (int c=0; c<3; ++c)
+            s[c] = pRow0[4*x0+c] + pRow0[4*x1+c] + pRow1[4*x0+c] + pRow1[4*x1+c];
+        /* sums are four times the average, hence the extra shift by 2 */
+        pCb[i] = clampU8(((KCB[0]*s[0] + KCB[1]*s[1] + KCB[2]*s[2] + 512) >> 10) + 128);
+        pCr[i] = clampU8(((KCR[0]*s[0] + KCR[1]*s[1] + KCR[2]*s[2] + 512) >> 10) + 128);
+    }
+}
+
+#if defined(FG_USE_SSE2)
+/* dot product of the RGB channels of four 16-bit RGBA pixels,
+ * two per register, with pCoef; returns four 32-bit sums */
+static inline __m128i dot4(__m128i pLo, __m128i pHi, __m128i pCoef)
+{
+    __m128i a = _mm_madd_epi16(pLo, pCoef);
+    __m128i b = _mm_madd_epi16(pHi, pCoef);
+    a = _mm_add_epi32(a, _mm_srli_epi64(a, 32));
+    b = _mm_add_epi32(b, _mm_srli_epi64(b, 32));
+    a = _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 2, 0));
+    b = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 3, 2, 0));
+    return _mm_unpacklo_epi64(a, b);
+}
+
+static int lumaRowSSE2(const unsigned char* pSrc, unsigned char* pDst, int pCount)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i coef  = _mm_setr_epi16(KY[0], KY[1], KY[2], 0, KY[0], KY[1], KY[2], 0);
+    const __m128i round = _mm_set1_epi32(128);
+
+    int i = 0;
+    for (; i+16<=pCount; i+=16) {
+        __m128i y[4];
+        for (int k=0; k<4; ++k) {
+            __m128i px = _mm_loadu_si128((const __m128i*)(pSrc + 4*(i + 4*k)));
+            __m128i v  = dot4(_mm_unpacklo_epi8(px, zero), _mm_unpackhi_epi8(px, zero), coef);
+            y[k] = _mm_srai_epi32(_mm_add_epi32(v, round), 8);
+        }
+        __m128i lo = _mm_packs_epi32(y[0], y[1]);
+        __m128i hi = _mm_packs_epi32(y[2], y[3]);
+        _mm_storeu_si128((__m128i*)(pDst + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+
+/* four chroma samples (8x2 pixels) per iteration */
+static int chromaRowSSE2(const unsigned char* pRow0, const unsigned char* pRow1,
+                         int pWidth, unsigned char* pCb, unsigned char* pCr)
+{
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i cbCoef = _mm_setr_epi16(KCB[0], KCB[1], KCB[2], 0, KCB[0], KCB[1], KCB[2], 0);
+    const __m128i crCoef = _mm_setr_epi16(KCR[0], KCR[1], KCR[2], 0, KCR[0], KCR[1], KCR[2], 0);
+    const __m128i round  = _mm_set1_epi32(512);
+    const __m128i bias   = _mm_set1_epi32(128);
+
+    int i = 0;
+    for (; 2*i+8<=pWidth; i+=4) {
+        __m128i sums[2];
+        for (int k=0; k<2; ++k) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(pRow0 + 4*(2*i + 4*k)));
+            __m128i b = _mm_loadu_si128((const __m128i*)(pRow1 + 4*(2*i + 4*k)));
+            /* vertical sums as 16-bit: [p0 p1] and [p2 p3] */
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            /* horizontal pair sums in the low 64 bits */
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            sums[k] = _mm_unpacklo_epi64(lo, hi);
+        }
+        __m128i cb = dot4(sums[0], sums[1], cbCoef);
+        __m128i cr = dot4(sums[0], sums[1], crCoef);
+        cb = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(cb, round), 10), bias);
+        cr = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(cr, round), 10), bias);
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(cb, cr), zero);
+        int cbv = _mm_cvtsi128_si32(packed);
+        int crv = _mm_cvtsi128_si32(_mm_srli_si128(packed, 4));
+        memcpy(pCb + i, &cbv, 4);
+        memcpy(pCr + i, &crv, 4);
+    }
+    return i;
+}
+#endif
+
+/* pFrame holds top to bottom RGBA rows, output is planar 4:2:0 */
+static void rgbaToYUV420(const unsigned char* pFrame, int pWidth, int pHeight,
+                         unsigned char* pY, unsigned char* pCb, unsigned char* pCr)
+{
+    int cw = (pWidth+1)/2;
+    int ch = (pHeight+1)/2;
+    size_t stride = 4*size_t(pWidth);
+
+    for (int r=0; r<pHeight; ++r) {
+        const unsigned char* src = pFrame + r*stride;
+        unsigned char* dst = pY + r*size_t(pWidth);
+        int done = 0;
+#if defined(FG_USE_SSE2)
+        done = lumaRowSSE2(src, dst, pWidth);
+#endif
+        lumaRowScalar(src + 4*done, dst + done, pWidth - done);
+    }
+
+    for (int r=0; r<ch; ++r) {
+        const unsigned char* row0 = pFrame + 2*r*stride;
+        const unsigned char* row1 = (2*r+1 < pHeight ? row0 + stride : row0);
+        unsigned char* cb = pCb + r*size_t(cw);
+        unsigned char* cr = pCr + r*size_t(cw);
+        int done = 0;
+#if defined(FG_USE_SSE2)
+        done = chromaRowSSE2(row0, row1, pWidth, cb, cr);
+#endif
+        chromaRowScalar(row0, row1, pWidth, cb, cr, done, cw);
+    }
+}
+
+namespace internal
+{
+
+videosink_impl::videosink_impl(int pFd, fg::VideoFormat pFormat, int pFrameRate)
+    : mFd(pFd), mFormat(pFormat), mFPS(pFrameRate > 0 ? pFrameRate : 30),
+      mWidth(0), mHeight(0), mHeaderDone(false), mFrames(NUM_FRAME_BUFFERS),
+      mStop(false), mFailed(false)
+{
+    if (pFd < 0)
+        throw fg::Error("videosink_impl constructor", __LINE__,
+                "Invalid file descriptor", fg::FG_ERR_INVALID_ARG);
+
+    for (size_t i=0; i<mFrames.size(); ++i)
+        mFree.push_back(&mFrames[i]);
+
+    mWorker = std::thread(&videosink_impl::run, this);
+}
+
+videosink_impl::~videosink_impl()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mCond.notify_all();
+    /* worker drains the queue before exiting */
+    mWorker.join();
+}
+
+void videosink_impl::push(const unsigned char* pData, int pWidth, int pHeight)
+{
+    if (mWidth == 0) {
+        mWidth  = pWidth;
+        mHeight = pHeight;
+    }
+
+    Frame* frame = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCond.wait(lock, [this]() { return !mFree.empty() || mFailed; });
+        if (mFailed)
+            throw fg::Error("videosink_impl::push", __LINE__,
+                    "Writing to video sink failed", fg::FG_ERR_RUNTIME);
+        frame = mFree.front();
+        mFree.pop_front();
+    }
+
+    size_t dstStride = 4*size_t(mWidth);
+    size_t srcStride = 4*size_t(pWidth);
+    size_t copySize  = std::min(dstStride, srcStride);
+    int rows = std::min(mHeight, pHeight);
+
+    frame->resize(dstStride*mHeight);
+    unsigned char* dst = frame->data();
+    /* flip to top to bottom while copying */
+    for (int r=0; r<rows; ++r) {
+        memcpy(dst + r*dstStride, pData + (pHeight-1-r)*srcStride, copySize);
+        if (copySize < dstStride)
+            memset(dst + r*dstStride + copySize, 0, dstStride - copySize);
+    }
+    if (rows < mHeight)
+        memset(dst + rows*dstStride, 0, (mHeight-rows)*dstStride);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueue.push_back(frame);
+    }
+    mCond.notify_all();
+}
+
+void videosink_impl::run()
+{
+    while (true) {
+        Frame* frame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCond.wait(lock, [this]() { return !mQueue.empty() || mStop; });
+            if (mQueue.empty())
+                return;
+            frame = mQueue.front();
+            mQueue.pop_front();
+        }
+
+        bool ok = mFailed ? false : encode(*frame);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFree.push_back(frame);
+            if (!ok)
+                mFailed = true;
+        }
+        mCond.notify_all();
+    }
+}
+
+bool videosink_impl::writeAll(const unsigned char* pData, size_t pSize)
+{
+    while (pSize > 0) {
+        int chunk = (int)std::min(pSize, size_t(1) << 30);
+        int written = (int)FG_WRITE(mFd, pData, chunk);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        pData += written;
+        pSize -= written;
+    }
+    return true;
+}
+
+bool videosink_impl::encode(const Frame& pFrame)
+{
+    switch(mFormat) {
+        case fg::FG_VIDEO_RGBA:
+            return writeAll(pFrame.data(), pFrame.size());
+        case fg::FG_VIDEO_Y4M:
+        default:
+            {
+                if (!mHeaderDone) {
+                    char header[128];
+                    int len = snprintf(header, sizeof(header),
+                                       "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+                                       mWidth, mHeight, mFPS);
+                    if (!writeAll((const unsigned char*)header, len))
+                        return false;
+                    mHeaderDone = true;
+                }
+                size_t lumaSize   = size_t(mWidth)*mHeight;
+                size_t chromaSize = size_t((mWidth+1)/2)*((mHeight+1)/2);
+                mYUV.resize(lumaSize + 2*chromaSize);
+                rgbaToYUV420(pFrame.data(), mWidth, mHeight, mYUV.data(),
+                             mYUV.data() + lumaSize, mYUV.data() + lumaSize + chromaSize);
+
+                static const char frameTag[] = "FRAME\n";
+                return writeAll((const unsigned char*)frameTag, sizeof(frameTag)-1) &&
+                       writeAll(mYUV.data(), mYUV.size());
+            }
+    }
+}
+
+}
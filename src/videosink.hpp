@@ -0,0 +1,65 @@
+/*******************************************************
+* Copyright (c) 2015-2019, ArrayFire
+* All rights reserved.
+*
+* This file is distributed under 3-clause BSD license.
+* The complete license agreement can be obtained at:
+* http://arrayfire.com/licenses/BSD-3-Clause
+********************************************************/
+
+#pragma once
+
+#include <common.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace internal
+{
+
+/* Writes captured frames to a file descriptor as a Y4M stream
+ * or as raw RGBA frames. Colorspace conversion and the write system
+ * calls happen on a worker thread; the rendering thread only copies
+ * the frame into one of a few preallocated buffers and blocks
+ * when all of them are still queued, so no frame is dropped. */
+class videosink_impl {
+    private:
+        typedef std::vector<unsigned char> Frame;
+
+        int             mFd;
+        fg::VideoFormat mFormat;
+        int             mFPS;
+        /* stream dimensions are fixed by the first frame,
+         * later frames are cropped or padded to fit */
+        int             mWidth;
+        int             mHeight;
+        bool            mHeaderDone;
+
+        std::vector<Frame> mFrames;
+        std::deque<Frame*> mFree;
+        std::deque<Frame*> mQueue;
+        std::vector<unsigned char> mYUV;
+
+        std::mutex              mMutex;
+        std::condition_variable mCond;
+        std::thread             mWorker;
+        bool                    mStop;
+        bool                    mFailed;
+
+        void run();
+        bool writeAll(const unsigned char* pData, size_t pSize);
+        bool encode(const Frame& pFrame);
+
+    public:
+        videosink_impl(int pFd, fg::VideoFormat pFormat, int pFrameRate);
+        ~videosink_impl();
+
+        /* pData is expected to be bottom to top RGBA rows
+         * as returned by glReadPixels */
+        void push(const unsigned char* pData, int pWidth, int pHeight);
+};
+
+}
@@ -13,12 +13,22 @@
 #include <common.hpp>
 #include <fg/window.h>
 #include <window.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <memory>
 #include <mutex>
 
 using namespace fg;
 
-static GLEWContext* current = nullptr;
+/* each thread has its own current context, the
+ * upload thread's differs from the render thread's */
+static thread_local GLEWContext* current = nullptr;
+static thread_local int currentWindow = -1;
+
+/* rate at which a window that has nothing new to
+ * show wakes up when no events arrive */
+static const int IDLE_FRAME_RATE = 60;
 
 GLEWContext* glewGetContext()
 {
@@ -38,20 +48,32 @@ int getNextUniqueId()
 namespace internal
 {
 
+int currentWindowId()
+{
+    return currentWindow;
+}
+
 void MakeContextCurrent(const window_impl* pWindow)
 {
-    CheckGL("Begin MakeContextCurrent");
     if (pWindow != NULL) {
-        pWindow->get()->makeContextCurrent();
-        current = pWindow->glewContext();
+        MakeContextCurrent(pWindow->get(), pWindow->glewContext());
+        currentWindow = pWindow->id();
     }
+}
+
+void MakeContextCurrent(const wtk::Widget* pWidget, GLEWContext* pGLEWContext)
+{
+    CheckGL("Begin MakeContextCurrent");
+    pWidget->makeContextCurrent();
+    current = pGLEWContext;
+    currentWindow = -1;
     CheckGL("End MakeContextCurrent");
 }
 
 window_impl::window_impl(int pWidth, int pHeight, const char* pTitle,
                         std::weak_ptr<window_impl> pWindow, const bool invisible)
     : mID(getNextUniqueId()), mWidth(pWidth), mHeight(pHeight),
-      mRows(0), mCols(0)
+      mRows(0), mCols(0), mCaptureHead(0), mCaptureCount(0)
 {
     if (auto observe = pWindow.lock()) {
         mWindow = new wtk::Widget(pWidth, pHeight, pTitle, observe->get(), invisible);
@@ -107,14 +129,23 @@ window_impl::window_impl(int pWidth, int pHeight, const char* pTitle,
     }
 
     /* set the colormap to default */
-    mColorMapUBO = mCMap->defaultMap();
-    mUBOSize = mCMap->defaultLen();
+    setColorMap(FG_DEFAULT_MAP);
     glEnable(GL_MULTISAMPLE);
     CheckGL("End Window::Window");
 }
 
 window_impl::~window_impl()
 {
+    /* the upload context shares objects with this window's */
+    mUploader.reset();
+    if (!mCapturePBOs.empty()) {
+        MakeContextCurrent(this);
+        if (mVideoSink) {
+            flushToSink(true);
+            mVideoSink.reset();
+        }
+        releaseCapture();
+    }
     delete mWindow;
 }
 
@@ -138,38 +169,19 @@ void window_impl::setSize(unsigned pW, unsigned pH)
     mWindow->setSize(pW, pH);
 }
 
-void window_impl::setColorMap(fg::ColorMap cmap)
-{
-    switch(cmap) {
-        case FG_DEFAULT_MAP:
-            mColorMapUBO = mCMap->defaultMap();
-            mUBOSize     = mCMap->defaultLen();
-            break;
-        case FG_SPECTRUM_MAP:
-            mColorMapUBO = mCMap->spectrum();
-            mUBOSize     = mCMap->spectrumLen();
-            break;
-        case FG_COLORS_MAP:
-            mColorMapUBO = mCMap->colors();
-            mUBOSize     = mCMap->colorsLen();
-            break;
-        case FG_RED_MAP:
-            mColorMapUBO = mCMap->red();
-            mUBOSize     = mCMap->redLen();
-            break;
-        case FG_MOOD_MAP:
-            mColorMapUBO = mCMap->mood();
-            mUBOSize     = mCMap->moodLen();
-            break;
-        case FG_HEAT_MAP:
-            mColorMapUBO = mCMap->heat();
-            mUBOSize     = mCMap->heatLen();
-            break;
-        case FG_BLUE_MAP:
-            mColorMapUBO = mCMap->blue();
-            mUBOSize     = mCMap->blueLen();
-            break;
-    }
+void window_impl::setColorMap(unsigned pMap)
+{
+    if (pMap >= mCMap->count())
+        throw fg::ArgumentError("Window::setColorMap", __LINE__, 1,
+                                "Colormap has to be a fg::ColorMap or one added to the window");
+    mColorMap       = mCMap->texture(pMap);
+    mColorMapLength = mCMap->length(pMap);
+}
+
+unsigned window_impl::addColorMap(const float* pRGBA, unsigned pLength)
+{
+    MakeContextCurrent(this);
+    return mCMap->add(pRGBA, pLength);
 }
 
 long long  window_impl::context() const
@@ -182,6 +194,11 @@ long long  window_impl::display() const
     return mDsp;
 }
 
+int window_impl::id() const
+{
+    return mID;
+}
+
 int window_impl::width() const
 {
     return mWidth;
@@ -215,6 +232,8 @@ void window_impl::hide()
 void window_impl::show()
 {
     mWindow->show();
+    /* contents may be lost while hidden */
+    mLastFrame = FrameState();
 }
 
 bool window_impl::close()
@@ -222,6 +241,69 @@ bool window_impl::close()
     return mWindow->close();
 }
 
+bool window_impl::frameChanged(int pWidth, int pHeight, int pRows, int pCols)
+{
+    FrameState& next = mNextFrame;
+    next.mWidth  = pWidth;
+    next.mHeight = pHeight;
+    next.mRows   = pRows;
+    next.mCols   = pCols;
+    next.mFont   = mFont.get();
+    next.mItems.resize(mDrawCalls.size());
+    for (size_t i=0; i<mDrawCalls.size(); ++i) {
+        const DrawCall& dc = mDrawCalls[i];
+        FrameState::Item& item = next.mItems[i];
+        item.mRenderable  = dc.mRenderable.get();
+        item.mRevision    = dc.mRenderable->revision();
+        item.mCol         = dc.mCol;
+        item.mRow         = dc.mRow;
+        item.mHasTitle    = dc.mHasTitle;
+        item.mTitle       = dc.mTitle;
+        item.mColorMap = dc.mColorMap;
+    }
+
+    /* contents lost by exposing or resizing the window have to be
+     * repainted, and every frame has to reach an attached video sink */
+    if (mWindow->takeDamage() || mVideoSink)
+        return true;
+
+    const FrameState& last = mLastFrame;
+    if (next.mWidth != last.mWidth || next.mHeight != last.mHeight ||
+        next.mRows != last.mRows || next.mCols != last.mCols ||
+        next.mFont != last.mFont || next.mItems.size() != last.mItems.size())
+        return true;
+
+    for (size_t i=0; i<next.mItems.size(); ++i) {
+        const FrameState::Item& a = next.mItems[i];
+        const FrameState::Item& b = last.mItems[i];
+        if (a.mRenderable != b.mRenderable || a.mRevision != b.mRevision ||
+            a.mCol != b.mCol || a.mRow != b.mRow || a.mHasTitle != b.mHasTitle ||
+            a.mColorMap != b.mColorMap || a.mTitle != b.mTitle)
+            return true;
+    }
+    return false;
+}
+
+void window_impl::present()
+{
+    queueCapture();
+    mWindow->swapBuffers();
+    mWindow->pollEvents();
+}
+
+void window_impl::idle()
+{
+    /* front buffer still shows the current contents, so there
+     * is nothing to render or swap. Wait for events until the
+     * next frame is due instead of returning to a busy loop */
+    mDrawCalls.clear();
+
+    auto now = std::chrono::steady_clock::now();
+    if (mNextFrameTime <= now)
+        mNextFrameTime = now + std::chrono::microseconds(1000000/IDLE_FRAME_RATE);
+    mWindow->waitEvents(std::chrono::duration<double>(mNextFrameTime - now).count());
+}
+
 void window_impl::draw(const std::shared_ptr<AbstractRenderable>& pRenderable)
 {
     CheckGL("Begin draw");
@@ -230,17 +312,30 @@ void window_impl::draw(const std::shared_ptr<AbstractRenderable>& pRenderable)
 
     int wind_width, wind_height;
     mWindow->getFrameBufferSize(&wind_width, &wind_height);
+
+    mDrawCalls.clear();
+    DrawCall dc = {pRenderable, -1, -1, false, std::string(), mColorMap, mColorMapLength};
+    mDrawCalls.push_back(dc);
+
+    if (!frameChanged(wind_width, wind_height, 0, 0)) {
+        idle();
+        return;
+    }
+
     glViewport(0, 0, wind_width, wind_height);
 
     // clear color and depth buffers
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glClearColor(GRAY[0], GRAY[1], GRAY[2], GRAY[3]);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    pRenderable->setColorMapUBOParams(mColorMapUBO, mUBOSize);
+    pRenderable->setColorMapParams(mColorMap, mColorMapLength);
     pRenderable->render(mID, 0, 0, wind_width, wind_height);
 
-    mWindow->swapBuffers();
-    mWindow->pollEvents();
+    font_impl::flushAll(mID, wind_width, wind_height);
+
+    present();
+    std::swap(mLastFrame, mNextFrame);
+    mDrawCalls.clear();
     CheckGL("End draw");
 }
 
@@ -248,33 +343,27 @@ void window_impl::grid(int pRows, int pCols)
 {
     mRows= pRows;
     mCols= pCols;
-
-    int wind_width, wind_height;
-    mWindow->getFrameBufferSize(&wind_width, &wind_height);
-    glViewport(0, 0, wind_width, wind_height);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    mCellWidth = wind_width / mCols;
-    mCellHeight = wind_height / mRows;
+    mDrawCalls.clear();
 }
 
-
 void window_impl::draw(int pColId, int pRowId,
                        const std::shared_ptr<AbstractRenderable>& pRenderable,
                        const char* pTitle)
 {
-    CheckGL("Begin draw(column, row)");
-    MakeContextCurrent(this);
+    /* cells are recorded here and rendered
+     * together by the next swapBuffers call */
     mWindow->resetCloseFlag();
 
-    int wind_width, wind_height;
-    mWindow->getFrameBufferSize(&wind_width, &wind_height);
-    mCellWidth = wind_width / mCols;
-    mCellHeight = wind_height / mRows;
+    DrawCall dc = {pRenderable, pColId, pRowId, pTitle!=NULL,
+                   std::string(pTitle!=NULL ? pTitle : ""), mColorMap, mColorMapLength};
+    mDrawCalls.push_back(dc);
+}
 
-    float pos[2] = {0.0, 0.0};
-    int c     = pColId;
-    int r     = pRowId;
+void window_impl::renderCell(const DrawCall& pCall)
+{
+    CheckGL("Begin renderCell");
+    int c     = pCall.mCol;
+    int r     = pCall.mRow;
     int x_off = c * mCellWidth;
     int y_off = (mRows - 1 - r) * mCellHeight;
 
@@ -289,30 +378,298 @@ void window_impl::draw(int pColId, int pRowId,
     glViewport(x_off + lef_margin, y_off + bot_margin, mCellWidth - 2 * rig_margin, mCellHeight - 2 * top_margin);
     glScissor(x_off + lef_margin, y_off + bot_margin, mCellWidth - 2 * rig_margin, mCellHeight - 2 * top_margin);
     glEnable(GL_SCISSOR_TEST);
-    glClearColor(GRAY[0], GRAY[1], GRAY[2], GRAY[3]);
 
-    pRenderable->setColorMapUBOParams(mColorMapUBO, mUBOSize);
-    pRenderable->render(mID, x_off, y_off, mCellWidth, mCellHeight);
+    /* text queued for this cell is clipped to it when the
+     * frame's text is flushed, so that labels don't spill
+     * into neighbouring cells */
+    font_impl::setClipRect(mID, x_off, y_off, mCellWidth, mCellHeight);
 
-    glDisable(GL_SCISSOR_TEST);
-    glViewport(x_off, y_off, mCellWidth, mCellHeight);
+    pCall.mRenderable->setColorMapParams(pCall.mColorMap, pCall.mColorMapLength);
+    pCall.mRenderable->render(mID, x_off, y_off, mCellWidth, mCellHeight);
 
-    if (pTitle!=NULL) {
-        mFont->setOthro2D(mCellWidth, mCellHeight);
-        pos[0] = mCellWidth / 3.0f;
-        pos[1] = mCellHeight*0.92f;
-        mFont->render(mID, pos, RED, pTitle, 16);
+    if (pCall.mHasTitle) {
+        float pos[2] = {x_off + mCellWidth / 3.0f, y_off + mCellHeight*0.92f};
+        glViewport(0, 0, mWidth, mHeight);
+        mFont->setOthro2D(mWidth, mHeight);
+        mFont->queue(mID, pos, RED, pCall.mTitle.c_str(), 16);
     }
 
-
-    CheckGL("End draw(column, row)");
+    glDisable(GL_SCISSOR_TEST);
+    CheckGL("End renderCell");
 }
 
 void window_impl::swapBuffers()
 {
-    mWindow->swapBuffers();
-    mWindow->pollEvents();
+    CheckGL("Begin swapBuffers");
+    MakeContextCurrent(this);
+    mWindow->resetCloseFlag();
+
+    int wind_width, wind_height;
+    mWindow->getFrameBufferSize(&wind_width, &wind_height);
+
+    bool isGrid = (mRows > 0 && mCols > 0);
+    if (isGrid && !frameChanged(wind_width, wind_height, mRows, mCols)) {
+        idle();
+        CheckGL("End swapBuffers");
+        return;
+    }
+
+    glViewport(0, 0, wind_width, wind_height);
+    glClearColor(GRAY[0], GRAY[1], GRAY[2], GRAY[3]);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if (isGrid) {
+        mCellWidth  = wind_width / mCols;
+        mCellHeight = wind_height / mRows;
+        for (size_t i=0; i<mDrawCalls.size(); ++i)
+            renderCell(mDrawCalls[i]);
+        font_impl::resetClipRect(mID);
+    }
+
+    /* text of all cells is drawn at once */
+    font_impl::flushAll(mID, wind_width, wind_height);
+
+    present();
+    if (isGrid)
+        std::swap(mLastFrame, mNextFrame);
+    else
+        mLastFrame = FrameState();
+    mDrawCalls.clear();
+    CheckGL("End swapBuffers");
+}
+
+void window_impl::queueCapture()
+{
+    if (mCapturePBOs.empty())
+        return;
+
+    CheckGL("Begin window_impl::queueCapture");
+    unsigned ringSize = (unsigned)mCapturePBOs.size();
+
+    if (mVideoSink) {
+        /* hand over completed frames; a sink gets every
+         * frame, so wait on the oldest one if ring is full */
+        flushToSink(false);
+        unsigned oldest;
+        if (mCaptureCount == ringSize && readyCapture(true, &oldest))
+            pushToSink(oldest);
+    }
+
+    unsigned slot = mCaptureHead;
+    /* ring is full, oldest frame was never fetched; drop it */
+    if (mCaptureCount == ringSize) {
+        glDeleteSync(mCaptureFences[slot]);
+        mCaptureFences[slot] = 0;
+        mCaptureCount--;
+    }
+
+    int w, h;
+    mWindow->getFrameBufferSize(&w, &h);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, mCapturePBOs[slot]);
+    if (w != mCaptureWidths[slot] || h != mCaptureHeights[slot]) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, w*h*4*sizeof(GLubyte), NULL, GL_STREAM_READ);
+        mCaptureWidths[slot]  = w;
+        mCaptureHeights[slot] = h;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    /* with a pack buffer bound, this only queues the transfer */
+    glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    mCaptureFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    mCaptureHead = (slot + 1) % ringSize;
+    mCaptureCount++;
+    CheckGL("End window_impl::queueCapture");
+}
+
+void window_impl::releaseCapture()
+{
+    for (size_t i=0; i<mCaptureFences.size(); ++i) {
+        if (mCaptureFences[i])
+            glDeleteSync(mCaptureFences[i]);
+    }
+    if (!mCapturePBOs.empty())
+        glDeleteBuffers((GLsizei)mCapturePBOs.size(), mCapturePBOs.data());
+
+    mCapturePBOs.clear();
+    mCaptureFences.clear();
+    mCaptureWidths.clear();
+    mCaptureHeights.clear();
+    mCaptureHead  = 0;
+    mCaptureCount = 0;
+}
+
+void window_impl::enableCapture(unsigned pRingSize)
+{
+    CheckGL("Begin window_impl::enableCapture");
+    /* a single buffer would have to be waited on
+     * in the same frame it got queued */
+    pRingSize = std::max(pRingSize, 2u);
+
+    if (pRingSize == mCapturePBOs.size())
+        return;
+
+    MakeContextCurrent(this);
+    releaseCapture();
+
+    mCapturePBOs.resize(pRingSize);
+    mCaptureFences.resize(pRingSize, 0);
+    mCaptureWidths.resize(pRingSize, 0);
+    mCaptureHeights.resize(pRingSize, 0);
+    glGenBuffers(pRingSize, mCapturePBOs.data());
+    CheckGL("End window_impl::enableCapture");
+}
+
+bool window_impl::readyCapture(bool pWait, unsigned* pSlot)
+{
+    if (mCaptureCount == 0)
+        return false;
+
+    unsigned ringSize = (unsigned)mCapturePBOs.size();
+    unsigned slot = (mCaptureHead + ringSize - mCaptureCount) % ringSize;
+
+    GLenum status;
+    if (pWait) {
+        do {
+            status = glClientWaitSync(mCaptureFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      GLuint64(1000000000));
+        } while (status == GL_TIMEOUT_EXPIRED);
+    } else {
+        /* poll the fence, never wait on it */
+        status = glClientWaitSync(mCaptureFences[slot], 0, 0);
+    }
+    if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED)
+        return false;
+
+    *pSlot = slot;
+    return true;
+}
+
+void window_impl::consumeCapture(unsigned pSlot)
+{
+    glDeleteSync(mCaptureFences[pSlot]);
+    mCaptureFences[pSlot] = 0;
+    mCaptureCount--;
+}
+
+void window_impl::pushToSink(unsigned pSlot)
+{
+    int w = mCaptureWidths[pSlot];
+    int h = mCaptureHeights[pSlot];
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, mCapturePBOs[pSlot]);
+    const GLubyte* src = (const GLubyte*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                          w*h*4*sizeof(GLubyte),
+                                                          GL_MAP_READ_BIT);
+    if (src) {
+        try {
+            mVideoSink->push(src, w, h);
+        } catch (...) {
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            consumeCapture(pSlot);
+            throw;
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    consumeCapture(pSlot);
+}
+
+void window_impl::flushToSink(bool pWait)
+{
+    /* with pWait, every frame in flight is waited for */
+    unsigned slot;
+    while (readyCapture(pWait, &slot))
+        pushToSink(slot);
+}
+
+bool window_impl::captureAsync(unsigned char* pData, int* pWidth, int* pHeight)
+{
+    if (mCapturePBOs.empty())
+        enableCapture(3);
+
+    if (mCaptureCount == 0 || mVideoSink)
+        return false;
+
+    CheckGL("Begin window_impl::captureAsync");
+    MakeContextCurrent(this);
+
+    unsigned slot;
+    if (!readyCapture(false, &slot))
+        return false;
+
+    int w = mCaptureWidths[slot];
+    int h = mCaptureHeights[slot];
+    *pWidth  = w;
+    *pHeight = h;
+
+    if (pData == NULL)
+        return true;
+
+    size_t rowSize = w*4*sizeof(GLubyte);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, mCapturePBOs[slot]);
+    const GLubyte* src = (const GLubyte*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                          rowSize*h, GL_MAP_READ_BIT);
+    if (src) {
+        /* OpenGL returns rows bottom to top */
+        for (int r=0; r<h; ++r)
+            memcpy(pData + r*rowSize, src + (h-1-r)*rowSize, rowSize);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    consumeCapture(slot);
+
+    CheckGL("End window_impl::captureAsync");
+    return src != NULL;
+}
+
+void window_impl::setVideoSink(int pFd, fg::VideoFormat pFormat, int pFrameRate)
+{
+    CheckGL("Begin window_impl::setVideoSink");
+    MakeContextCurrent(this);
+    if (mVideoSink) {
+        /* deliver frames that are still in flight to the old sink,
+         * its destructor waits until all of them are written */
+        flushToSink(true);
+        mVideoSink.reset();
+    }
+
+    if (pFd >= 0) {
+        if (mCapturePBOs.empty())
+            enableCapture(3);
+        mVideoSink.reset(new videosink_impl(pFd, pFormat, pFrameRate));
+    }
+    CheckGL("End window_impl::setVideoSink");
+}
+
+void window_impl::enableUploadThread(unsigned pQueueLength)
+{
+    if (mUploader)
+        return;
+
+    mUploader.reset(new uploader_impl(mWindow, mGLEWContext, pQueueLength));
+    /* creating the upload context may have changed the current one */
+    MakeContextCurrent(this);
+}
+
+bool window_impl::uploadAsync(const std::shared_ptr<AbstractChart>& pChart, const void* pData)
+{
+    if (!mUploader)
+        throw fg::Error("window_impl::uploadAsync", __LINE__,
+                "Upload thread is not enabled", fg::FG_ERR_RUNTIME);
+
+    /* the chart may be resized on the render thread meanwhile */
+    const std::shared_ptr<AsyncUpload>& target = pChart->asyncUpload();
+    return mUploader->push(target, pData, target->dataSize());
+}
+
+unsigned window_impl::pendingUploads() const
+{
+    return (mUploader ? mUploader->pending() : 0);
 }
 
 }
@@ -364,6 +721,16 @@ void Window::setColorMap(ColorMap cmap)
     value->setColorMap(cmap);
 }
 
+void Window::setColorMap(unsigned pMap)
+{
+    value->setColorMap(pMap);
+}
+
+unsigned Window::addColorMap(const float* pRGBA, unsigned pLength)
+{
+    return value->addColorMap(pRGBA, pLength);
+}
+
 long long Window::context() const
 {
     return value->context();
@@ -414,11 +781,21 @@ void Window::draw(const Image& pImage, const bool pKeepAspectRatio)
     value->draw(pImage.get(), pKeepAspectRatio);
 }
 
+void Window::draw(const TiledImage& pImage, const bool pKeepAspectRatio)
+{
+    value->draw(pImage.get(), pKeepAspectRatio);
+}
+
 void Window::draw(const Plot& pPlot)
 {
     value->draw(pPlot.get());
 }
 
+void Window::draw(const StreamPlot& pPlot)
+{
+    value->draw(pPlot.get());
+}
+
 void Window::draw(const Plot3& pPlot3)
 {
     value->draw(pPlot3.get());
@@ -444,11 +821,21 @@ void Window::draw(int pColId, int pRowId, const Image& pImage, const char* pTitl
     value->draw(pColId, pRowId, pImage.get(), pTitle, pKeepAspectRatio);
 }
 
+void Window::draw(int pColId, int pRowId, const TiledImage& pImage, const char* pTitle, const bool pKeepAspectRatio)
+{
+    value->draw(pColId, pRowId, pImage.get(), pTitle, pKeepAspectRatio);
+}
+
 void Window::draw(int pColId, int pRowId, const Plot& pPlot, const char* pTitle)
 {
     value->draw(pColId, pRowId, pPlot.get(), pTitle);
 }
 
+void Window::draw(int pColId, int pRowId, const StreamPlot& pPlot, const char* pTitle)
+{
+    value->draw(pColId, pRowId, pPlot.get(), pTitle);
+}
+
 void Window::draw(int pColId, int pRowId, const Plot3& pPlot3, const char* pTitle)
 {
     value->draw(pColId, pRowId, pPlot3.get(), pTitle);
@@ -470,4 +857,49 @@ void Window::swapBuffers()
     value->swapBuffers();
 }
 
+void Window::enableCapture(unsigned pRingSize)
+{
+    value->enableCapture(pRingSize);
+}
+
+bool Window::captureAsync(unsigned char* pData, int* pWidth, int* pHeight)
+{
+    return value->captureAsync(pData, pWidth, pHeight);
+}
+
+void Window::setVideoSink(int pFd, VideoFormat pFormat, int pFrameRate)
+{
+    value->setVideoSink(pFd, pFormat, pFrameRate);
+}
+
+void Window::enableUploadThread(unsigned pQueueLength)
+{
+    value->enableUploadThread(pQueueLength);
+}
+
+bool Window::uploadAsync(const Plot& pPlot, const void* pData)
+{
+    return value->uploadAsync(pPlot.get(), pData);
+}
+
+bool Window::uploadAsync(const Plot3& pPlot3, const void* pData)
+{
+    return value->uploadAsync(pPlot3.get(), pData);
+}
+
+bool Window::uploadAsync(const Surface& pSurface, const void* pData)
+{
+    return value->uploadAsync(pSurface.get(), pData);
+}
+
+bool Window::uploadAsync(const Histogram& pHist, const void* pData)
+{
+    return value->uploadAsync(pHist.get(), pData);
+}
+
+unsigned Window::pendingUploads() const
+{
+    return value->pendingUploads();
+}
+
 }
@@ -15,21 +15,64 @@
 #include <glfw/window.hpp>
 #elif defined(USE_SDL)
 #include <sdl/window.hpp>
+#elif defined(USE_EGL)
+#include <egl/window.hpp>
 #endif
 
 #include <colormap.hpp>
 #include <font.hpp>
 #include <image.hpp>
+#include <tiledimage.hpp>
 #include <plot.hpp>
+#include <streamplot.hpp>
 #include <plot3.hpp>
 #include <surface.hpp>
 #include <histogram.hpp>
+#include <uploader.hpp>
+#include <videosink.hpp>
 
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace internal
 {
 
+/* a draw request, for a grid cell or the whole window */
+struct DrawCall {
+    std::shared_ptr<AbstractRenderable> mRenderable;
+    int         mCol;
+    int         mRow;
+    bool        mHasTitle;
+    std::string mTitle;
+    GLuint      mColorMap;
+    GLuint      mColorMapLength;
+};
+
+/* everything that determines the contents of a single object or grid
+ * frame, a window skips rendering when the next frame matches the last */
+struct FrameState {
+    struct Item {
+        const AbstractRenderable* mRenderable;
+        unsigned long long        mRevision;
+        int         mCol;
+        int         mRow;
+        bool        mHasTitle;
+        std::string mTitle;
+        GLuint      mColorMap;
+    };
+
+    int               mWidth;
+    int               mHeight;
+    int               mRows;
+    int               mCols;
+    const font_impl*  mFont;
+    std::vector<Item> mItems;
+
+    FrameState() : mWidth(-1), mHeight(-1), mRows(0), mCols(0), mFont(nullptr) {}
+};
+
 class window_impl {
     private:
         long long     mCxt;
@@ -47,8 +90,45 @@ class window_impl {
         std::shared_ptr<font_impl>     mFont;
         std::shared_ptr<colormap_impl> mCMap;
 
-        GLuint        mColorMapUBO;
-        GLuint        mUBOSize;
+        GLuint        mColorMap;
+        GLuint        mColorMapLength;
+
+        /* frame capture ring: each swap reads the framebuffer into
+         * the pixel pack buffer at mCaptureHead, mCaptureCount of the
+         * most recent frames are pending retrieval */
+        std::vector<GLuint> mCapturePBOs;
+        std::vector<GLsync> mCaptureFences;
+        std::vector<int>    mCaptureWidths;
+        std::vector<int>    mCaptureHeights;
+        unsigned            mCaptureHead;
+        unsigned            mCaptureCount;
+
+        /* when attached, all captured frames are handed to this sink */
+        std::unique_ptr<videosink_impl> mVideoSink;
+
+        /* background uploads, see enableUploadThread */
+        std::unique_ptr<uploader_impl> mUploader;
+
+        /* grid cells recorded since the last swapBuffers, they are
+         * rendered in submission order by it. mLastFrame holds the
+         * contents of the last frame that was presented */
+        std::vector<DrawCall> mDrawCalls;
+        FrameState            mLastFrame;
+        FrameState            mNextFrame;
+        /* an idle window waits for events until this time */
+        std::chrono::steady_clock::time_point mNextFrameTime;
+
+        bool frameChanged(int pWidth, int pHeight, int pRows, int pCols);
+        void renderCell(const DrawCall& pCall);
+        void present();
+        void idle();
+
+        void queueCapture();
+        void releaseCapture();
+        bool readyCapture(bool pWait, unsigned* pSlot);
+        void consumeCapture(unsigned pSlot);
+        void pushToSink(unsigned pSlot);
+        void flushToSink(bool pWait);
 
     public:
         window_impl(int pWidth, int pHeight, const char* pTitle,
@@ -60,10 +140,13 @@ class window_impl {
         void setTitle(const char* pTitle);
         void setPos(int pX, int pY);
         void setSize(unsigned pWidth, unsigned pHeight);
-        void setColorMap(fg::ColorMap cmap);
+        /* fg::ColorMap values or identifiers returned by addColorMap */
+        void setColorMap(unsigned pMap);
+        unsigned addColorMap(const float* pRGBA, unsigned pLength);
 
         long long context() const;
         long long display() const;
+        int id() const;
         int width() const;
         int height() const;
         GLEWContext* glewContext() const;
@@ -83,10 +166,22 @@ class window_impl {
                   const char* pTitle);
 
         void swapBuffers();
+
+        void enableCapture(unsigned pRingSize);
+        bool captureAsync(unsigned char* pData, int* pWidth, int* pHeight);
+        void setVideoSink(int pFd, fg::VideoFormat pFormat, int pFrameRate);
+
+        void enableUploadThread(unsigned pQueueLength);
+        /* may be called from any thread */
+        bool uploadAsync(const std::shared_ptr<AbstractChart>& pChart, const void* pData);
+        unsigned pendingUploads() const;
 };
 
 void MakeContextCurrent(const window_impl* pWindow);
 
+/* for contexts that don't belong to a window, like the upload thread's */
+void MakeContextCurrent(const wtk::Widget* pWidget, GLEWContext* pGLEWContext);
+
 class _Window {
     private:
         std::shared_ptr<window_impl> wnd;
@@ -127,8 +222,12 @@ class _Window {
             wnd->setSize(pWidth, pHeight);
         }
 
-        inline void setColorMap(fg::ColorMap cmap) {
-            wnd->setColorMap(cmap);
+        inline void setColorMap(unsigned pMap) {
+            wnd->setColorMap(pMap);
+        }
+
+        inline unsigned addColorMap(const float* pRGBA, unsigned pLength) {
+            return wnd->addColorMap(pRGBA, pLength);
         }
 
         inline long long context() const {
@@ -168,10 +267,19 @@ class _Window {
             wnd->draw(pImage->impl()) ;
         }
 
+        inline void draw(_TiledImage* pImage, const bool pKeepAspectRatio) {
+            pImage->keepAspectRatio(pKeepAspectRatio);
+            wnd->draw(pImage->impl()) ;
+        }
+
         inline void draw(const _Plot* pPlot) {
             wnd->draw(pPlot->impl()) ;
         }
 
+        inline void draw(const _StreamPlot* pPlot) {
+            wnd->draw(pPlot->impl()) ;
+        }
+
         inline void draw(const _Plot3* pPlot3) {
             wnd->draw(pPlot3->impl()) ;
         }
@@ -192,6 +300,31 @@ class _Window {
             wnd->grid(pRows, pCols);
         }
 
+        inline void enableCapture(unsigned pRingSize) {
+            wnd->enableCapture(pRingSize);
+        }
+
+        inline bool captureAsync(unsigned char* pData, int* pWidth, int* pHeight) {
+            return wnd->captureAsync(pData, pWidth, pHeight);
+        }
+
+        inline void setVideoSink(int pFd, fg::VideoFormat pFormat, int pFrameRate) {
+            wnd->setVideoSink(pFd, pFormat, pFrameRate);
+        }
+
+        inline void enableUploadThread(unsigned pQueueLength) {
+            wnd->enableUploadThread(pQueueLength);
+        }
+
+        template<typename T>
+        bool uploadAsync(const T* pRenderable, const void* pData) {
+            return wnd->uploadAsync(pRenderable->impl(), pData);
+        }
+
+        inline unsigned pendingUploads() const {
+            return wnd->pendingUploads();
+        }
+
         template<typename T>
         void draw(int pColId, int pRowId, T* pRenderable, const char* pTitle) {
             wnd->draw(pColId, pRowId, pRenderable->impl(), pTitle);
@@ -201,6 +334,11 @@ class _Window {
             pRenderable->keepAspectRatio(pKeepAspectRatio);
             wnd->draw(pColId, pRowId, pRenderable->impl(), pTitle);
         }
+
+        void draw(int pColId, int pRowId, _TiledImage* pRenderable, const char* pTitle, const bool pKeepAspectRatio) {
+            pRenderable->keepAspectRatio(pKeepAspectRatio);
+            wnd->draw(pColId, pRowId, pRenderable->impl(), pTitle);
+        }
 };
 
 }